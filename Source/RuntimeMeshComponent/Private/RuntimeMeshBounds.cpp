@@ -0,0 +1,164 @@
+// Copyright 2016 Chris Conway (Koderz). All Rights Reserved.
+
+#include "RuntimeMeshComponentPluginPrivatePCH.h"
+#include "RuntimeMeshBounds.h"
+
+
+FBox FRuntimeMeshBounds::CalculateStrided(const FVector* FirstPosition, int32 Count, int32 Stride)
+{
+	if (Count <= 0)
+	{
+		return FBox(0);
+	}
+
+	const uint8* Position = reinterpret_cast<const uint8*>(FirstPosition);
+	const uint8* LastPosition = Position + (SIZE_T)(Count - 1) * Stride;
+
+	// Two sets of accumulators so consecutive min/max don't wait on each other
+	VectorRegister Min0 = VectorLoadFloat3(LastPosition);
+	VectorRegister Max0 = Min0;
+	VectorRegister Min1 = Min0;
+	VectorRegister Max1 = Min0;
+
+	// Full 16 byte loads read one float past each position, so only the last position needs loading on its own.
+	// The extra float only ends up in W, which is never stored.
+	const uint8* UnrolledEnd = Position + (SIZE_T)((Count - 1) & ~3) * Stride;
+	while (Position < UnrolledEnd)
+	{
+		const VectorRegister A = VectorLoad(reinterpret_cast<const float*>(Position));
+		const VectorRegister B = VectorLoad(reinterpret_cast<const float*>(Position + Stride));
+		const VectorRegister C = VectorLoad(reinterpret_cast<const float*>(Position + Stride * 2));
+		const VectorRegister D = VectorLoad(reinterpret_cast<const float*>(Position + Stride * 3));
+
+		Min0 = VectorMin(Min0, A);
+		Max0 = VectorMax(Max0, A);
+		Min1 = VectorMin(Min1, B);
+		Max1 = VectorMax(Max1, B);
+		Min0 = VectorMin(Min0, C);
+		Max0 = VectorMax(Max0, C);
+		Min1 = VectorMin(Min1, D);
+		Max1 = VectorMax(Max1, D);
+
+		Position += Stride * 4;
+	}
+
+	while (Position < LastPosition)
+	{
+		const VectorRegister A = VectorLoad(reinterpret_cast<const float*>(Position));
+		Min0 = VectorMin(Min0, A);
+		Max0 = VectorMax(Max0, A);
+
+		Position += Stride;
+	}
+
+	FVector Min, Max;
+	VectorStoreFloat3(VectorMin(Min0, Min1), &Min);
+	VectorStoreFloat3(VectorMax(Max0, Max1), &Max);
+	return FBox(Min, Max);
+}
+
+FBox FRuntimeMeshBounds::CopyAndCalculate(FVector* Dest, const FVector* Source, int32 Count)
+{
+	const int32 BlockSize = CopyBlockBytes / sizeof(FVector);
+
+	FBox Bounds(0);
+	for (int32 First = 0; First < Count; First += BlockSize)
+	{
+		const int32 NumInBlock = FMath::Min(BlockSize, Count - First);
+		FMemory::Memcpy(Dest + First, Source + First, NumInBlock * sizeof(FVector));
+		Bounds += Calculate(Dest + First, NumInBlock);
+	}
+	return Bounds;
+}
+
+
+
+/* Roughly the layout of the generic vertex, to time the strided loads against */
+struct FRuntimeMeshBoundsBenchmarkVertex
+{
+	FVector Position;
+	FPackedNormal Normal;
+	FPackedNormal Tangent;
+	FColor Color;
+	FVector2D UV0;
+};
+
+template<typename VertexType>
+static FVector& GetBenchmarkPosition(VertexType& Vertex) { return Vertex.Position; }
+static FVector& GetBenchmarkPosition(FVector& Vertex) { return Vertex; }
+
+template<typename VertexType>
+static void RunBoundsBenchmark(const TCHAR* Name, int32 NumVertices)
+{
+	const int32 NumIterations = FMath::Max(10000000 / NumVertices, 1);
+
+	FRandomStream Random(NumVertices);
+	TArray<VertexType> Source;
+	Source.SetNumZeroed(NumVertices);
+	for (VertexType& Vertex : Source)
+	{
+		GetBenchmarkPosition(Vertex) = Random.GetUnitVector() * Random.FRandRange(0.0f, 10000.0f);
+	}
+	TArray<VertexType> Dest;
+	Dest.SetNumZeroed(NumVertices);
+
+	double StartTime = FPlatformTime::Seconds();
+	FBox ScalarBounds(0);
+	for (int32 Iteration = 0; Iteration < NumIterations; Iteration++)
+	{
+		ScalarBounds.Init();
+		for (int32 Index = 0; Index < NumVertices; Index++)
+		{
+			ScalarBounds += GetBenchmarkPosition(Source[Index]);
+		}
+	}
+	const double ScalarTime = (FPlatformTime::Seconds() - StartTime) / NumIterations;
+
+	StartTime = FPlatformTime::Seconds();
+	FBox VectorBounds(0);
+	for (int32 Iteration = 0; Iteration < NumIterations; Iteration++)
+	{
+		VectorBounds = FRuntimeMeshBounds::Calculate(Source.GetData(), NumVertices);
+	}
+	const double VectorTime = (FPlatformTime::Seconds() - StartTime) / NumIterations;
+
+	StartTime = FPlatformTime::Seconds();
+	for (int32 Iteration = 0; Iteration < NumIterations; Iteration++)
+	{
+		ScalarBounds.Init();
+		for (int32 Index = 0; Index < NumVertices; Index++)
+		{
+			ScalarBounds += GetBenchmarkPosition(Source[Index]);
+			Dest[Index] = Source[Index];
+		}
+	}
+	const double ScalarCopyTime = (FPlatformTime::Seconds() - StartTime) / NumIterations;
+
+	StartTime = FPlatformTime::Seconds();
+	for (int32 Iteration = 0; Iteration < NumIterations; Iteration++)
+	{
+		VectorBounds = FRuntimeMeshBounds::CopyAndCalculate(Dest.GetData(), Source.GetData(), NumVertices);
+	}
+	const double VectorCopyTime = (FPlatformTime::Seconds() - StartTime) / NumIterations;
+
+	UE_LOG(RuntimeMeshLog, Log, TEXT("%s x %d: bounds %.3f ms -> %.3f ms (%.1fx), copy + bounds %.3f ms -> %.3f ms (%.1fx)%s"),
+		Name, NumVertices,
+		ScalarTime * 1000.0, VectorTime * 1000.0, ScalarTime / FMath::Max(VectorTime, 1e-9),
+		ScalarCopyTime * 1000.0, VectorCopyTime * 1000.0, ScalarCopyTime / FMath::Max(VectorCopyTime, 1e-9),
+		(ScalarBounds == VectorBounds) ? TEXT("") : TEXT(" MISMATCH"));
+}
+
+void FRuntimeMeshBounds::RunBenchmark()
+{
+	const int32 VertexCounts[] = { 10000, 100000, 1000000 };
+	for (int32 NumVertices : VertexCounts)
+	{
+		RunBoundsBenchmark<FVector>(TEXT("FVector"), NumVertices);
+		RunBoundsBenchmark<FRuntimeMeshBoundsBenchmarkVertex>(TEXT("Vertex"), NumVertices);
+	}
+}
+
+static FAutoConsoleCommand GRuntimeMeshBoundsBenchmarkCommand(
+	TEXT("RuntimeMesh.BenchmarkBounds"),
+	TEXT("Times the vectorized bounding box kernels against plain FBox loops for 10k to 1M vertices."),
+	FConsoleCommandDelegate::CreateStatic(&FRuntimeMeshBounds::RunBenchmark));
@@ -0,0 +1,646 @@
+// Copyright 2016 Chris Conway (Koderz). All Rights Reserved.
+
+#include "RuntimeMeshComponentPluginPrivatePCH.h"
+#include "RuntimeMeshBufferPool.h"
+
+
+void FRuntimeMeshFreeList::Reset(int32 InCapacity)
+{
+	Capacity = InCapacity;
+	FreeSpans.Reset();
+	if (Capacity > 0)
+	{
+		FreeSpans.Add(FRuntimeMeshBufferSpan(0, Capacity));
+	}
+}
+
+bool FRuntimeMeshFreeList::Allocate(int32 Count, int32& OutStart)
+{
+	if (Count <= 0)
+	{
+		OutStart = 0;
+		return true;
+	}
+
+	for (int32 Index = 0; Index < FreeSpans.Num(); Index++)
+	{
+		FRuntimeMeshBufferSpan& Span = FreeSpans[Index];
+		if (Span.Count >= Count)
+		{
+			OutStart = Span.Start;
+
+			Span.Start += Count;
+			Span.Count -= Count;
+			if (Span.Count == 0)
+			{
+				FreeSpans.RemoveAt(Index, 1, false);
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FRuntimeMeshFreeList::AllocateAt(int32 Start, int32 Count)
+{
+	if (Count <= 0)
+	{
+		return true;
+	}
+
+	for (int32 Index = 0; Index < FreeSpans.Num(); Index++)
+	{
+		FRuntimeMeshBufferSpan& Span = FreeSpans[Index];
+		if (Span.Start > Start)
+		{
+			break;
+		}
+
+		if (Span.End() >= Start + Count)
+		{
+			// Split the free range around the claimed one
+			FRuntimeMeshBufferSpan After(Start + Count, Span.End() - (Start + Count));
+			Span.Count = Start - Span.Start;
+
+			if (Span.Count == 0)
+			{
+				FreeSpans.RemoveAt(Index, 1, false);
+				Index--;
+			}
+			if (After.Count > 0)
+			{
+				FreeSpans.Insert(After, Index + 1);
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+void FRuntimeMeshFreeList::Free(int32 Start, int32 Count)
+{
+	if (Count <= 0)
+	{
+		return;
+	}
+
+	// Find where the range goes
+	int32 InsertIndex = 0;
+	while (InsertIndex < FreeSpans.Num() && FreeSpans[InsertIndex].Start < Start)
+	{
+		InsertIndex++;
+	}
+
+	check(InsertIndex == 0 || FreeSpans[InsertIndex - 1].End() <= Start);
+	check(InsertIndex == FreeSpans.Num() || Start + Count <= FreeSpans[InsertIndex].Start);
+
+	// Merge with the range before and after if they touch
+	bool bMergesBefore = InsertIndex > 0 && FreeSpans[InsertIndex - 1].End() == Start;
+	bool bMergesAfter = InsertIndex < FreeSpans.Num() && FreeSpans[InsertIndex].Start == Start + Count;
+
+	if (bMergesBefore && bMergesAfter)
+	{
+		FreeSpans[InsertIndex - 1].Count += Count + FreeSpans[InsertIndex].Count;
+		FreeSpans.RemoveAt(InsertIndex, 1, false);
+	}
+	else if (bMergesBefore)
+	{
+		FreeSpans[InsertIndex - 1].Count += Count;
+	}
+	else if (bMergesAfter)
+	{
+		FreeSpans[InsertIndex].Start = Start;
+		FreeSpans[InsertIndex].Count += Count;
+	}
+	else
+	{
+		FreeSpans.Insert(FRuntimeMeshBufferSpan(Start, Count), InsertIndex);
+	}
+}
+
+int32 FRuntimeMeshFreeList::GetTotalFree() const
+{
+	int32 Total = 0;
+	for (const FRuntimeMeshBufferSpan& Span : FreeSpans)
+	{
+		Total += Span.Count;
+	}
+	return Total;
+}
+
+int32 FRuntimeMeshFreeList::GetLargestFree() const
+{
+	int32 Largest = 0;
+	for (const FRuntimeMeshBufferSpan& Span : FreeSpans)
+	{
+		Largest = FMath::Max(Largest, Span.Count);
+	}
+	return Largest;
+}
+
+
+
+FRuntimeMeshBufferPoolPage::FRuntimeMeshBufferPoolPage(int32 InVertexStride, bool bInIsPinned, int32 InVertexCapacity, int32 InIndexCapacity)
+	: bIsVertexDataDirty(false), bIsIndexDataDirty(false), VertexStride(InVertexStride), bIsPinned(bInIsPinned)
+{
+	check(IsInRenderingThread());
+
+	VertexFreeList.Reset(InVertexCapacity);
+	IndexFreeList.Reset(InIndexCapacity);
+
+	VertexData.SetNumZeroed(InVertexCapacity * VertexStride);
+	IndexData.SetNumZeroed(InIndexCapacity);
+
+	InitRHI();
+}
+
+FRuntimeMeshBufferPoolPage::~FRuntimeMeshBufferPoolPage()
+{
+	check(Allocations.Num() == 0);
+	ReleaseRHI();
+}
+
+void FRuntimeMeshBufferPoolPage::InitRHI()
+{
+	FRHIResourceCreateInfo CreateInfo;
+	VertexBuffer.VertexBufferRHI = RHICreateVertexBuffer(VertexData.Num(), BUF_Static, CreateInfo);
+	IndexBuffer.IndexBufferRHI = RHICreateIndexBuffer(sizeof(uint32), IndexData.Num() * sizeof(uint32), BUF_Static, CreateInfo);
+
+	// New buffers have no contents, so write everything
+	bIsVertexDataDirty = true;
+	bIsIndexDataDirty = true;
+	Flush();
+}
+
+void FRuntimeMeshBufferPoolPage::ReleaseRHI()
+{
+	VertexBuffer.VertexBufferRHI.SafeRelease();
+	IndexBuffer.IndexBufferRHI.SafeRelease();
+}
+
+void FRuntimeMeshBufferPoolPage::Flush()
+{
+	if (bIsVertexDataDirty && VertexBuffer.VertexBufferRHI.IsValid())
+	{
+		void* Buffer = RHILockVertexBuffer(VertexBuffer.VertexBufferRHI, 0, VertexData.Num(), RLM_WriteOnly);
+		FMemory::Memcpy(Buffer, VertexData.GetData(), VertexData.Num());
+		RHIUnlockVertexBuffer(VertexBuffer.VertexBufferRHI);
+
+		INC_DWORD_STAT_BY(STAT_RuntimeMesh_PoolBytesUploaded, VertexData.Num());
+		bIsVertexDataDirty = false;
+	}
+
+	if (bIsIndexDataDirty && IndexBuffer.IndexBufferRHI.IsValid())
+	{
+		void* Buffer = RHILockIndexBuffer(IndexBuffer.IndexBufferRHI, 0, IndexData.Num() * sizeof(uint32), RLM_WriteOnly);
+		FMemory::Memcpy(Buffer, IndexData.GetData(), IndexData.Num() * sizeof(uint32));
+		RHIUnlockIndexBuffer(IndexBuffer.IndexBufferRHI);
+
+		INC_DWORD_STAT_BY(STAT_RuntimeMesh_PoolBytesUploaded, IndexData.Num() * sizeof(uint32));
+		bIsIndexDataDirty = false;
+	}
+}
+
+
+
+FRuntimeMeshBufferPool& FRuntimeMeshBufferPool::Get()
+{
+	check(IsInRenderingThread());
+
+	static TGlobalResource<FRuntimeMeshBufferPool> Pool;
+	return Pool;
+}
+
+FRuntimeMeshBufferPool::~FRuntimeMeshBufferPool()
+{
+	for (FRuntimeMeshBufferPoolPage* Page : Pages)
+	{
+		for (FRuntimeMeshPoolAllocation* Allocation : Page->Allocations)
+		{
+			delete Allocation;
+		}
+		Page->Allocations.Empty();
+		delete Page;
+	}
+	Pages.Empty();
+}
+
+FRuntimeMeshPoolAllocation* FRuntimeMeshBufferPool::Allocate(int32 VertexStride, int32 NumVertices, int32 NumIndices, bool bIsPinned)
+{
+	check(IsInRenderingThread());
+
+	FRuntimeMeshPoolAllocation* Allocation = new FRuntimeMeshPoolAllocation();
+	Allocation->bIsPinned = bIsPinned;
+	AllocateInPage(Allocation, VertexStride, NumVertices, NumIndices);
+
+	UpdateStats();
+	return Allocation;
+}
+
+void FRuntimeMeshBufferPool::Free(FRuntimeMeshPoolAllocation* Allocation)
+{
+	check(IsInRenderingThread());
+
+	FreeFromPage(Allocation);
+	delete Allocation;
+
+	// Empty pages are kept to be reused, Defragment() releases them
+	UpdateStats();
+}
+
+bool FRuntimeMeshBufferPool::Resize(FRuntimeMeshPoolAllocation* Allocation, int32 NumVertices, int32 NumIndices)
+{
+	check(IsInRenderingThread());
+
+	FRuntimeMeshBufferPoolPage* Page = Allocation->Page;
+	FRuntimeMeshBufferSpan OldVertices = Allocation->Vertices;
+	FRuntimeMeshBufferSpan OldIndices = Allocation->Indices;
+
+	// Try to stay in the same page
+	if (ResizeSpan(Page->VertexFreeList, Allocation->Vertices, NumVertices))
+	{
+		if (ResizeSpan(Page->IndexFreeList, Allocation->Indices, NumIndices))
+		{
+			UpdateStats();
+			return false;
+		}
+
+		// Put the vertices back where they were so the whole allocation can move
+		Page->VertexFreeList.Free(Allocation->Vertices.Start, Allocation->Vertices.Count);
+		verify(Page->VertexFreeList.AllocateAt(OldVertices.Start, OldVertices.Count));
+		Allocation->Vertices = OldVertices;
+	}
+	check(Allocation->Indices.Start == OldIndices.Start && Allocation->Indices.Count == OldIndices.Count);
+
+	// Move to another page
+	int32 VertexStride = Page->VertexStride;
+	FreeFromPage(Allocation);
+	AllocateInPage(Allocation, VertexStride, NumVertices, NumIndices);
+
+	UpdateStats();
+	return Allocation->Page != Page;
+}
+
+void FRuntimeMeshBufferPool::WriteVertices(FRuntimeMeshPoolAllocation* Allocation, const void* Vertices, int32 FirstVertex, int32 NumVertices)
+{
+	check(IsInRenderingThread());
+	check(FirstVertex >= 0 && FirstVertex + NumVertices <= Allocation->Vertices.Count);
+
+	if (NumVertices == 0)
+	{
+		return;
+	}
+
+	FRuntimeMeshBufferPoolPage* Page = Allocation->Page;
+	int32 Stride = Page->VertexStride;
+
+	FMemory::Memcpy(Page->VertexData.GetData() + (Allocation->Vertices.Start + FirstVertex) * Stride, Vertices, NumVertices * Stride);
+	Page->bIsVertexDataDirty = true;
+}
+
+void FRuntimeMeshBufferPool::WriteIndices(FRuntimeMeshPoolAllocation* Allocation, const FRuntimeMeshIndexData& Indices, int32 SourceIndex, int32 FirstIndex, int32 NumIndices)
+{
+	check(IsInRenderingThread());
+	check(SourceIndex >= 0 && SourceIndex + NumIndices <= Indices.Num());
+	check(FirstIndex >= 0 && FirstIndex + NumIndices <= Allocation->Indices.Count);
+
+	if (NumIndices == 0)
+	{
+		return;
+	}
+
+	FRuntimeMeshBufferPoolPage* Page = Allocation->Page;
+	uint32 BaseVertexIndex = Allocation->Vertices.Start;
+
+	uint32* Buffer = Page->IndexData.GetData() + Allocation->Indices.Start + FirstIndex;
+
+	// Offset the indices to where the vertices are in the page
+	if (Indices.b32BitIndices)
+	{
+		const int32* Source = Indices.Indices32.GetData() + SourceIndex;
+		for (int32 Index = 0; Index < NumIndices; Index++)
+		{
+			Buffer[Index] = BaseVertexIndex + Source[Index];
+		}
+	}
+	else
+	{
+		const uint16* Source = Indices.Indices16.GetData() + SourceIndex;
+		for (int32 Index = 0; Index < NumIndices; Index++)
+		{
+			Buffer[Index] = BaseVertexIndex + Source[Index];
+		}
+	}
+
+	Page->bIsIndexDataDirty = true;
+}
+
+void FRuntimeMeshBufferPool::Flush()
+{
+	check(IsInRenderingThread());
+
+	for (FRuntimeMeshBufferPoolPage* Page : Pages)
+	{
+		Page->Flush();
+	}
+}
+
+void FRuntimeMeshBufferPool::Defragment()
+{
+	check(IsInRenderingThread());
+
+	for (int32 PageIndex = Pages.Num() - 1; PageIndex >= 0; PageIndex--)
+	{
+		FRuntimeMeshBufferPoolPage* Page = Pages[PageIndex];
+		if (Page->Allocations.Num() == 0)
+		{
+			delete Page;
+			Pages.RemoveAtSwap(PageIndex);
+		}
+		else if (!Page->bIsPinned)
+		{
+			DefragmentPage(Page);
+		}
+	}
+
+	UpdateStats();
+}
+
+FRuntimeMeshBufferPoolStats FRuntimeMeshBufferPool::GetStats() const
+{
+	FRuntimeMeshBufferPoolStats Stats;
+	Stats.NumPages = Pages.Num();
+
+	for (const FRuntimeMeshBufferPoolPage* Page : Pages)
+	{
+		int32 Stride = Page->VertexStride;
+		int32 IndexStride = sizeof(uint32);
+
+		Stats.NumAllocations += Page->Allocations.Num();
+		Stats.AllocatedBytes += (int64)Page->VertexFreeList.GetCapacity() * Stride + (int64)Page->IndexFreeList.GetCapacity() * IndexStride;
+		Stats.FreeBytes += (int64)Page->VertexFreeList.GetTotalFree() * Stride + (int64)Page->IndexFreeList.GetTotalFree() * IndexStride;
+		Stats.LargestFreeBytes += (int64)Page->VertexFreeList.GetLargestFree() * Stride + (int64)Page->IndexFreeList.GetLargestFree() * IndexStride;
+	}
+
+	Stats.UsedBytes = Stats.AllocatedBytes - Stats.FreeBytes;
+	return Stats;
+}
+
+void FRuntimeMeshBufferPool::LogStats() const
+{
+	FRuntimeMeshBufferPoolStats Stats = GetStats();
+
+	UE_LOG(RuntimeMeshLog, Log, TEXT("RuntimeMesh buffer pool: %d pages, %d allocations, %lld KB allocated, %lld KB used (%.1f%% occupancy, %.1f%% fragmentation)"),
+		Stats.NumPages, Stats.NumAllocations, Stats.AllocatedBytes / 1024, Stats.UsedBytes / 1024, Stats.GetOccupancy() * 100.0f, Stats.GetFragmentation() * 100.0f);
+
+	for (const FRuntimeMeshBufferPoolPage* Page : Pages)
+	{
+		UE_LOG(RuntimeMeshLog, Log, TEXT("    Page: Stride %d%s, %d allocations, vertices %d/%d free in %d ranges, indices %d/%d free in %d ranges"),
+			Page->VertexStride, Page->bIsPinned ? TEXT(" (Pinned)") : TEXT(""), Page->Allocations.Num(),
+			Page->VertexFreeList.GetTotalFree(), Page->VertexFreeList.GetCapacity(), Page->VertexFreeList.GetNumFreeRanges(),
+			Page->IndexFreeList.GetTotalFree(), Page->IndexFreeList.GetCapacity(), Page->IndexFreeList.GetNumFreeRanges());
+	}
+}
+
+void FRuntimeMeshBufferPool::InitRHI()
+{
+	// Recreates the pages released by ReleaseRHI(), like on a feature level change, from their copies
+	for (FRuntimeMeshBufferPoolPage* Page : Pages)
+	{
+		Page->InitRHI();
+	}
+}
+
+void FRuntimeMeshBufferPool::ReleaseRHI()
+{
+	for (FRuntimeMeshBufferPoolPage* Page : Pages)
+	{
+		Page->ReleaseRHI();
+	}
+}
+
+void FRuntimeMeshBufferPool::AllocateInPage(FRuntimeMeshPoolAllocation* Allocation, int32 VertexStride, int32 NumVertices, int32 NumIndices)
+{
+	for (FRuntimeMeshBufferPoolPage* Page : Pages)
+	{
+		if (Page->VertexStride == VertexStride && Page->bIsPinned == Allocation->bIsPinned && TryAllocateInPage(Page, Allocation, NumVertices, NumIndices))
+		{
+			return;
+		}
+	}
+
+	// Nothing had room, so start a new page
+	int32 VertexCapacity = FMath::Max(DefaultPageVertexBytes / VertexStride, NumVertices);
+	int32 IndexCapacity = FMath::Max(DefaultPageIndices, NumIndices);
+
+	FRuntimeMeshBufferPoolPage* NewPage = new FRuntimeMeshBufferPoolPage(VertexStride, Allocation->bIsPinned, VertexCapacity, IndexCapacity);
+	Pages.Add(NewPage);
+
+	verify(TryAllocateInPage(NewPage, Allocation, NumVertices, NumIndices));
+}
+
+bool FRuntimeMeshBufferPool::TryAllocateInPage(FRuntimeMeshBufferPoolPage* Page, FRuntimeMeshPoolAllocation* Allocation, int32 NumVertices, int32 NumIndices)
+{
+	int32 VertexStart;
+	if (!Page->VertexFreeList.Allocate(NumVertices, VertexStart))
+	{
+		return false;
+	}
+
+	int32 IndexStart;
+	if (!Page->IndexFreeList.Allocate(NumIndices, IndexStart))
+	{
+		Page->VertexFreeList.Free(VertexStart, NumVertices);
+		return false;
+	}
+
+	Allocation->Page = Page;
+	Allocation->Vertices = FRuntimeMeshBufferSpan(VertexStart, NumVertices);
+	Allocation->Indices = FRuntimeMeshBufferSpan(IndexStart, NumIndices);
+	Page->Allocations.Add(Allocation);
+	return true;
+}
+
+void FRuntimeMeshBufferPool::FreeFromPage(FRuntimeMeshPoolAllocation* Allocation)
+{
+	FRuntimeMeshBufferPoolPage* Page = Allocation->Page;
+	check(Page);
+
+	Page->VertexFreeList.Free(Allocation->Vertices.Start, Allocation->Vertices.Count);
+	Page->IndexFreeList.Free(Allocation->Indices.Start, Allocation->Indices.Count);
+	Page->Allocations.RemoveSingleSwap(Allocation);
+
+	Allocation->Page = nullptr;
+	Allocation->Vertices = FRuntimeMeshBufferSpan();
+	Allocation->Indices = FRuntimeMeshBufferSpan();
+}
+
+bool FRuntimeMeshBufferPool::ResizeSpan(FRuntimeMeshFreeList& FreeList, FRuntimeMeshBufferSpan& Span, int32 NewCount)
+{
+	if (NewCount == Span.Count)
+	{
+		return true;
+	}
+
+	// Shrinking always works in place
+	if (NewCount < Span.Count)
+	{
+		FreeList.Free(Span.Start + NewCount, Span.Count - NewCount);
+		Span.Count = NewCount;
+		return true;
+	}
+
+	// Try to grow into the space right after us
+	if (Span.Count > 0 && FreeList.AllocateAt(Span.End(), NewCount - Span.Count))
+	{
+		Span.Count = NewCount;
+		return true;
+	}
+
+	// Otherwise find a new spot in this page
+	int32 NewStart;
+	if (FreeList.Allocate(NewCount, NewStart))
+	{
+		FreeList.Free(Span.Start, Span.Count);
+		Span = FRuntimeMeshBufferSpan(NewStart, NewCount);
+		return true;
+	}
+
+	return false;
+}
+
+void FRuntimeMeshBufferPool::DefragmentPage(FRuntimeMeshBufferPoolPage* Page)
+{
+	TArray<FRuntimeMeshPoolAllocation*>& Allocations = Page->Allocations;
+
+	// Work out the compacted layout, packing allocations down in the order they're currently in
+	TArray<FRuntimeMeshBufferSpan> NewVertices;
+	TArray<FRuntimeMeshBufferSpan> NewIndices;
+	NewVertices.SetNum(Allocations.Num());
+	NewIndices.SetNum(Allocations.Num());
+
+	TArray<int32> Order;
+	Order.SetNum(Allocations.Num());
+
+	bool bAnythingMoved = false;
+	int32 VertexEnd = 0;
+	int32 IndexEnd = 0;
+
+	for (int32 Index = 0; Index < Order.Num(); Index++)
+	{
+		Order[Index] = Index;
+	}
+	Order.Sort([&](int32 A, int32 B) { return Allocations[A]->Vertices.Start < Allocations[B]->Vertices.Start; });
+	for (int32 AllocationIndex : Order)
+	{
+		NewVertices[AllocationIndex] = FRuntimeMeshBufferSpan(VertexEnd, Allocations[AllocationIndex]->Vertices.Count);
+		VertexEnd += Allocations[AllocationIndex]->Vertices.Count;
+		bAnythingMoved |= NewVertices[AllocationIndex].Start != Allocations[AllocationIndex]->Vertices.Start;
+	}
+
+	Order.Sort([&](int32 A, int32 B) { return Allocations[A]->Indices.Start < Allocations[B]->Indices.Start; });
+	for (int32 AllocationIndex : Order)
+	{
+		NewIndices[AllocationIndex] = FRuntimeMeshBufferSpan(IndexEnd, Allocations[AllocationIndex]->Indices.Count);
+		IndexEnd += Allocations[AllocationIndex]->Indices.Count;
+		bAnythingMoved |= NewIndices[AllocationIndex].Start != Allocations[AllocationIndex]->Indices.Start;
+	}
+
+	if (!bAnythingMoved)
+	{
+		return;
+	}
+
+	int32 Stride = Page->VertexStride;
+	int32 VertexCapacity = Page->VertexFreeList.GetCapacity();
+	int32 IndexCapacity = Page->IndexFreeList.GetCapacity();
+
+	// Work from the copy, so there's nothing to read back
+	TArray<uint8> OldVertexData = MoveTemp(Page->VertexData);
+	TArray<uint32> OldIndexData = MoveTemp(Page->IndexData);
+
+	// Build the compacted page
+	TArray<uint8>& NewVertexData = Page->VertexData;
+	NewVertexData.SetNumZeroed(VertexCapacity * Stride);
+	TArray<uint32>& NewIndexData = Page->IndexData;
+	NewIndexData.SetNumZeroed(IndexCapacity);
+
+	for (int32 AllocationIndex = 0; AllocationIndex < Allocations.Num(); AllocationIndex++)
+	{
+		FRuntimeMeshPoolAllocation* Allocation = Allocations[AllocationIndex];
+
+		FMemory::Memcpy(NewVertexData.GetData() + NewVertices[AllocationIndex].Start * Stride,
+			OldVertexData.GetData() + Allocation->Vertices.Start * Stride, Allocation->Vertices.Count * Stride);
+
+		// Indices have to follow their vertices
+		int32 VertexDelta = NewVertices[AllocationIndex].Start - Allocation->Vertices.Start;
+		const uint32* Source = OldIndexData.GetData() + Allocation->Indices.Start;
+		uint32* Dest = NewIndexData.GetData() + NewIndices[AllocationIndex].Start;
+		for (int32 Index = 0; Index < Allocation->Indices.Count; Index++)
+		{
+			Dest[Index] = Source[Index] + VertexDelta;
+		}
+
+		if (Allocation->Vertices.Start != NewVertices[AllocationIndex].Start || Allocation->Indices.Start != NewIndices[AllocationIndex].Start)
+		{
+			Allocation->Generation++;
+		}
+
+		Allocation->Vertices = NewVertices[AllocationIndex];
+		Allocation->Indices = NewIndices[AllocationIndex];
+	}
+
+	// Upload it whole
+	Page->bIsVertexDataDirty = true;
+	Page->bIsIndexDataDirty = true;
+	Page->Flush();
+
+	// Everything is now packed at the start of the page
+	Page->VertexFreeList.Reset(VertexCapacity);
+	verify(Page->VertexFreeList.AllocateAt(0, VertexEnd));
+	Page->IndexFreeList.Reset(IndexCapacity);
+	verify(Page->IndexFreeList.AllocateAt(0, IndexEnd));
+}
+
+void FRuntimeMeshBufferPool::UpdateStats() const
+{
+#if STATS
+	FRuntimeMeshBufferPoolStats Stats = GetStats();
+	SET_DWORD_STAT(STAT_RuntimeMesh_PoolPages, Stats.NumPages);
+	SET_DWORD_STAT(STAT_RuntimeMesh_PoolAllocations, Stats.NumAllocations);
+	SET_MEMORY_STAT(STAT_RuntimeMesh_PoolAllocatedMemory, Stats.AllocatedBytes);
+	SET_MEMORY_STAT(STAT_RuntimeMesh_PoolUsedMemory, Stats.UsedBytes);
+	SET_DWORD_STAT(STAT_RuntimeMesh_PoolFragmentation, FMath::RoundToInt(Stats.GetFragmentation() * 100.0f));
+#endif
+}
+
+
+
+static void LogRuntimeMeshBufferPoolStats()
+{
+	ENQUEUE_UNIQUE_RENDER_COMMAND(
+		FRuntimeMeshLogBufferPoolStats,
+		{
+			FRuntimeMeshBufferPool::Get().LogStats();
+		});
+}
+
+static void DefragmentRuntimeMeshBufferPool()
+{
+	ENQUEUE_UNIQUE_RENDER_COMMAND(
+		FRuntimeMeshDefragmentBufferPool,
+		{
+			FRuntimeMeshBufferPool::Get().Defragment();
+			FRuntimeMeshBufferPool::Get().LogStats();
+		});
+}
+
+static FAutoConsoleCommand GRuntimeMeshPoolStatsCommand(
+	TEXT("RuntimeMesh.BufferPool.Stats"),
+	TEXT("Logs the occupancy and fragmentation of the shared runtime mesh buffer pool."),
+	FConsoleCommandDelegate::CreateStatic(&LogRuntimeMeshBufferPoolStats));
+
+static FAutoConsoleCommand GRuntimeMeshPoolDefragmentCommand(
+	TEXT("RuntimeMesh.BufferPool.Defragment"),
+	TEXT("Compacts the shared runtime mesh buffer pool and releases empty pages."),
+	FConsoleCommandDelegate::CreateStatic(&DefragmentRuntimeMeshBufferPool));
@@ -0,0 +1,112 @@
+// Copyright 2016 Chris Conway (Koderz). All Rights Reserved.
+
+#include "RuntimeMeshComponentPluginPrivatePCH.h"
+#include "RuntimeMeshChunkTree.h"
+
+
+void FRuntimeMeshChunkTree::Build(const TArray<FBox>& SectionBounds, int32 MaxSectionsPerChunk)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_BuildChunkTree);
+
+	Reset();
+
+	TArray<FVector> SectionCenters;
+	SectionCenters.SetNumUninitialized(SectionBounds.Num());
+	SectionInTree.Init(false, SectionBounds.Num());
+
+	for (int32 SectionIndex = 0; SectionIndex < SectionBounds.Num(); SectionIndex++)
+	{
+		if (SectionBounds[SectionIndex].IsValid)
+		{
+			SectionIndices.Add(SectionIndex);
+			SectionCenters[SectionIndex] = SectionBounds[SectionIndex].GetCenter();
+			SectionInTree[SectionIndex] = true;
+		}
+	}
+
+	if (SectionIndices.Num() == 0)
+	{
+		return;
+	}
+
+	Nodes.AddDefaulted();
+	BuildNode(0, SectionCenters, 0, SectionIndices.Num(), FMath::Max(MaxSectionsPerChunk, 1));
+
+	Refit(SectionBounds);
+}
+
+void FRuntimeMeshChunkTree::BuildNode(int32 NodeIndex, const TArray<FVector>& SectionCenters, int32 First, int32 Count, int32 MaxSectionsPerChunk)
+{
+	if (Count <= MaxSectionsPerChunk)
+	{
+		const int32 ChunkIndex = Chunks.AddDefaulted();
+		Chunks[ChunkIndex].FirstSection = First;
+		Chunks[ChunkIndex].NumSections = Count;
+
+		Nodes[NodeIndex].FirstChild = INDEX_NONE;
+		Nodes[NodeIndex].ChunkIndex = ChunkIndex;
+		Nodes[NodeIndex].NumChunks = 1;
+		return;
+	}
+
+	// Split at the median section along the longest axis the section centers are spread over
+	FBox CenterBounds(0);
+	for (int32 Index = First; Index < First + Count; Index++)
+	{
+		CenterBounds += SectionCenters[SectionIndices[Index]];
+	}
+
+	const FVector Extent = CenterBounds.GetExtent();
+	const int32 Axis = (Extent.X >= Extent.Y && Extent.X >= Extent.Z) ? 0 : (Extent.Y >= Extent.Z ? 1 : 2);
+
+	Sort(SectionIndices.GetData() + First, Count, [&](int32 A, int32 B) { return SectionCenters[A][Axis] < SectionCenters[B][Axis]; });
+
+	const int32 NumLeft = Count / 2;
+
+	// Both children are added before either is built, so they end up next to each other
+	const int32 FirstChild = Nodes.AddDefaulted(2);
+	BuildNode(FirstChild, SectionCenters, First, NumLeft, MaxSectionsPerChunk);
+	BuildNode(FirstChild + 1, SectionCenters, First + NumLeft, Count - NumLeft, MaxSectionsPerChunk);
+
+	Nodes[NodeIndex].FirstChild = FirstChild;
+	Nodes[NodeIndex].ChunkIndex = INDEX_NONE;
+	Nodes[NodeIndex].NumChunks = Nodes[FirstChild].NumChunks + Nodes[FirstChild + 1].NumChunks;
+}
+
+void FRuntimeMeshChunkTree::Refit(const TArray<FBox>& SectionBounds)
+{
+	for (FChunk& Chunk : Chunks)
+	{
+		Chunk.Bounds.Init();
+		for (int32 Index = Chunk.FirstSection; Index < Chunk.FirstSection + Chunk.NumSections; Index++)
+		{
+			const int32 SectionIndex = SectionIndices[Index];
+			if (SectionBounds.IsValidIndex(SectionIndex))
+			{
+				Chunk.Bounds += SectionBounds[SectionIndex];
+			}
+		}
+	}
+
+	// Children always come after their parent, so walking backwards fits every child before its parent
+	for (int32 NodeIndex = Nodes.Num() - 1; NodeIndex >= 0; NodeIndex--)
+	{
+		FNode& Node = Nodes[NodeIndex];
+		if (Node.ChunkIndex != INDEX_NONE)
+		{
+			Node.Bounds = Chunks[Node.ChunkIndex].Bounds;
+		}
+		else
+		{
+			Node.Bounds = Nodes[Node.FirstChild].Bounds + Nodes[Node.FirstChild + 1].Bounds;
+		}
+	}
+}
+
+void FRuntimeMeshChunkTree::Reset()
+{
+	Nodes.Reset();
+	Chunks.Reset();
+	SectionIndices.Reset();
+	SectionInTree.Empty();
+}
@@ -0,0 +1,162 @@
+// Copyright 2016 Chris Conway (Koderz). All Rights Reserved.
+
+#include "RuntimeMeshComponentPluginPrivatePCH.h"
+#include "RuntimeMeshCollisionBody.h"
+#include "RuntimeMeshCollisionCache.h"
+
+
+URuntimeMeshCollisionBody::URuntimeMeshCollisionBody(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, BodySetup(nullptr)
+	, bIsCancelled(false)
+	, bIsCookedDataLoaded(false)
+	, bHasCacheKey(false)
+	, bIsCollisionSection(false)
+	, SectionIndex(INDEX_NONE)
+{
+}
+
+void URuntimeMeshCollisionBody::SetCollisionData(bool bInIsCollisionSection, int32 InSectionIndex, TArray<FVector>& Vertices, const TArray<int32>& Triangles, bool bUseComplexAsSimpleCollision)
+{
+	bIsCollisionSection = bInIsCollisionSection;
+	SectionIndex = InSectionIndex;
+
+	CollisionData.Vertices = MoveTemp(Vertices);
+
+	const int32 NumTriangles = Triangles.Num() / 3;
+	CollisionData.Indices.SetNumUninitialized(NumTriangles);
+	for (int32 TriIdx = 0; TriIdx < NumTriangles; TriIdx++)
+	{
+		FTriIndices& Triangle = CollisionData.Indices[TriIdx];
+		Triangle.v0 = Triangles[(TriIdx * 3) + 0];
+		Triangle.v1 = Triangles[(TriIdx * 3) + 1];
+		Triangle.v2 = Triangles[(TriIdx * 3) + 2];
+	}
+
+	// Same material info as the combined mesh, so hit results don't change between the modes
+	CollisionData.MaterialIndices.Init(SectionIndex, NumTriangles);
+	CollisionData.bFlipNormals = true;
+
+	// Configured the same as the component's body setup, the collision data provider is this body as its outer
+	BodySetup = NewObject<UBodySetup>(this);
+	BodySetup->BodySetupGuid = FGuid::NewGuid();
+	BodySetup->bGenerateMirroredCollision = false;
+	BodySetup->bDoubleSidedGeometry = true;
+	BodySetup->CollisionTraceFlag = bUseComplexAsSimpleCollision ? CTF_UseComplexAsSimple : CTF_UseDefault;
+}
+
+bool URuntimeMeshCollisionBody::LoadFromCollisionCache()
+{
+	check(BodySetup);
+
+	bIsCookedDataLoaded = FRuntimeMeshCollisionCache::Get().LoadCookedData(BodySetup, CollisionData.Indices.Num() > 0 ? &CollisionData : nullptr, CacheKey);
+	bHasCacheKey = true;
+	return bIsCookedDataLoaded;
+}
+
+void URuntimeMeshCollisionBody::Cook(bool bUseCollisionCache)
+{
+	check(IsInGameThread());
+	check(BodySetup);
+
+	if (bIsCookedDataLoaded)
+	{
+		return;
+	}
+
+	// The key is already known if the cache was searched on a worker
+	if (bHasCacheKey)
+	{
+		FRuntimeMeshCollisionCache::Get().CookMissedBodySetup(BodySetup, CacheKey);
+		return;
+	}
+
+	if (bUseCollisionCache)
+	{
+		FRuntimeMeshCollisionCache::Get().CookBodySetup(BodySetup, CollisionData.Indices.Num() > 0 ? &CollisionData : nullptr);
+		return;
+	}
+
+#if WITH_RUNTIME_PHYSICS_COOKING || WITH_EDITOR
+	BodySetup->GetCookedData(FName(FPlatformProperties::GetPhysicsFormat()));
+#endif // WITH_RUNTIME_PHYSICS_COOKING || WITH_EDITOR
+}
+
+void URuntimeMeshCollisionBody::CreatePhysicsMeshes()
+{
+	check(IsInGameThread());
+	check(BodySetup);
+
+#if WITH_RUNTIME_PHYSICS_COOKING || WITH_EDITOR
+	BodySetup->CreatePhysicsMeshes();
+#endif // WITH_RUNTIME_PHYSICS_COOKING || WITH_EDITOR
+}
+
+void URuntimeMeshCollisionBody::InitBody(UPrimitiveComponent* Owner)
+{
+	check(Owner);
+
+	UWorld* World = Owner->GetWorld();
+	if (BodySetup == nullptr || World == nullptr || World->GetPhysicsScene() == nullptr)
+	{
+		return;
+	}
+
+	TermBody();
+
+	CopyCollisionSettings(Owner, false);
+
+	// Lets hit results tell which section was hit
+	BodyInstance.InstanceBodyIndex = SectionIndex;
+
+	BodyInstance.InitBody(BodySetup, Owner->ComponentToWorld, Owner, World->GetPhysicsScene());
+}
+
+void URuntimeMeshCollisionBody::UpdateCollisionSettings(UPrimitiveComponent* Owner)
+{
+	check(Owner);
+
+	if (BodyInstance.IsValidBodyInstance())
+	{
+		CopyCollisionSettings(Owner, true);
+	}
+}
+
+void URuntimeMeshCollisionBody::CopyCollisionSettings(UPrimitiveComponent* Owner, bool bUpdatePhysicsFilterData)
+{
+	// The owner's body instance is already running, so its settings are copied over one by one
+	BodyInstance.SetCollisionEnabled(Owner->GetCollisionEnabled(), bUpdatePhysicsFilterData);
+	BodyInstance.SetObjectType(Owner->GetCollisionObjectType());
+	BodyInstance.SetResponseToChannels(Owner->GetCollisionResponseToChannels());
+}
+
+void URuntimeMeshCollisionBody::TermBody()
+{
+	BodyInstance.TermBody();
+}
+
+void URuntimeMeshCollisionBody::SetBodyTransform(const FTransform& NewTransform, ETeleportType Teleport)
+{
+	if (BodyInstance.IsValidBodyInstance())
+	{
+		BodyInstance.SetBodyTransform(NewTransform, Teleport);
+	}
+}
+
+bool URuntimeMeshCollisionBody::GetPhysicsTriMeshData(struct FTriMeshCollisionData* OutCollisionData, bool InUseAllTriData)
+{
+	*OutCollisionData = CollisionData;
+	return CollisionData.Indices.Num() > 0;
+}
+
+bool URuntimeMeshCollisionBody::ContainsPhysicsTriMeshData(bool InUseAllTriData) const
+{
+	return CollisionData.Indices.Num() > 0;
+}
+
+void URuntimeMeshCollisionBody::BeginDestroy()
+{
+	TermBody();
+
+	Super::BeginDestroy();
+}
@@ -0,0 +1,382 @@
+// Copyright 2016 Chris Conway (Koderz). All Rights Reserved.
+
+#include "RuntimeMeshComponentPluginPrivatePCH.h"
+#include "RuntimeMeshCollisionCache.h"
+#include "PhysicsEngine/PhysicsSettings.h"
+
+
+/* Change this when the layout of what gets hashed changes, so old entries on disk are never matched */
+static const uint32 RuntimeMeshCollisionCacheVersion = 2;
+
+
+FRuntimeMeshCollisionCache& FRuntimeMeshCollisionCache::Get()
+{
+	static FRuntimeMeshCollisionCache Cache;
+	return Cache;
+}
+
+FRuntimeMeshCollisionCache::FRuntimeMeshCollisionCache()
+	: MemoryUsed(0)
+	, MaxMemory(DefaultMaxMemory)
+	, bUseDiskCache(false)
+	, UseCounter(0)
+	, NumHits(0)
+	, NumDiskHits(0)
+	, NumMisses(0)
+	, DiskUsed(0)
+	, bIsDiskUsedKnown(false)
+	, MaxDiskSize(DefaultMaxDiskSize)
+{
+}
+
+void FRuntimeMeshCollisionCache::SetLimits(int64 InMaxMemory, bool bInUseDiskCache, int64 InMaxDiskSize)
+{
+	{
+		FScopeLock ScopeLock(&Lock);
+		MaxMemory = FMath::Max<int64>(InMaxMemory, 0);
+		bUseDiskCache = bInUseDiskCache;
+		EvictToLimit();
+	}
+
+	FScopeLock DiskScopeLock(&DiskLock);
+	MaxDiskSize = FMath::Max<int64>(InMaxDiskSize, 0);
+	if (bInUseDiskCache)
+	{
+		EvictDiskToLimit();
+	}
+}
+
+void FRuntimeMeshCollisionCache::Empty()
+{
+	FScopeLock ScopeLock(&Lock);
+	Entries.Empty();
+	MemoryUsed = 0;
+	SET_MEMORY_STAT(STAT_RuntimeMesh_CollisionCacheMemory, MemoryUsed);
+}
+
+void FRuntimeMeshCollisionCache::CookBodySetup(UBodySetup* BodySetup, const FTriMeshCollisionData* CollisionData)
+{
+	check(IsInGameThread());
+
+	FSHAHash Key;
+	if (!LoadCookedData(BodySetup, CollisionData, Key))
+	{
+		CookMissedBodySetup(BodySetup, Key);
+	}
+}
+
+bool FRuntimeMeshCollisionCache::LoadCookedData(UBodySetup* BodySetup, const FTriMeshCollisionData* CollisionData, FSHAHash& OutKey)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_LoadCookedData);
+	check(BodySetup);
+
+	const FName Format(FPlatformProperties::GetPhysicsFormat());
+	OutKey = ComputeKey(BodySetup, CollisionData, Format);
+
+	// Identical content gets an identical guid, instead of a new random one every time
+	static_assert(sizeof(OutKey.Hash) >= sizeof(FGuid), "Hash too small to make a guid from");
+	FMemory::Memcpy(&BodySetup->BodySetupGuid, OutKey.Hash, sizeof(FGuid));
+
+	TArray<uint8> CookedData;
+	bool bFound = false;
+	bool bCheckDisk = false;
+	{
+		FScopeLock ScopeLock(&Lock);
+		if (FEntry* Entry = Entries.Find(OutKey))
+		{
+			Entry->LastUsed = ++UseCounter;
+			CookedData = Entry->CookedData;
+			bFound = true;
+			NumHits++;
+		}
+		bCheckDisk = bUseDiskCache;
+	}
+
+	if (!bFound && bCheckDisk && FFileHelper::LoadFileToArray(CookedData, *GetDiskCachePath(OutKey), FILEREAD_Silent) && CookedData.Num() > 0)
+	{
+		bFound = true;
+		AddToMemoryCache(OutKey, CookedData);
+
+		// Files are evicted oldest first, so reading one counts as using it
+		IFileManager::Get().SetTimeStamp(*GetDiskCachePath(OutKey), FDateTime::UtcNow());
+
+		FScopeLock ScopeLock(&Lock);
+		NumDiskHits++;
+	}
+
+	if (!bFound)
+	{
+		return false;
+	}
+
+	INC_DWORD_STAT(STAT_RuntimeMesh_CollisionCacheHits);
+
+	// Put in place of the cook, so GetCookedData() and CreatePhysicsMeshes() use it instead of cooking. 
+	// Only touches the body setup's own bulk data, which nothing else is using until it is swapped in
+	FByteBulkData& BulkData = BodySetup->CookedFormatData.GetFormat(Format);
+	BulkData.Lock(LOCK_READ_WRITE);
+	FMemory::Memcpy(BulkData.Realloc(CookedData.Num()), CookedData.GetData(), CookedData.Num());
+	BulkData.Unlock();
+	return true;
+}
+
+void FRuntimeMeshCollisionCache::CookMissedBodySetup(UBodySetup* BodySetup, const FSHAHash& Key)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_CookBodySetupCached);
+	check(IsInGameThread());
+	check(BodySetup);
+
+	INC_DWORD_STAT(STAT_RuntimeMesh_CollisionCacheMisses);
+
+#if WITH_RUNTIME_PHYSICS_COOKING || WITH_EDITOR
+	// GetCookedData() goes through the derived data cache and the physics format modules, which is game thread only on 4.10-4.14
+	FByteBulkData* BulkData = BodySetup->GetCookedData(FName(FPlatformProperties::GetPhysicsFormat()));
+
+	// Nothing to store if there was nothing to cook
+	if (BulkData == nullptr || BulkData->GetBulkDataSize() <= 0)
+	{
+		return;
+	}
+
+	TArray<uint8> CookedData;
+	CookedData.SetNumUninitialized(BulkData->GetBulkDataSize());
+	FMemory::Memcpy(CookedData.GetData(), BulkData->LockReadOnly(), CookedData.Num());
+	BulkData->Unlock();
+
+	AddToMemoryCache(Key, CookedData);
+
+	bool bCheckDisk = false;
+	{
+		FScopeLock ScopeLock(&Lock);
+		NumMisses++;
+		bCheckDisk = bUseDiskCache;
+	}
+
+	if (bCheckDisk)
+	{
+		AddToDiskCache(Key, CookedData);
+	}
+#endif // WITH_RUNTIME_PHYSICS_COOKING || WITH_EDITOR
+}
+
+void FRuntimeMeshCollisionCache::LogStats()
+{
+	FScopeLock ScopeLock(&Lock);
+	UE_LOG(RuntimeMeshLog, Log, TEXT("Collision cache: %d entries, %.2f of %.2f MB, %d hits (%d from disk), %d misses, disk cache %s"),
+		Entries.Num(), MemoryUsed / (1024.0 * 1024.0), MaxMemory / (1024.0 * 1024.0), NumHits + NumDiskHits, NumDiskHits, NumMisses,
+		bUseDiskCache ? TEXT("enabled") : TEXT("disabled"));
+
+	FScopeLock DiskScopeLock(&DiskLock);
+	if (bIsDiskUsedKnown)
+	{
+		UE_LOG(RuntimeMeshLog, Log, TEXT("Collision cache on disk: %.2f of %.2f MB"), DiskUsed / (1024.0 * 1024.0), MaxDiskSize / (1024.0 * 1024.0));
+	}
+}
+
+FSHAHash FRuntimeMeshCollisionCache::ComputeKey(const UBodySetup* BodySetup, const FTriMeshCollisionData* CollisionData, FName Format)
+{
+	FSHA1 HashState;
+
+	// Cooked data is only reusable by the same engine and physics format
+	const uint32 Versions[] = { RuntimeMeshCollisionCacheVersion, ENGINE_MAJOR_VERSION, ENGINE_MINOR_VERSION };
+	HashState.Update(reinterpret_cast<const uint8*>(Versions), sizeof(Versions));
+
+	const FString FormatString = Format.ToString();
+	HashState.UpdateWithString(*FormatString, FormatString.Len());
+
+	// Settings the cooker reads from the body setup
+	const uint8 Settings[] =
+	{
+		(uint8)BodySetup->CollisionTraceFlag.GetValue(),
+		(uint8)BodySetup->bDoubleSidedGeometry,
+		(uint8)BodySetup->bGenerateMirroredCollision,
+		(uint8)BodySetup->bGenerateNonMirroredCollision,
+	};
+	HashState.Update(Settings, sizeof(Settings));
+
+	// Project wide settings the cooker reads. Body setups using the default collision complexity get it from here
+	const UPhysicsSettings* PhysicsSettings = UPhysicsSettings::Get();
+	const uint8 ProjectSettings[] =
+	{
+		(uint8)PhysicsSettings->DefaultShapeComplexity.GetValue(),
+#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION >= 14
+		(uint8)PhysicsSettings->bSuppressFaceRemapTable,
+#endif
+	};
+	HashState.Update(ProjectSettings, sizeof(ProjectSettings));
+	HashState.Update(reinterpret_cast<const uint8*>(&PhysicsSettings->TriangleMeshTriangleMinAreaThreshold), sizeof(PhysicsSettings->TriangleMeshTriangleMinAreaThreshold));
+
+	// Array sizes are hashed along with the arrays so different splits of the same bytes don't match
+	const int32 NumConvexElems = BodySetup->AggGeom.ConvexElems.Num();
+	HashState.Update(reinterpret_cast<const uint8*>(&NumConvexElems), sizeof(NumConvexElems));
+	for (const FKConvexElem& ConvexElem : BodySetup->AggGeom.ConvexElems)
+	{
+		const int32 NumVertices = ConvexElem.VertexData.Num();
+		HashState.Update(reinterpret_cast<const uint8*>(&NumVertices), sizeof(NumVertices));
+		HashState.Update(reinterpret_cast<const uint8*>(ConvexElem.VertexData.GetData()), NumVertices * sizeof(FVector));
+	}
+
+	const int32 Counts[] =
+	{
+		CollisionData ? CollisionData->Vertices.Num() : -1,
+		CollisionData ? CollisionData->Indices.Num() : -1,
+		CollisionData ? CollisionData->MaterialIndices.Num() : -1,
+		CollisionData ? (int32)CollisionData->bFlipNormals : -1,
+	};
+	HashState.Update(reinterpret_cast<const uint8*>(Counts), sizeof(Counts));
+
+	if (CollisionData)
+	{
+		HashState.Update(reinterpret_cast<const uint8*>(CollisionData->Vertices.GetData()), CollisionData->Vertices.Num() * sizeof(FVector));
+		HashState.Update(reinterpret_cast<const uint8*>(CollisionData->Indices.GetData()), CollisionData->Indices.Num() * sizeof(FTriIndices));
+		HashState.Update(reinterpret_cast<const uint8*>(CollisionData->MaterialIndices.GetData()), CollisionData->MaterialIndices.Num() * sizeof(CollisionData->MaterialIndices[0]));
+	}
+
+	HashState.Final();
+
+	FSHAHash Key;
+	HashState.GetHash(Key.Hash);
+	return Key;
+}
+
+FString FRuntimeMeshCollisionCache::GetDiskCacheDir()
+{
+	return FPaths::GameSavedDir() / TEXT("RuntimeMeshCollisionCache");
+}
+
+FString FRuntimeMeshCollisionCache::GetDiskCachePath(const FSHAHash& Key)
+{
+	return GetDiskCacheDir() / (Key.ToString() + TEXT(".bin"));
+}
+
+void FRuntimeMeshCollisionCache::AddToDiskCache(const FSHAHash& Key, const TArray<uint8>& CookedData)
+{
+	FScopeLock DiskScopeLock(&DiskLock);
+
+	// Too big to ever fit, and would only push everything else out
+	if (CookedData.Num() > MaxDiskSize)
+	{
+		return;
+	}
+
+	// Files left by earlier runs count towards the limit too
+	if (!bIsDiskUsedKnown)
+	{
+		EvictDiskToLimit();
+	}
+
+	if (FFileHelper::SaveArrayToFile(CookedData, *GetDiskCachePath(Key)))
+	{
+		DiskUsed += CookedData.Num();
+	}
+
+	if (DiskUsed > MaxDiskSize)
+	{
+		EvictDiskToLimit();
+	}
+}
+
+void FRuntimeMeshCollisionCache::EvictDiskToLimit()
+{
+	struct FDiskEntry
+	{
+		FString Path;
+		int64 Size;
+		FDateTime TimeStamp;
+	};
+
+	// Sizes are read from the files rather than trusted, as other runs of the game share the directory
+	const FString Dir = GetDiskCacheDir();
+	TArray<FString> FileNames;
+	IFileManager::Get().FindFiles(FileNames, *(Dir / TEXT("*.bin")), true, false);
+
+	TArray<FDiskEntry> DiskEntries;
+	DiskEntries.Reserve(FileNames.Num());
+	DiskUsed = 0;
+	for (const FString& FileName : FileNames)
+	{
+		FDiskEntry& DiskEntry = DiskEntries[DiskEntries.AddDefaulted()];
+		DiskEntry.Path = Dir / FileName;
+		DiskEntry.Size = FMath::Max<int64>(IFileManager::Get().FileSize(*DiskEntry.Path), 0);
+		DiskEntry.TimeStamp = IFileManager::Get().GetTimeStamp(*DiskEntry.Path);
+		DiskUsed += DiskEntry.Size;
+	}
+	bIsDiskUsedKnown = true;
+
+	if (DiskUsed <= MaxDiskSize)
+	{
+		return;
+	}
+
+	// Down to three quarters of the limit, so the directory isn't looked through again on the very next write
+	const int64 TargetDiskUsed = MaxDiskSize - MaxDiskSize / 4;
+	DiskEntries.Sort([](const FDiskEntry& A, const FDiskEntry& B) { return A.TimeStamp < B.TimeStamp; });
+	for (const FDiskEntry& DiskEntry : DiskEntries)
+	{
+		if (DiskUsed <= TargetDiskUsed)
+		{
+			break;
+		}
+
+		if (IFileManager::Get().Delete(*DiskEntry.Path, false, false, true))
+		{
+			DiskUsed -= DiskEntry.Size;
+		}
+	}
+}
+
+void FRuntimeMeshCollisionCache::AddToMemoryCache(const FSHAHash& Key, const TArray<uint8>& CookedData)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	// Too big to ever fit, and would only push everything else out
+	if (CookedData.Num() > MaxMemory)
+	{
+		return;
+	}
+
+	FEntry* Entry = Entries.Find(Key);
+	if (Entry == nullptr)
+	{
+		Entry = &Entries.Add(Key);
+		Entry->CookedData = CookedData;
+		MemoryUsed += CookedData.Num();
+	}
+	Entry->LastUsed = ++UseCounter;
+
+	EvictToLimit();
+}
+
+void FRuntimeMeshCollisionCache::EvictToLimit()
+{
+	// Evictions only happen when a new entry is cooked, which costs far more than walking the entries
+	while (MemoryUsed > MaxMemory && Entries.Num() > 0)
+	{
+		FSHAHash OldestKey;
+		uint64 OldestLastUsed = MAX_uint64;
+		for (const auto& Pair : Entries)
+		{
+			if (Pair.Value.LastUsed < OldestLastUsed)
+			{
+				OldestKey = Pair.Key;
+				OldestLastUsed = Pair.Value.LastUsed;
+			}
+		}
+
+		MemoryUsed -= Entries[OldestKey].CookedData.Num();
+		Entries.Remove(OldestKey);
+	}
+
+	SET_MEMORY_STAT(STAT_RuntimeMesh_CollisionCacheMemory, MemoryUsed);
+}
+
+
+static FAutoConsoleCommand GRuntimeMeshCollisionCacheStatsCommand(
+	TEXT("RuntimeMesh.CollisionCache.Stats"),
+	TEXT("Logs the size and hit rate of the cooked collision cache."),
+	FConsoleCommandDelegate::CreateLambda([]() { FRuntimeMeshCollisionCache::Get().LogStats(); }));
+
+static FAutoConsoleCommand GRuntimeMeshCollisionCacheEmptyCommand(
+	TEXT("RuntimeMesh.CollisionCache.Empty"),
+	TEXT("Removes everything from the cooked collision memory cache."),
+	FConsoleCommandDelegate::CreateLambda([]() { FRuntimeMeshCollisionCache::Get().Empty(); }));
@@ -5,10 +5,22 @@
 #include "RuntimeMeshCore.h"
 #include "RuntimeMeshGenericVertex.h"
 #include "RuntimeMeshVersion.h"
+#include "RuntimeMeshUploadScheduler.h"
+#include "RuntimeMeshChunkTree.h"
+#include "RuntimeMeshCollisionBody.h"
+#include "RuntimeMeshCollisionCache.h"
+#include "AI/NavigationSystemHelpers.h"
 
 
+/* Runs of the instances of a section visible in a view, kept until the frame has been drawn */
+class FRuntimeMeshInstanceRuns : public FOneFrameResource
+{
+public:
+	TArray<uint32> Runs;
+};
+
 /** Runtime mesh scene proxy */
-class FRuntimeMeshSceneProxy : public FPrimitiveSceneProxy
+class FRuntimeMeshSceneProxy : public FPrimitiveSceneProxy, public FRuntimeMeshStaticBatchVisibilityInterface
 {
 private:
 	// Temporarily holds all section creation data until this proxy is passsed to the RT.
@@ -19,6 +31,19 @@ public:
 
 	FRuntimeMeshSceneProxy(URuntimeMeshComponent* Component)
 		: FPrimitiveSceneProxy(Component)
+		, bCullSectionsIndividually(Component->bCullSectionsIndividually)
+		, bUseSpatialChunks(Component->bUseSpatialChunks && Component->bCullSectionsIndividually)
+		, MaxSectionsPerChunk(Component->MaxSectionsPerChunk)
+		, LODScreenSizes(Component->LODScreenSizes)
+		, bDitheredLODTransitions(Component->bDitheredLODTransitions)
+		, bMergeStaticSections(Component->bMergeStaticSections)
+		, NumStaticSections(0)
+		, NumDynamicSections(0)
+		, bIsMaterialRelevanceStale(false)
+		, bIsChunkTreeStale(true)
+		, bAreChunkBoundsStale(false)
+		, bAreChunkOcclusionBoundsStale(true)
+		, ChunkTreeBuildFrame(0)
 	{
 		bStaticElementsAlwaysUseProxyPrimitiveUniformBuffer = true;
 
@@ -40,6 +65,13 @@ public:
 				}
 
 
+				// Static sections can only be merged if they share buffers, so pack them into the pool. This is set on the
+				// section itself, as updates sent from the GT have to know the RT section is pooled.
+				if (bMergeStaticSections && SourceSection->UpdateFrequency == EUpdateFrequency::Infrequent)
+				{
+					SourceSection->bUseSharedBufferPool = true;
+				}
+
 				// Get the section creation data
 				auto* SectionData = SourceSection->GetSectionCreationData(&GetScene(), Material);
 				SectionData->SetTargetSection(SectionIdx);
@@ -69,14 +101,16 @@ public:
 
 		for (auto Section : SectionCreationData)
 		{
-			CreateSection_RenderThread(Section);
+			CreateSection_RenderThread(Section, false);
 		}
 		// The individual items are deleted by CreateSection_RenderThread so just clear the array.
 		SectionCreationData.Empty();
+
+		UpdateMaterialRelevance();
 	}
 
 	/** Called on render thread to create a new dynamic section. (Static sections are handled differently) */
-	void CreateSection_RenderThread(FRuntimeMeshSectionCreateDataInterface* SectionData)
+	void CreateSection_RenderThread(FRuntimeMeshSectionCreateDataInterface* SectionData, bool bUpdateMaterialRelevance = true)
 	{
 		SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_CreateSection_RenderThread);
 
@@ -94,20 +128,28 @@ public:
 		// If a section already exists... destroy it!
 		if (FRuntimeMeshSectionProxyInterface* Section = Sections[SectionIndex])
 		{			
+			RemoveSectionRelevance(Section);
 			delete Section;
 		}
 		
 		// Get the proxy and finish the creation here on the render thread.
 		FRuntimeMeshSectionProxyInterface* Section = SectionData->NewProxy;
 		Section->FinishCreate_RenderThread(SectionData);		
+		Section->SetStaticBatchVisibility(this);
 
 		// Save ref to new section
 		Sections[SectionIndex] = Section;
+		AddSectionRelevance(Section);
+		UpdateSectionWorldBounds(SectionIndex);
+		bIsChunkTreeStale = true;
 		
-		delete SectionData;
+		SectionData->Release();
 		
 		// Update material relevancy information needed to control the rendering.
-		UpdateMaterialRelevance();
+		if (bUpdateMaterialRelevance)
+		{
+			UpdateMaterialRelevance();
+		}
 	}
 
 	/** Called on render thread to assign new dynamic data */
@@ -121,9 +163,11 @@ public:
 		if (SectionData->GetTargetSection() < Sections.Num() && Sections[SectionData->GetTargetSection()] != nullptr)
 		{
 			Sections[SectionData->GetTargetSection()]->FinishUpdate_RenderThread(SectionData);
+			UpdateSectionWorldBounds(SectionData->GetTargetSection());
+			bAreChunkBoundsStale = true;
 		}
 
-		delete SectionData;
+		SectionData->Release();
  	}
 
 	void UpdateSectionPositionOnly_RenderThread(FRuntimeMeshRenderThreadCommandInterface* SectionData)
@@ -136,9 +180,11 @@ public:
 		if (SectionData->GetTargetSection() < Sections.Num() && Sections[SectionData->GetTargetSection()] != nullptr)
 		{
 			Sections[SectionData->GetTargetSection()]->FinishPositionUpdate_RenderThread(SectionData);
+			UpdateSectionWorldBounds(SectionData->GetTargetSection());
+			bAreChunkBoundsStale = true;
 		}
 
-		delete SectionData;
+		SectionData->Release();
 	}
 
 	void UpdateSectionProperties_RenderThread(FRuntimeMeshRenderThreadCommandInterface* SectionData)
@@ -154,21 +200,59 @@ public:
 		{
 			Sections[SectionIndex]->FinishPropertyUpdate_RenderThread(SectionData);
 		}
+
+		SectionData->Release();
+	}
+
+	void UpdateSectionInstances_RenderThread(FRuntimeMeshRenderThreadCommandInterface* SectionData)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_UpdateSectionInstances_RenderThread);
+
+		check(IsInRenderingThread());
+		check(SectionData);
+
+		int32 SectionIndex = SectionData->GetTargetSection();
+
+		if (SectionIndex < Sections.Num() && Sections[SectionIndex] != nullptr)
+		{
+			// Instancing moves a section off the static path
+			FRuntimeMeshSectionProxyInterface* Section = Sections[SectionIndex];
+			const bool bWasStatic = Section->WantsToRenderInStaticPath();
+			Section->FinishInstanceUpdate_RenderThread(SectionData);
+
+			if (bWasStatic != Section->WantsToRenderInStaticPath())
+			{
+				NumStaticSections += bWasStatic ? -1 : 1;
+				NumDynamicSections += bWasStatic ? 1 : -1;
+			}
+
+			// The bounds of instanced sections cover every instance, so move with them
+			UpdateSectionWorldBounds(SectionIndex);
+			bIsChunkTreeStale = true;
+		}
+
+		SectionData->Release();
 	}
 
 
-	void DestroySection_RenderThread(int32 SectionIndex)
+	void DestroySection_RenderThread(int32 SectionIndex, bool bUpdateMaterialRelevance = true)
 	{
 		check(IsInRenderingThread());
 
 		if (SectionIndex < Sections.Num() && Sections[SectionIndex] != nullptr)
 		{
+			RemoveSectionRelevance(Sections[SectionIndex]);
 			delete Sections[SectionIndex];
 			Sections[SectionIndex] = nullptr;
+			UpdateSectionWorldBounds(SectionIndex);
+			bIsChunkTreeStale = true;
 		}
 		
 		// Update material relevancy information needed to control the rendering.
-		UpdateMaterialRelevance();
+		if (bUpdateMaterialRelevance)
+		{
+			UpdateMaterialRelevance();
+		}
 	}
 
 	void ApplyBatchUpdate_RenderThread(FRuntimeMeshBatchUpdateData* BatchUpdateData)
@@ -181,15 +265,18 @@ public:
 		// Destroy flagged sections
 		for (auto& SectionIndex : BatchUpdateData->DestroySections)
 		{
-			DestroySection_RenderThread(SectionIndex);
+			DestroySection_RenderThread(SectionIndex, false);
 		}
 
 		// Create new sections
 		for (auto& SectionToCreate : BatchUpdateData->CreateSections)
 		{
-			CreateSection_RenderThread(static_cast<FRuntimeMeshSectionCreateDataInterface*>(SectionToCreate));
+			CreateSection_RenderThread(static_cast<FRuntimeMeshSectionCreateDataInterface*>(SectionToCreate), false);
 		}
 
+		// Relevance is only brought up to date once for the whole batch
+		UpdateMaterialRelevance();
+
 		// Update sections
 		for (auto& SectionToUpdate : BatchUpdateData->UpdateSections)
 		{
@@ -202,34 +289,20 @@ public:
 			UpdateSectionProperties_RenderThread(SectionToUpdate);
 		}
 
+		// Apply section instance updates
+		for (auto& SectionToUpdate : BatchUpdateData->InstanceUpdateSections)
+		{
+			UpdateSectionInstances_RenderThread(SectionToUpdate);
+		}
+
 		delete BatchUpdateData;
 
 	}
 
 
-	bool HasDynamicSections() const
-	{
-		for (FRuntimeMeshSectionProxyInterface* Section : Sections)
-		{
-			if (Section && !Section->WantsToRenderInStaticPath())
-			{
-				return true;
-			}
-		}
-		return false;
-	}
+	bool HasDynamicSections() const { return NumDynamicSections > 0; }
 
-	bool HasStaticSections() const 
-	{
-		for (FRuntimeMeshSectionProxyInterface* Section : Sections)
-		{
-			if (Section && Section->WantsToRenderInStaticPath())
-			{
-				return true;
-			}
-		}
-		return false;
-	}
+	bool HasStaticSections() const { return NumStaticSections > 0; }
 
 #if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION >= 11
 	virtual FPrimitiveViewRelevance GetViewRelevance(const FSceneView* View) const override
@@ -256,7 +329,15 @@ public:
 
 	void CreateMeshBatch(FMeshBatch& MeshBatch, FRuntimeMeshSectionProxyInterface* Section, FMaterialRenderProxy* WireframeMaterial) const
 	{
-		Section->CreateMeshBatch(MeshBatch, WireframeMaterial, IsSelected());
+		// The wireframe material only lives for a frame so it can't be cached, everything else copies the sections cached batch
+		if (WireframeMaterial)
+		{
+			Section->CreateMeshBatch(MeshBatch, WireframeMaterial, IsSelected());
+		}
+		else
+		{
+			MeshBatch = Section->GetCachedMeshBatch(IsSelected());
+		}
 
 		MeshBatch.ReverseCulling = IsLocalToWorldDeterminantNegative();
 		MeshBatch.bCanApplyViewModeOverrides = true;
@@ -269,13 +350,66 @@ public:
 	{
 		SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_DrawStaticElements);
 
-		for (FRuntimeMeshSectionProxyInterface* Section : Sections)
+		// The renderer picks the LOD of the static meshes from the screen size each is submitted with, 
+		// so sections drawn at every LOD are submitted once per LOD. They have to be submitted in LOD order.
+		const int32 NumLODs = GetNumLODs();
+		for (int32 LODIndex = 0; LODIndex < NumLODs; LODIndex++)
 		{
-			if (Section && Section->ShouldRender() && Section->WantsToRenderInStaticPath())
+			const float ScreenSize = LODIndex == 0 ? FLT_MAX : LODScreenSizes[LODIndex];
+
+			// Pooled sections that can share a vertex factory and material are drawn as elements of one batch
+			struct FMergedBatch
+			{
+				FRuntimeMeshSectionMergeKey Key;
+				FMeshBatch Batch;
+			};
+			TArray<FMergedBatch, TInlineAllocator<8>> MergedBatches;
+
+			for (int32 SectionIndex = 0; SectionIndex < Sections.Num(); SectionIndex++)
+			{
+				FRuntimeMeshSectionProxyInterface* Section = Sections[SectionIndex];
+				// Hidden sections are still submitted, so showing them again doesn't need the static draw lists rebuilt
+				if (Section && Section->HasRenderData() && Section->WantsToRenderInStaticPath() && Section->IsInLOD(LODIndex))
+				{
+					FMeshBatch MeshBatch;
+					CreateMeshBatch(MeshBatch, Section, nullptr);
+					MeshBatch.LODIndex = LODIndex;
+					MeshBatch.bDitheredLODTransition = NumLODs > 1 && bDitheredLODTransitions;
+
+					// Elements remember their section so they can be hidden and culled on their own. Asking for per element visibility 
+					// costs a call per batch every frame, so it's only done when sections are culled or merged, or this one is hidden. 
+					// Otherwise the GT recreates the proxy to hide the section.
+					MeshBatch.Elements[0].UserIndex = SectionIndex;
+					MeshBatch.bRequiresPerElementVisibility = bCullSectionsIndividually || bMergeStaticSections || !Section->ShouldRender();
+
+					FRuntimeMeshSectionMergeKey MergeKey;
+					if (!bMergeStaticSections || !Section->GetMergeKey(MergeKey))
+					{
+						PDI->DrawMesh(MeshBatch, ScreenSize);
+						continue;
+					}
+
+					FMergedBatch* MergedBatch = MergedBatches.FindByPredicate([&](const FMergedBatch& Entry) 
+					{ 
+						return Entry.Key == MergeKey && Entry.Batch.Elements.Num() < MaxMergedElements; 
+					});
+
+					if (MergedBatch)
+					{
+						MergedBatch->Batch.Elements.Add(MeshBatch.Elements[0]);
+					}
+					else
+					{
+						MergedBatch = &MergedBatches[MergedBatches.AddDefaulted()];
+						MergedBatch->Key = MergeKey;
+						MergedBatch->Batch = MeshBatch;
+					}
+				}
+			}
+
+			for (const FMergedBatch& MergedBatch : MergedBatches)
 			{
-				FMeshBatch MeshBatch;
-				CreateMeshBatch(MeshBatch, Section, nullptr);
-				PDI->DrawMesh(MeshBatch, FLT_MAX);
+				PDI->DrawMesh(MergedBatch.Batch, ScreenSize);
 			}
 		}
 	}
@@ -298,11 +432,51 @@ public:
 			Collector.RegisterOneFrameMaterialProxy(WireframeMaterialInstance);
 		}
 
+		// Make sure this frame's volatile sections have been written
+		FRuntimeMeshVolatileRingBuffer::Get().CommitFrame();
+
+		// Sections can only be culled on their own if there's more than one, otherwise the component culling has already done it
+		const bool bCullSections = bCullSectionsIndividually && Sections.Num() > 1;
+		int32 NumSectionsCulled = 0;
+		int32 NumInstancesCulled = 0;
+
+		// Work out the LOD of each view up front, rather than for every section
+		TArray<int32, TInlineAllocator<4>> ViewLODs;
+		ViewLODs.AddUninitialized(Views.Num());
+		for (int32 ViewIndex = 0; ViewIndex < Views.Num(); ViewIndex++)
+		{
+			ViewLODs[ViewIndex] = (VisibilityMap & (1 << ViewIndex)) ? ComputeLOD(Views[ViewIndex]) : 0;
+		}
+		int32 NumSectionsSkippedByLOD = 0;
+
+		// With spatial chunks, the sections in each view are found by walking the chunk tree once per view up front
+		const bool bCullChunks = bUseSpatialChunks && bCullSections;
+		TArray<TBitArray<>, TInlineAllocator<4>> ViewVisibleSections;
+		if (bCullChunks)
+		{
+			UpdateChunkTree();
+
+			ViewVisibleSections.SetNum(Views.Num());
+			for (int32 ViewIndex = 0; ViewIndex < Views.Num(); ViewIndex++)
+			{
+				if (VisibilityMap & (1 << ViewIndex))
+				{
+					GetVisibleChunkSections(Views[ViewIndex], ViewVisibleSections[ViewIndex]);
+				}
+			}
+		}
+
 		// Iterate over sections
-		for (FRuntimeMeshSectionProxyInterface* Section : Sections)
+		for (int32 SectionIndex = 0; SectionIndex < Sections.Num(); SectionIndex++)
 		{
+			FRuntimeMeshSectionProxyInterface* Section = Sections[SectionIndex];
 			if (Section && Section->ShouldRender())
 			{
+				// Sections without positions to bound can't be culled. Instanced sections are culled by the bounds of all their instances
+				const bool bCanCullSection = bCullSections && Section->GetCullingBoundingBox().IsValid;
+				const bool bIsInChunkTree = bCullChunks && ChunkTree.ContainsSection(SectionIndex);
+				const FBox& SectionBounds = SectionWorldBounds[SectionIndex];
+
 				// Add the mesh batch to every view it's visible in
 				for (int32 ViewIndex = 0; ViewIndex < Views.Num(); ViewIndex++)
 				{
@@ -312,9 +486,50 @@ public:
 
 						if (bForceDynamicPath || !Section->WantsToRenderInStaticPath())
 						{
+							if (!Section->IsInLOD(ViewLODs[ViewIndex]))
+							{
+								NumSectionsSkippedByLOD++;
+								continue;
+							}
+
+							if (bIsInChunkTree ? !ViewVisibleSections[ViewIndex][SectionIndex] : 
+								(bCanCullSection && !IsSectionVisibleInView(Section, SectionBounds, Views[ViewIndex])))
+							{
+								NumSectionsCulled++;
+								continue;
+							}
+
+							// Instances outside the view are left out, by drawing only the runs of instances that are visible
+							FRuntimeMeshInstanceRuns* InstanceRuns = nullptr;
+							const int32 NumInstances = Section->GetInstanceWorldBounds().Num();
+							if (NumInstances > 0)
+							{
+								TArray<uint32> Runs;
+								const int32 NumVisibleInstances = GetVisibleInstanceRuns(Section, Views[ViewIndex], Runs);
+								NumInstancesCulled += NumInstances - NumVisibleInstances;
+
+								if (NumVisibleInstances == 0)
+								{
+									continue;
+								}
+								if (NumVisibleInstances < NumInstances)
+								{
+									InstanceRuns = &Collector.AllocateOneFrameResource<FRuntimeMeshInstanceRuns>();
+									InstanceRuns->Runs = MoveTemp(Runs);
+								}
+							}
+
 							FMeshBatch& MeshBatch = Collector.AllocateMesh();
 							CreateMeshBatch(MeshBatch, Section, WireframeMaterialInstance);
 
+							if (InstanceRuns)
+							{
+								FMeshBatchElement& BatchElement = MeshBatch.Elements[0];
+								BatchElement.bIsInstanceRuns = true;
+								BatchElement.InstanceRuns = InstanceRuns->Runs.GetData();
+								BatchElement.NumInstances = InstanceRuns->Runs.Num() / 2;
+							}
+
 							Collector.AddMesh(ViewIndex, MeshBatch);
 						}
 					}
@@ -322,6 +537,10 @@ public:
 			}			
 		}
 
+		INC_DWORD_STAT_BY(STAT_RuntimeMesh_SectionsCulled, NumSectionsCulled);
+		INC_DWORD_STAT_BY(STAT_RuntimeMesh_InstancesCulled, NumInstancesCulled);
+		INC_DWORD_STAT_BY(STAT_RuntimeMesh_SectionsSkippedByLOD, NumSectionsSkippedByLOD);
+
 		// Draw bounds
 #if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
 		for (int32 ViewIndex = 0; ViewIndex < Views.Num(); ViewIndex++)
@@ -336,122 +555,578 @@ public:
 	}
 
 
-	virtual bool CanBeOccluded() const override
+	virtual uint64 GetMergedBatchElementVisibility(const FSceneView& View, const FMeshBatch* Batch, bool bIsShadowPass) const override
 	{
-		return !MaterialRelevance.bDisableDepthTest;
-	}
+		// Only batches that asked for per element visibility get here, see DrawStaticElements()
+		uint64 VisibilityMask = 0;
+		const bool bCullSections = bCullSectionsIndividually && Sections.Num() > 1;
+		for (int32 ElementIndex = 0; ElementIndex < Batch->Elements.Num(); ElementIndex++)
+		{
+			const int32 SectionIndex = Batch->Elements[ElementIndex].UserIndex;
+			FRuntimeMeshSectionProxyInterface* Section = Sections.IsValidIndex(SectionIndex) ? Sections[SectionIndex] : nullptr;
+			if (Section == nullptr || !Section->ShouldRender())
+			{
+				continue;
+			}
 
-	virtual uint32 GetMemoryFootprint(void) const
-	{
-		return(sizeof(*this) + GetAllocatedSize());
+			if (bCullSections && Section->GetCullingBoundingBox().IsValid)
+			{
+				// The static shadow path only has the camera's view, not the shadow's frustum, so shadows are only culled by draw distance
+				const FBox& SectionBounds = SectionWorldBounds[SectionIndex];
+				if (bIsShadowPass ? !IsSectionInDrawDistance(Section, SectionBounds, &View) : !IsSectionVisibleInView(Section, SectionBounds, &View))
+				{
+					continue;
+				}
+			}
+
+			VisibilityMask |= (uint64)1 << ElementIndex;
+		}
+		return VisibilityMask;
 	}
 
-	uint32 GetAllocatedSize(void) const
+	/* 
+	 *	Finds the instances of a section visible in a view, as runs of consecutive instances given by their first 
+	 *	and last index. Returns the number of visible instances.
+	 */
+	int32 GetVisibleInstanceRuns(const FRuntimeMeshSectionProxyInterface* Section, const FSceneView* View, TArray<uint32>& OutRuns) const
 	{
-		return(FPrimitiveSceneProxy::GetAllocatedSize());
+		const TArray<FBox>& InstanceBounds = Section->GetInstanceWorldBounds();
+		int32 NumVisibleInstances = 0;
+
+		for (int32 InstanceIndex = 0; InstanceIndex < InstanceBounds.Num(); InstanceIndex++)
+		{
+			if (!IsSectionVisibleInView(Section, InstanceBounds[InstanceIndex], View))
+			{
+				continue;
+			}
+
+			// Extend the last run if this instance follows straight on from it
+			if (OutRuns.Num() > 0 && OutRuns.Last() + 1 == (uint32)InstanceIndex)
+			{
+				OutRuns.Last() = InstanceIndex;
+			}
+			else
+			{
+				OutRuns.Add(InstanceIndex);
+				OutRuns.Add(InstanceIndex);
+			}
+			NumVisibleInstances++;
+		}
+
+		return NumVisibleInstances;
 	}
 
-	void UpdateMaterialRelevance()
+	/* Gets the number of LODs the sections are spread across */
+	int32 GetNumLODs() const { return FMath::Max(LODScreenSizes.Num(), 1); }
+
+	/* Picks the LOD to draw in a view from the screen size of the component, the same way the static path does */
+	int32 ComputeLOD(const FSceneView* View) const
 	{
-		FMaterialRelevance NewMaterialRelevance;
-		for (FRuntimeMeshSectionProxyInterface* Section : Sections)
+		const int32 NumLODs = GetNumLODs();
+		if (NumLODs == 1)
 		{
-			if (Section)
+			return 0;
+		}
+
+		const FBoxSphereBounds& ProxyBounds = GetBounds();
+		const float ScreenSize = ComputeBoundsScreenSize(ProxyBounds.Origin, ProxyBounds.SphereRadius, *View);
+
+		// Use the smallest LOD whose screen size we're under
+		for (int32 LODIndex = NumLODs - 1; LODIndex > 0; LODIndex--)
+		{
+			if (ScreenSize <= LODScreenSizes[LODIndex])
 			{
-				NewMaterialRelevance |= Section->GetMaterialRelevance();
+				return LODIndex;
 			}
 		}
-		MaterialRelevance = NewMaterialRelevance;
+		return 0;
 	}
 
-private:
-	/** Array of sections */
-	TArray<FRuntimeMeshSectionProxyInterface*> Sections;
+	/* 
+	 *	Tests a section's world bounds against the frustum a view is being gathered for and the section's draw distance.
+	 *	Shadow gathers pass the camera's view with the shadow's frustum set on it, which is used instead of the camera's.
+	 */
+	static bool IsSectionVisibleInView(const FRuntimeMeshSectionProxyInterface* Section, const FBox& SectionBounds, const FSceneView* View)
+	{
+		if (!IsSectionInDrawDistance(Section, SectionBounds, View))
+		{
+			return false;
+		}
 
-	FMaterialRelevance MaterialRelevance;
-};
+		if (const FConvexVolume* ShadowFrustum = View->GetDynamicMeshElementsShadowCullFrustum())
+		{
+			return ShadowFrustum->IntersectBox(SectionBounds.GetCenter() + View->GetPreShadowTranslation(), SectionBounds.GetExtent());
+		}
+		return View->ViewFrustum.IntersectBox(SectionBounds.GetCenter(), SectionBounds.GetExtent());
+	}
 
+	/* 
+	 *	Tests a section's world bounds against the section's draw distance from a view. Shadows are measured from the 
+	 *	camera too, so a section past its draw distance doesn't leave its shadow behind.
+	 */
+	static bool IsSectionInDrawDistance(const FRuntimeMeshSectionProxyInterface* Section, const FBox& SectionBounds, const FSceneView* View)
+	{
+		const float MaxDrawDistance = Section->GetMaxDrawDistance();
+		return MaxDrawDistance <= 0.0f || SectionBounds.ComputeSquaredDistanceToPoint(View->ViewLocation) <= FMath::Square(MaxDrawDistance);
+	}
 
+	/* Brings the chunk tree up to date with the sections, rebuilding it if sections have come or gone and refitting it if they've moved */
+	void UpdateChunkTree() const
+	{
+		if (!bIsChunkTreeStale && !bAreChunkBoundsStale)
+		{
+			return;
+		}
 
+		// Sections that have nothing to bound are left out
+		TArray<FBox> SectionBounds;
+		SectionBounds.SetNumUninitialized(Sections.Num());
+		for (int32 SectionIndex = 0; SectionIndex < Sections.Num(); SectionIndex++)
+		{
+			FRuntimeMeshSectionProxyInterface* Section = Sections[SectionIndex];
+			SectionBounds[SectionIndex] = Section ? Section->GetCullingBoundingBox() : FBox(0);
+		}
 
-void FRuntimeMeshComponentPrePhysicsTickFunction::ExecuteTick( float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
-{
-	/* Ensure target still exists */
+		if (bIsChunkTreeStale)
+		{
+			ChunkTree.Build(SectionBounds, MaxSectionsPerChunk);
+			ChunkTreeBuildFrame = GFrameNumberRenderThread;
 
+			// The chunks the old results were for are gone
+			ChunkOcclusionResults.Empty();
+		}
+		else
+		{
+			ChunkTree.Refit(SectionBounds);
+		}
+
+		bIsChunkTreeStale = false;
+		bAreChunkBoundsStale = false;
+		bAreChunkOcclusionBoundsStale = true;
+	}
+
+	/* 
+	 *	Marks the sections in the chunk tree that are visible in a view. Chunks are culled against the frustum and the 
+	 *	view's last occlusion results, then the sections in chunks partly in the frustum are culled on their own.
+	 *	Shadow gathers walk the tree against the shadow's frustum instead, and ignore the occlusion results, 
+	 *	as chunks hidden from the camera can still cast shadows into what it sees.
+	 */
+	void GetVisibleChunkSections(const FSceneView* View, TBitArray<>& OutVisibleSections) const
+	{
+		OutVisibleSections.Init(false, Sections.Num());
+
+		const FConvexVolume* ShadowFrustum = View->GetDynamicMeshElementsShadowCullFrustum();
+
+		const FChunkOcclusionResults* OcclusionResults = nullptr;
 #if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION >= 11
-	bool bIsValid = Target && !Target->IsPendingKillOrUnreachable();
-#else
-	bool bIsValid = Target && !Target->HasAnyFlags(RF_PendingKill | RF_Unreachable);
+		if (ShadowFrustum == nullptr && !View->bIgnoreExistingQueries)
+		{
+			OcclusionResults = ChunkOcclusionResults.Find(View->GetViewKey());
+			if (OcclusionResults && (OcclusionResults->FrameNumber != GFrameNumberRenderThread || OcclusionResults->IsOccluded.Num() != ChunkTree.GetNumChunks()))
+			{
+				OcclusionResults = nullptr;
+			}
+		}
 #endif
 
-	if (bIsValid)
-	{
-		FScopeCycleCounterUObject ActorScope(Target);
-		Target->BakeCollision();
-	}
-}
+		// The shadow frustum is in translated world space
+		const FMatrix& LocalToWorld = GetLocalToWorld();
+		const FConvexVolume& Frustum = ShadowFrustum ? *ShadowFrustum : View->ViewFrustum;
+		const FMatrix FrustumLocalToWorld = ShadowFrustum ? LocalToWorld * FTranslationMatrix(View->GetPreShadowTranslation()) : LocalToWorld;
+		int32 NumChunksOccluded = 0;
 
-FString FRuntimeMeshComponentPrePhysicsTickFunction::DiagnosticMessage()
-{
-	return Target->GetFullName() + TEXT("[PrePhysicsTick]");
-}
+		const int32 NumChunksCulled = ChunkTree.ForEachChunkInFrustum(Frustum, FrustumLocalToWorld, [&](int32 ChunkIndex, bool bFullyContained)
+		{
+			if (OcclusionResults && OcclusionResults->IsOccluded[ChunkIndex])
+			{
+				NumChunksOccluded++;
+				return;
+			}
+
+			const int32* ChunkSections = ChunkTree.GetChunkSections(ChunkIndex);
+			for (int32 Index = 0; Index < ChunkTree.GetChunkNumSections(ChunkIndex); Index++)
+			{
+				const int32 SectionIndex = ChunkSections[Index];
+				FRuntimeMeshSectionProxyInterface* Section = Sections[SectionIndex];
+				if (Section == nullptr || !Section->GetCullingBoundingBox().IsValid)
+				{
+					// Sections that have lost their bounds since the tree was fit can't be culled
+					OutVisibleSections[SectionIndex] = Section != nullptr;
+					continue;
+				}
 
+				// Chunks entirely inside the frustum only need the draw distance checked
+				const FBox& SectionBounds = SectionWorldBounds[SectionIndex];
+				OutVisibleSections[SectionIndex] = bFullyContained ? 
+					IsSectionInDrawDistance(Section, SectionBounds, View) : 
+					IsSectionVisibleInView(Section, SectionBounds, View);
+			}
+		});
 
+		INC_DWORD_STAT_BY(STAT_RuntimeMesh_ChunksCulled, NumChunksCulled);
+		INC_DWORD_STAT_BY(STAT_RuntimeMesh_ChunksOccluded, NumChunksOccluded);
+	}
 
-/* Helper for converting an array of FLinearColor to an array of FColors*/
-void ConvertLinearColorToFColor(const TArray<FLinearColor>& LinearColors, TArray<FColor>& Colors)
-{
-	Colors.SetNumUninitialized(LinearColors.Num());
-	for (int32 Index = 0; Index < LinearColors.Num(); Index++)
+#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION >= 11
+	virtual bool HasSubprimitiveOcclusionQueries() const override
 	{
-		Colors[Index] = LinearColors[Index].ToFColor(false);
+		return bUseSpatialChunks;
 	}
-}
 
+	virtual const TArray<FBoxSphereBounds>* GetOcclusionQueries(const FSceneView* View) const override
+	{
+		if (!bUseSpatialChunks || Sections.Num() <= 1)
+		{
+			return nullptr;
+		}
 
+		UpdateChunkTree();
 
+		// With a single chunk the component's own occlusion query covers it
+		if (ChunkTree.GetNumChunks() <= 1)
+		{
+			return nullptr;
+		}
 
-URuntimeMeshComponent::URuntimeMeshComponent(const FObjectInitializer& ObjectInitializer)
-	: Super(ObjectInitializer)
-	, bUseComplexAsSimpleCollision(true)
-	, bShouldSerializeMeshData(true)
-	, bCollisionDirty(true)
-{
-	// Setup the collision update ticker
-	PrePhysicsTick.TickGroup = TG_PrePhysics;
-	PrePhysicsTick.bCanEverTick = true;
-	PrePhysicsTick.bStartWithTickEnabled = true;
+		if (bAreChunkOcclusionBoundsStale)
+		{
+			const FMatrix& LocalToWorld = GetLocalToWorld();
 
-	// Reset the batch state
-	BatchState.ResetBatch();
+			ChunkOcclusionBounds.SetNum(ChunkTree.GetNumChunks());
+			for (int32 ChunkIndex = 0; ChunkIndex < ChunkTree.GetNumChunks(); ChunkIndex++)
+			{
+				const FBox& ChunkBounds = ChunkTree.GetChunkBounds(ChunkIndex);
+				ChunkOcclusionBounds[ChunkIndex] = ChunkBounds.IsValid ? FBoxSphereBounds(ChunkBounds.TransformBy(LocalToWorld)) : FBoxSphereBounds(ForceInit);
+			}
+			bAreChunkOcclusionBoundsStale = false;
+		}
 
-	SetNetAddressable();
-}
+		return &ChunkOcclusionBounds;
+	}
 
-TSharedPtr<FRuntimeMeshSectionInterface> URuntimeMeshComponent::CreateOrResetSectionInternalType(int32 SectionIndex, int32 NumUVChannels, bool WantsHalfPrecsionUVs)
-{
-	switch (NumUVChannels)
+	virtual void AcceptOcclusionResults(const FSceneView* View, TArray<bool>* Results, int32 ResultsStart, int32 NumResults) override
 	{
-	case 1:
-		if (WantsHalfPrecsionUVs)
+		// Results lag the queries by a frame, so ones arriving straight after a rebuild may be for the old chunks
+		if (Results == nullptr || NumResults != ChunkTree.GetNumChunks() || GFrameNumberRenderThread <= ChunkTreeBuildFrame + 1)
 		{
-			return CreateOrResetSection<FRuntimeMeshSectionInternal<1, true>>(SectionIndex, false, true);
+			return;
 		}
-		else
+
+		const uint32 ViewKey = View->GetViewKey();
+		FChunkOcclusionResults* ViewResults = ChunkOcclusionResults.Find(ViewKey);
+		if (ViewResults == nullptr)
 		{
-			return CreateOrResetSection<FRuntimeMeshSectionInternal<1, false>>(SectionIndex, false, true);
+			// Now is a good time to drop the results of views that have gone away
+			for (auto It = ChunkOcclusionResults.CreateIterator(); It; ++It)
+			{
+				if (It.Value().FrameNumber != GFrameNumberRenderThread)
+				{
+					It.RemoveCurrent();
+				}
+			}
+			ViewResults = &ChunkOcclusionResults.Add(ViewKey);
 		}
-		break;
-	case 2:
-		if (WantsHalfPrecsionUVs)
+
+		ViewResults->FrameNumber = GFrameNumberRenderThread;
+		ViewResults->IsOccluded.Init(false, NumResults);
+		for (int32 Index = 0; Index < NumResults; Index++)
 		{
-			return CreateOrResetSection<FRuntimeMeshSectionInternal<2, true>>(SectionIndex, false, true);
+			ViewResults->IsOccluded[Index] = (*Results)[ResultsStart + Index];
 		}
-		else
+	}
+#endif
+
+	virtual void OnTransformChanged() override
+	{
+		FPrimitiveSceneProxy::OnTransformChanged();
+
+		// The chunk tree is in local space, only the world bounds given to the occlusion queries have moved
+		bAreChunkOcclusionBoundsStale = true;
+
+		for (int32 SectionIndex = 0; SectionIndex < Sections.Num(); SectionIndex++)
 		{
-			return CreateOrResetSection<FRuntimeMeshSectionInternal<2, false>>(SectionIndex, false, true);
+			UpdateSectionWorldBounds(SectionIndex);
 		}
-		break;
+	}
+
+	/* 
+	 *	Brings the cached world bounds of a section up to date. Kept on every change to the section or transform, 
+	 *	rather than worked out when culling, as culling transforms them for every view and static batch each frame.
+	 */
+	void UpdateSectionWorldBounds(int32 SectionIndex)
+	{
+		if (SectionWorldBounds.Num() != Sections.Num())
+		{
+			SectionWorldBounds.SetNumZeroed(Sections.Num());
+		}
+
+		FRuntimeMeshSectionProxyInterface* Section = Sections[SectionIndex];
+		SectionWorldBounds[SectionIndex] = Section && Section->GetCullingBoundingBox().IsValid ? 
+			Section->GetCullingBoundingBox().TransformBy(GetLocalToWorld()) : FBox(0);
+
+		if (Section)
+		{
+			Section->UpdateInstanceWorldBounds(GetLocalToWorld());
+		}
+	}
+
+	virtual bool CanBeOccluded() const override
+	{
+		return !MaterialRelevance.bDisableDepthTest;
+	}
+
+	virtual uint32 GetMemoryFootprint(void) const
+	{
+		return(sizeof(*this) + GetAllocatedSize());
+	}
+
+	uint32 GetAllocatedSize(void) const
+	{
+		return(FPrimitiveSceneProxy::GetAllocatedSize());
+	}
+
+	/* Counts a new section, and combines its material relevance into the proxies */
+	void AddSectionRelevance(FRuntimeMeshSectionProxyInterface* Section)
+	{
+		if (Section->WantsToRenderInStaticPath())
+		{
+			NumStaticSections++;
+		}
+		else
+		{
+			NumDynamicSections++;
+		}
+
+		MaterialRelevance |= Section->GetMaterialRelevance();
+	}
+
+	/* Stops counting a section. Its material relevance can't be taken back out, so it's rebuilt by the next UpdateMaterialRelevance() */
+	void RemoveSectionRelevance(FRuntimeMeshSectionProxyInterface* Section)
+	{
+		if (Section->WantsToRenderInStaticPath())
+		{
+			NumStaticSections--;
+		}
+		else
+		{
+			NumDynamicSections--;
+		}
+		check(NumStaticSections >= 0 && NumDynamicSections >= 0);
+
+		bIsMaterialRelevanceStale = true;
+	}
+
+	/* Rebuilds the material relevance from all sections, only if a section has been removed since it was last built */
+	void UpdateMaterialRelevance()
+	{
+		if (!bIsMaterialRelevanceStale)
+		{
+			return;
+		}
+		bIsMaterialRelevanceStale = false;
+
+		FMaterialRelevance NewMaterialRelevance;
+		for (FRuntimeMeshSectionProxyInterface* Section : Sections)
+		{
+			if (Section)
+			{
+				NewMaterialRelevance |= Section->GetMaterialRelevance();
+			}
+		}
+		MaterialRelevance = NewMaterialRelevance;
+	}
+
+private:
+	/** Array of sections */
+	TArray<FRuntimeMeshSectionProxyInterface*> Sections;
+
+	/** World bounds of each section to cull it by. Invalid for sections that can't be culled */
+	TArray<FBox> SectionWorldBounds;
+
+	/** Should sections be culled against each view on their own, instead of only as part of the whole component */
+	const bool bCullSectionsIndividually;
+
+	/** Should sections be grouped into chunks, culled and occlusion tested together */
+	const bool bUseSpatialChunks;
+
+	/** Most sections grouped into one chunk */
+	const int32 MaxSectionsPerChunk;
+
+	/** Screen size below which each LOD is drawn */
+	const TArray<float> LODScreenSizes;
+
+	/** Should static sections dither between LODs */
+	const bool bDitheredLODTransitions;
+
+	/** Should static sections sharing a material and vertex layout be drawn as one batch */
+	const bool bMergeStaticSections;
+
+	/** Most sections merged into one batch, limited by the size of the element visibility mask */
+	static const int32 MaxMergedElements = 64;
+
+	/** Number of sections drawn through the static path, and through the dynamic path */
+	int32 NumStaticSections;
+	int32 NumDynamicSections;
+
+	/** Material relevance of all sections combined */
+	FMaterialRelevance MaterialRelevance;
+
+	/** Has a section been removed since the material relevance was combined */
+	bool bIsMaterialRelevanceStale;
+
+	/** Chunks of nearby sections. Brought up to date lazily when next culled, as sections can change many times a frame */
+	mutable FRuntimeMeshChunkTree ChunkTree;
+
+	/** Have sections come or gone since the chunk tree was built, or moved since it was last fit */
+	mutable bool bIsChunkTreeStale;
+	mutable bool bAreChunkBoundsStale;
+
+	/** World bounds of each chunk given to the occlusion queries */
+	mutable TArray<FBoxSphereBounds> ChunkOcclusionBounds;
+	mutable bool bAreChunkOcclusionBoundsStale;
+
+	/** Frame the chunk tree was last rebuilt in */
+	mutable uint32 ChunkTreeBuildFrame;
+
+	struct FChunkOcclusionResults
+	{
+		/** Was each chunk occluded in the view */
+		TBitArray<> IsOccluded;
+
+		/** Frame these results were accepted in, they're only good for that frame */
+		uint32 FrameNumber;
+	};
+
+	/** Last occlusion results of each chunk, by view */
+	mutable TMap<uint32, FChunkOcclusionResults> ChunkOcclusionResults;
+};
+
+
+
+
+void FRuntimeMeshComponentPrePhysicsTickFunction::ExecuteTick( float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	/* Ensure target still exists */
+
+#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION >= 11
+	bool bIsValid = Target && !Target->IsPendingKillOrUnreachable();
+#else
+	bool bIsValid = Target && !Target->HasAnyFlags(RF_PendingKill | RF_Unreachable);
+#endif
+
+	if (bIsValid)
+	{
+		FScopeCycleCounterUObject ActorScope(Target);
+		Target->BakeCollision();
+	}
+}
+
+FString FRuntimeMeshComponentPrePhysicsTickFunction::DiagnosticMessage()
+{
+	return Target->GetFullName() + TEXT("[PrePhysicsTick]");
+}
+
+void FRuntimeMeshComponentBatchUpdateTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	/* Ensure target still exists */
+
+#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION >= 11
+	bool bIsValid = Target && !Target->IsPendingKillOrUnreachable();
+#else
+	bool bIsValid = Target && !Target->HasAnyFlags(RF_PendingKill | RF_Unreachable);
+#endif
+
+	if (bIsValid)
+	{
+		FScopeCycleCounterUObject ActorScope(Target);
+		Target->FlushDeferredUpdates();
+	}
+}
+
+FString FRuntimeMeshComponentBatchUpdateTickFunction::DiagnosticMessage()
+{
+	return Target->GetFullName() + TEXT("[BatchUpdateTick]");
+}
+
+
+
+/* Helper for converting an array of FLinearColor to an array of FColors*/
+void ConvertLinearColorToFColor(const TArray<FLinearColor>& LinearColors, TArray<FColor>& Colors)
+{
+	Colors.SetNumUninitialized(LinearColors.Num());
+	for (int32 Index = 0; Index < LinearColors.Num(); Index++)
+	{
+		Colors[Index] = LinearColors[Index].ToFColor(false);
+	}
+}
+
+
+
+
+URuntimeMeshComponent::URuntimeMeshComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, bUseComplexAsSimpleCollision(true)
+	, bUseAsyncCooking(false)
+	, bUseSectionCollisionBodies(false)
+	, bUseCollisionCache(false)
+	, bShouldSerializeMeshData(true)
+	, bUseSharedBufferPool(false)
+	, bAutoBatchUpdates(false)
+	, bUseUploadScheduler(false)
+	, UploadPriority(0)
+	, bCullSectionsIndividually(true)
+	, bUseSpatialChunks(false)
+	, MaxSectionsPerChunk(16)
+	, bDitheredLODTransitions(false)
+	, bMergeStaticSections(false)
+	, SynchronousCollisionCook(nullptr)
+	, bCollisionDirty(true)
+	, bIsBodySetupDirty(true)
+	, bAreAllCollisionBodiesDirty(false)
+	, LocalBox(0)
+	, bIsLocalBoundsRebuildPending(false)
+	, bIsRenderTransformUpdatePending(false)
+{
+	// Setup the collision update ticker
+	PrePhysicsTick.TickGroup = TG_PrePhysics;
+	PrePhysicsTick.bCanEverTick = true;
+	PrePhysicsTick.bStartWithTickEnabled = true;
+
+	// Setup the automatic batch and deferred bounds ticker. This runs after everything else that ticks in the frame.
+	BatchUpdateTick.TickGroup = TG_LastDemotable;
+	BatchUpdateTick.bCanEverTick = true;
+	BatchUpdateTick.bStartWithTickEnabled = false;
+
+	// Reset the batch state
+	BatchState.ResetBatch();
+
+	SetNetAddressable();
+}
+
+TSharedPtr<FRuntimeMeshSectionInterface> URuntimeMeshComponent::CreateOrResetSectionInternalType(int32 SectionIndex, int32 NumUVChannels, bool WantsHalfPrecsionUVs)
+{
+	switch (NumUVChannels)
+	{
+	case 1:
+		if (WantsHalfPrecsionUVs)
+		{
+			return CreateOrResetSection<FRuntimeMeshSectionInternal<1, true>>(SectionIndex, false, true);
+		}
+		else
+		{
+			return CreateOrResetSection<FRuntimeMeshSectionInternal<1, false>>(SectionIndex, false, true);
+		}
+		break;
+	case 2:
+		if (WantsHalfPrecsionUVs)
+		{
+			return CreateOrResetSection<FRuntimeMeshSectionInternal<2, true>>(SectionIndex, false, true);
+		}
+		else
+		{
+			return CreateOrResetSection<FRuntimeMeshSectionInternal<2, false>>(SectionIndex, false, true);
+		}
+		break;
 	case 3:
 		if (WantsHalfPrecsionUVs)
 		{
@@ -537,15 +1212,19 @@ void URuntimeMeshComponent::CreateSectionInternal(int32 SectionIndex, ESectionUp
 		Section->GenerateTessellationIndices();
 	}
 
+	// The section replaced by this one was already flagged if it had collision
+	const bool bAffectsCollision = Section->CollisionEnabled || SectionsWithDirtyCollision.Contains(SectionIndex);
+
 	// Use the batch update if one is running
-	if (BatchState.IsBatchPending())
+	if (ShouldBatchUpdate())
 	{
 		// Mark section created
 		BatchState.MarkSectionCreated(SectionIndex, Section->UpdateFrequency == EUpdateFrequency::Infrequent);
 
 		// Flag collision if this section affects it
-		if (Section->CollisionEnabled)
+		if (bAffectsCollision)
 		{
+			SectionsWithDirtyCollision.Add(SectionIndex);
 			BatchState.MarkCollisionDirty();
 		}
 		
@@ -559,19 +1238,14 @@ void URuntimeMeshComponent::CreateSectionInternal(int32 SectionIndex, ESectionUp
 	// Enqueue the RT command if we already have a SceneProxy
 	if (SceneProxy && Section->UpdateFrequency != EUpdateFrequency::Infrequent)
 	{
-		// Gather all needed update info
-		auto* SectionData = Section->GetSectionCreationData(GetScene(), GetSectionMaterial(SectionIndex));
-		SectionData->SetTargetSection(SectionIndex);
-
-		// Enqueue update on RT
-		ENQUEUE_UNIQUE_RENDER_COMMAND_TWOPARAMETER(
-			FRuntimeMeshSectionCreate,
-			FRuntimeMeshSceneProxy*, RuntimeMeshSceneProxy, (FRuntimeMeshSceneProxy*)SceneProxy,
-			FRuntimeMeshSectionCreateDataInterface*, SectionData, SectionData,
-			{
-				RuntimeMeshSceneProxy->CreateSection_RenderThread(SectionData);
-			}
-		);
+		if (ShouldScheduleUpload(SectionIndex))
+		{
+			FRuntimeMeshUploadScheduler::Get().Schedule(this, SectionIndex, ERuntimeMeshSectionBatchUpdateType::Create);
+		}
+		else
+		{
+			SendSectionCreate(SectionIndex);
+		}
 	}
 	else
 	{
@@ -580,17 +1254,73 @@ void URuntimeMeshComponent::CreateSectionInternal(int32 SectionIndex, ESectionUp
 	}
 
 	// Mark collision dirty so it's re-baked at the end of this frame
-	if (Section->CollisionEnabled)
+	if (bAffectsCollision)
 	{
+		SectionsWithDirtyCollision.Add(SectionIndex);
 		MarkCollisionDirty();
 	}
 
 	// Update overall bounds
-	UpdateLocalBounds();
+	UpdateLocalBoundsForSection(SectionIndex, false);
+
+}
+
+void URuntimeMeshComponent::FinishCreateSectionAsync(int32 SectionIndex, FRuntimeMeshSectionInterface* NewSection, bool bIsValid,
+	const TSharedPtr<FRuntimeMeshAsyncSectionState, ESPMode::ThreadSafe>& State, ESectionUpdateFlags UpdateFlags)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_FinishCreateSectionAsync);
+
+	RuntimeMeshSectionPtr Section = MakeShareable(NewSection);
+
+	// Drop the result if the section was replaced or cleared while it was being built
+	auto* PendingState = PendingAsyncSections.Find(SectionIndex);
+	if (PendingState == nullptr || *PendingState != State)
+	{
+		return;
+	}
+	PendingAsyncSections.Remove(SectionIndex);
+
+	if (!bIsValid)
+	{
+		Log(TEXT("CreateMeshSectionAsync() - Generator must supply both vertices and triangles."), true);
+		return;
+	}
+
+	// Ensure sections array is long enough
+	if (SectionIndex >= MeshSections.Num())
+	{
+		MeshSections.SetNum(SectionIndex + 1, false);
+	}
+
+	// Replacing a section can shrink the bounds
+	if (MeshSections[SectionIndex].IsValid())
+	{
+		bIsLocalBoundsRebuildPending = true;
+
+		// The old section's collision has to go, even if the new section has none
+		if (MeshSections[SectionIndex]->CollisionEnabled)
+		{
+			SectionsWithDirtyCollision.Add(SectionIndex);
+		}
+	}
 
+	Section->bUseSharedBufferPool = bUseSharedBufferPool;
+	MeshSections[SectionIndex] = Section;
+
+	// Normals/tangents and tessellation indices were already generated on the worker
+	CreateSectionInternal(SectionIndex, UpdateFlags & ~(ESectionUpdateFlags::CalculateNormalTangent | ESectionUpdateFlags::CalculateTessellationIndices));
+}
+
+void URuntimeMeshComponent::CancelAsyncSection(int32 SectionIndex)
+{
+	TSharedPtr<FRuntimeMeshAsyncSectionState, ESPMode::ThreadSafe> State;
+	if (PendingAsyncSections.RemoveAndCopyValue(SectionIndex, State))
+	{
+		State->bIsCancelled = true;
+	}
 }
 
-void URuntimeMeshComponent::UpdateSectionInternal(int32 SectionIndex, bool bHadVertexPositionsUpdate, bool bHadVertexUpdates, bool bHadIndexUpdates, bool bNeedsBoundsUpdate, ESectionUpdateFlags UpdateFlags)
+void URuntimeMeshComponent::UpdateSectionInternal(int32 SectionIndex, bool bHadVertexPositionsUpdate, bool bHadVertexUpdates, bool bHadIndexUpdates, bool bNeedsBoundsUpdate, ESectionUpdateFlags UpdateFlags, bool bIsRangeUpdate)
 {
 	// Ensure that something was updated
 	check(bHadVertexPositionsUpdate || bHadVertexUpdates || bHadIndexUpdates || bNeedsBoundsUpdate);
@@ -598,27 +1328,45 @@ void URuntimeMeshComponent::UpdateSectionInternal(int32 SectionIndex, bool bHadV
 	check(SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid());	
 	RuntimeMeshSectionPtr Section = MeshSections[SectionIndex];
 	
+	// Full updates replace any ranges tracked so far
+	if (!bIsRangeUpdate)
+	{
+		if (bHadVertexUpdates)
+		{
+			Section->DirtyVertexSpans.MarkAllDirty();
+		}
+		if (bHadIndexUpdates)
+		{
+			Section->DirtyIndexSpans.MarkAllDirty();
+		}
+	}
+
 	// Update normal/tangents if requested...
 	if (!!(UpdateFlags & ESectionUpdateFlags::CalculateNormalTangent))
 	{
 		Section->GenerateNormalTangent();
+		Section->DirtyVertexSpans.MarkAllDirty();
 	}
 
 	// calculate tessellation if requested...
 	if (!!(UpdateFlags & ESectionUpdateFlags::CalculateTessellationIndices))
 	{
 		Section->GenerateTessellationIndices();
+		Section->DirtyIndexSpans.MarkAllDirty();
 	}
 
 	/* Make sure this is only flagged if the section is dual buffer */
 	bHadVertexPositionsUpdate = Section->IsDualBufferSection() && bHadVertexPositionsUpdate;
 	bool bNeedsCollisionUpdate = Section->CollisionEnabled && (bHadVertexPositionsUpdate || (!Section->IsDualBufferSection() && bHadVertexUpdates));
+
+	// Static sections keeping the same counts are rewritten in place, the static draw lists don't need rebuilding for that
+	bool bRequiresRecreate = Section->UpdateFrequency == EUpdateFrequency::Infrequent && !Section->CanUpdateStaticDrawInPlace();
 	
 	// Use the batch update if one is running
-	if (BatchState.IsBatchPending())
+	if (ShouldBatchUpdate())
 	{
-		// Mark update for section or promote to proxy recreate if static section
-		if (Section->UpdateFrequency == EUpdateFrequency::Infrequent)
+		// Mark update for section or promote to proxy recreate if static section that can't be updated in place
+		if (bRequiresRecreate)
 		{
 			BatchState.MarkRenderStateDirty();
 		}
@@ -635,6 +1383,7 @@ void URuntimeMeshComponent::UpdateSectionInternal(int32 SectionIndex, bool bHadV
 		// Flag collision if this section affects it
 		if (bNeedsCollisionUpdate)
 		{
+			SectionsWithDirtyCollision.Add(SectionIndex);
 			BatchState.MarkCollisionDirty();
 		}
 
@@ -650,21 +1399,109 @@ void URuntimeMeshComponent::UpdateSectionInternal(int32 SectionIndex, bool bHadV
 
 
 	// Send the update to the render thread if the scene proxy exists
-	if (SceneProxy && Section->UpdateFrequency != EUpdateFrequency::Infrequent)
+	if (SceneProxy && !bRequiresRecreate)
 	{
-		auto* SectionData = Section->GetSectionUpdateData(bHadVertexPositionsUpdate, bHadVertexUpdates, bHadIndexUpdates);
-		SectionData->SetTargetSection(SectionIndex);
+		if (ShouldScheduleUpload(SectionIndex))
+		{
+			ERuntimeMeshSectionBatchUpdateType UpdateType = ERuntimeMeshSectionBatchUpdateType::None;
+			UpdateType |= bHadVertexPositionsUpdate ? ERuntimeMeshSectionBatchUpdateType::PositionsUpdate : ERuntimeMeshSectionBatchUpdateType::None;
+			UpdateType |= bHadVertexUpdates ? ERuntimeMeshSectionBatchUpdateType::VerticesUpdate : ERuntimeMeshSectionBatchUpdateType::None;
+			UpdateType |= bHadIndexUpdates ? ERuntimeMeshSectionBatchUpdateType::IndicesUpdate : ERuntimeMeshSectionBatchUpdateType::None;
 
-		// Enqueue update on RT
-		ENQUEUE_UNIQUE_RENDER_COMMAND_TWOPARAMETER(
-			FRuntimeMeshSectionUpdate,
-			FRuntimeMeshSceneProxy*, RuntimeMeshSceneProxy, (FRuntimeMeshSceneProxy*)SceneProxy,
-			FRuntimeMeshRenderThreadCommandInterface*, SectionData, SectionData,
-			{
-				RuntimeMeshSceneProxy->UpdateSection_RenderThread(SectionData);
-			}
-		);
-	}
+			FRuntimeMeshUploadScheduler::Get().Schedule(this, SectionIndex, UpdateType);
+		}
+		else
+		{
+			SendSectionUpdate(SectionIndex, bHadVertexPositionsUpdate, bHadVertexUpdates, bHadIndexUpdates);
+		}
+	}
+	else
+	{
+		// Mark the renderstate dirty so it's recreated when necessary.
+		MarkRenderStateDirty();
+	}
+
+	// Mark collision dirty so it's re-baked at the end of this frame
+	if (bNeedsCollisionUpdate)
+	{
+		SectionsWithDirtyCollision.Add(SectionIndex);
+		MarkCollisionDirty();
+	}
+
+	// Update overall bounds if needed
+	if (bNeedsBoundsUpdate)
+	{
+		UpdateLocalBoundsForSection(SectionIndex, true);
+	}
+}
+
+void URuntimeMeshComponent::UpdateSectionStreamsInternal(int32 SectionIndex, ERuntimeMeshVertexStream Streams, bool bNeedsBoundsUpdate, ESectionUpdateFlags UpdateFlags)
+{
+	check(SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid());
+	RuntimeMeshSectionPtr Section = MeshSections[SectionIndex];
+
+	// Update normal/tangents if requested, which has to send the tangents as well
+	if (!!(UpdateFlags & ESectionUpdateFlags::CalculateNormalTangent))
+	{
+		Section->GenerateNormalTangent();
+		Streams |= ERuntimeMeshVertexStream::Tangents;
+	}
+
+	bool bNeedsCollisionUpdate = Section->CollisionEnabled && !Section->IsDualBufferSection() && !!(Streams & ERuntimeMeshVertexStream::Position);
+
+	// Streams the section doesn't separate still live in the interleaved buffer, so the whole vertex has to be sent
+	bool bNeedsFullUpdate = (Streams & Section->SeparateStreams) != Streams;
+
+	// Static sections keeping the same counts are rewritten in place, the static draw lists don't need rebuilding for that
+	bool bRequiresRecreate = Section->UpdateFrequency == EUpdateFrequency::Infrequent && !Section->CanUpdateStaticDrawInPlace();
+
+	// Use the batch update if one is running
+	if (ShouldBatchUpdate())
+	{
+		// Mark update for section or promote to proxy recreate if static section that can't be updated in place
+		if (bRequiresRecreate)
+		{
+			BatchState.MarkRenderStateDirty();
+		}
+		else
+		{
+			BatchState.MarkUpdateForSection(SectionIndex, bNeedsFullUpdate ? ERuntimeMeshSectionBatchUpdateType::VerticesUpdate : ERuntimeMeshSectionBatchUpdateType::StreamsUpdate);
+		}
+
+		// Flag collision if this section affects it
+		if (bNeedsCollisionUpdate)
+		{
+			SectionsWithDirtyCollision.Add(SectionIndex);
+			BatchState.MarkCollisionDirty();
+		}
+
+		// Flag bounds update if needed.
+		if (bNeedsBoundsUpdate)
+		{
+			BatchState.MarkBoundsDirty();
+		}
+
+		// bail since we don't update directly in this case.
+		return;
+	}
+
+	// Send the update to the render thread if the scene proxy exists
+	if (SceneProxy && !bRequiresRecreate)
+	{
+		if (ShouldScheduleUpload(SectionIndex))
+		{
+			FRuntimeMeshUploadScheduler::Get().Schedule(this, SectionIndex, 
+				bNeedsFullUpdate ? ERuntimeMeshSectionBatchUpdateType::VerticesUpdate : ERuntimeMeshSectionBatchUpdateType::StreamsUpdate);
+		}
+		else if (bNeedsFullUpdate)
+		{
+			SendSectionUpdate(SectionIndex, false, true, false);
+		}
+		else
+		{
+			SendSectionStreamUpdate(SectionIndex, Streams);
+		}
+	}
 	else
 	{
 		// Mark the renderstate dirty so it's recreated when necessary.
@@ -674,13 +1511,14 @@ void URuntimeMeshComponent::UpdateSectionInternal(int32 SectionIndex, bool bHadV
 	// Mark collision dirty so it's re-baked at the end of this frame
 	if (bNeedsCollisionUpdate)
 	{
+		SectionsWithDirtyCollision.Add(SectionIndex);
 		MarkCollisionDirty();
 	}
 
 	// Update overall bounds if needed
 	if (bNeedsBoundsUpdate)
 	{
-		UpdateLocalBounds();
+		UpdateLocalBoundsForSection(SectionIndex, true);
 	}
 }
 
@@ -689,7 +1527,12 @@ void URuntimeMeshComponent::UpdateSectionVertexPositionsInternal(int32 SectionIn
 	check(SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid());
 	RuntimeMeshSectionPtr Section = MeshSections[SectionIndex];
 
-	if (SceneProxy)
+	// Fold the positions into an upload that's still waiting, so they can't be overwritten when it's sent
+	if (SceneProxy && FRuntimeMeshUploadScheduler::Get().IsScheduled(this, SectionIndex))
+	{
+		FRuntimeMeshUploadScheduler::Get().Schedule(this, SectionIndex, ERuntimeMeshSectionBatchUpdateType::PositionsUpdate);
+	}
+	else if (SceneProxy)
 	{
 		auto SectionData = Section->GetSectionPositionUpdateData();
 		SectionData->SetTargetSection(SectionIndex);
@@ -711,7 +1554,7 @@ void URuntimeMeshComponent::UpdateSectionVertexPositionsInternal(int32 SectionIn
 
 	if (bNeedsBoundsUpdate)
 	{
-		UpdateLocalBounds();
+		UpdateLocalBoundsForSection(SectionIndex, true);
 	}
 }
 
@@ -723,7 +1566,7 @@ void URuntimeMeshComponent::UpdateSectionPropertiesInternal(int32 SectionIndex,
 	bool bRequiresRecreate = bUpdateRequiresProxyRecreateIfStatic && Section->UpdateFrequency == EUpdateFrequency::Infrequent;
 
 	// Use the batch update if one is running
-	if (BatchState.IsBatchPending())
+	if (ShouldBatchUpdate())
 	{
 		if (bRequiresRecreate)
 		{
@@ -742,10 +1585,12 @@ void URuntimeMeshComponent::UpdateSectionPropertiesInternal(int32 SectionIndex,
 
 	if (SceneProxy && !bRequiresRecreate)
 	{
-		auto SectionData = new FRuntimeMeshSectionPropertyUpdateData();
+		auto SectionData = TRuntimeMeshCommandPool<FRuntimeMeshSectionPropertyUpdateData>::Allocate();
 		SectionData->SetTargetSection(SectionIndex);
 		SectionData->bIsVisible = Section->bIsVisible;
 		SectionData->bCastsShadow = Section->bCastsShadow;
+		SectionData->MaxDrawDistance = Section->MaxDrawDistance;
+		SectionData->LODIndex = Section->LODIndex;
 
 
 		// Enqueue command to modify render thread info
@@ -765,6 +1610,72 @@ void URuntimeMeshComponent::UpdateSectionPropertiesInternal(int32 SectionIndex,
 }
 
 
+void URuntimeMeshComponent::UpdateSectionInstancesInternal(int32 SectionIndex, bool bInstancingChanged)
+{
+	check(SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid());
+	RuntimeMeshSectionPtr Section = MeshSections[SectionIndex];
+
+	// Static sections move between the static and dynamic paths when instancing is turned on or off
+	bool bRequiresRecreate = bInstancingChanged && Section->UpdateFrequency == EUpdateFrequency::Infrequent;
+
+	// Instanced sections don't have collision
+	bool bNeedsCollisionUpdate = bInstancingChanged && Section->CollisionEnabled;
+
+	// Use the batch update if one is running
+	if (ShouldBatchUpdate())
+	{
+		if (bRequiresRecreate)
+		{
+			BatchState.MarkRenderStateDirty();
+		}
+		else
+		{
+			BatchState.MarkUpdateForSection(SectionIndex, ERuntimeMeshSectionBatchUpdateType::InstancesUpdate);
+		}
+
+		if (bNeedsCollisionUpdate)
+		{
+			SectionsWithDirtyCollision.Add(SectionIndex);
+			BatchState.MarkCollisionDirty();
+		}
+
+		BatchState.MarkBoundsDirty();
+
+		// bail since we don't update directly in this case.
+		return;
+	}
+
+	if (SceneProxy && !bRequiresRecreate)
+	{
+		auto SectionData = TRuntimeMeshCommandPool<FRuntimeMeshSectionInstanceUpdateData>::Allocate();
+		SectionData->SetTargetSection(SectionIndex);
+		SectionData->bIsInstanced = Section->bIsInstanced;
+		Section->GetInstanceMatrices(SectionData->InstanceTransforms);
+
+		// Enqueue command to modify render thread info
+		ENQUEUE_UNIQUE_RENDER_COMMAND_TWOPARAMETER(
+			FRuntimeMeshSectionInstanceUpdate,
+			FRuntimeMeshSceneProxy*, RuntimeMeshSceneProxy, (FRuntimeMeshSceneProxy*)SceneProxy,
+			FRuntimeMeshRenderThreadCommandInterface*, SectionData, SectionData,
+			{
+				RuntimeMeshSceneProxy->UpdateSectionInstances_RenderThread(SectionData);
+			}
+		);
+	}
+	else
+	{
+		MarkRenderStateDirty();
+	}
+
+	if (bNeedsCollisionUpdate)
+	{
+		SectionsWithDirtyCollision.Add(SectionIndex);
+		MarkCollisionDirty();
+	}
+
+	UpdateLocalBoundsForSection(SectionIndex, true);
+}
+
 void URuntimeMeshComponent::UpdateMeshSectionPositionsImmediate(int32 SectionIndex, TArray<FVector>& VertexPositions, ESectionUpdateFlags UpdateFlags)
 {
 	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_UpdateMeshSectionPositionsImmediate);
@@ -843,6 +1754,24 @@ void URuntimeMeshComponent::UpdateMeshSectionPositionsImmediate(int32 SectionInd
 	}
 }
 
+void URuntimeMeshComponent::UpdateMeshSectionTrianglesRange(int32 SectionIndex, int32 FirstIndex, const TArray<int32>& Triangles, ESectionUpdateFlags UpdateFlags)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_UpdateMeshSectionTrianglesRange);
+
+	// Validate all update parameters
+	RMC_VALIDATE_UPDATEPARAMETERS(SectionIndex, /*VoidReturn*/);
+
+	// Get section
+	RuntimeMeshSectionPtr& Section = MeshSections[SectionIndex];
+
+	// Validate the range
+	RMC_VALIDATE_RANGEPARAMETERS(FirstIndex, Triangles, Section->IndexBuffer.Num(), /*VoidReturn*/);
+
+	Section->UpdateIndexBufferRange(Triangles, FirstIndex);
+
+	// Finalize section update
+	UpdateSectionInternal(SectionIndex, false, false, true, false, UpdateFlags, true);
+}
 
 TArray<FVector>* URuntimeMeshComponent::BeginMeshSectionPositionUpdate(int32 SectionIndex)
 {
@@ -1093,6 +2022,12 @@ void URuntimeMeshComponent::ClearMeshSection(int32 SectionIndex)
 {
 	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_ClearMeshSection);
 
+	// Don't let a section still being built bring this back
+	CancelAsyncSection(SectionIndex);
+
+	// Nothing waiting to be uploaded for this section is needed anymore
+	FRuntimeMeshUploadScheduler::Get().Unschedule(this, SectionIndex);
+
  	if (SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid())
  	{
 		// Did this section have collision
@@ -1103,7 +2038,7 @@ void URuntimeMeshComponent::ClearMeshSection(int32 SectionIndex)
 		MeshSections[SectionIndex].Reset();
 		
 		// Use the batch update if one is running
-		if (BatchState.IsBatchPending())
+		if (ShouldBatchUpdate())
 		{
 			// Mark section created
 			BatchState.MarkSectionDestroyed(SectionIndex, bWasStaticSection);
@@ -1111,6 +2046,7 @@ void URuntimeMeshComponent::ClearMeshSection(int32 SectionIndex)
 			// Flag collision if this section affects it
 			if (HadCollision)
 			{
+				SectionsWithDirtyCollision.Add(SectionIndex);
 				BatchState.MarkCollisionDirty();
 			}
 
@@ -1142,18 +2078,29 @@ void URuntimeMeshComponent::ClearMeshSection(int32 SectionIndex)
 		// Update our collision info only if this section had any influence on it
 		if (HadCollision)
 		{
+			SectionsWithDirtyCollision.Add(SectionIndex);
 			MarkCollisionDirty();
 		}
 		
-		UpdateLocalBounds();
+		UpdateLocalBoundsForSection(SectionIndex, true);
 
  	}
 }
 
 void URuntimeMeshComponent::ClearAllMeshSections()
 {
+	// Don't let sections still being built bring anything back
+	for (auto& PendingSection : PendingAsyncSections)
+	{
+		PendingSection.Value->bIsCancelled = true;
+	}
+	PendingAsyncSections.Empty();
+
  	MeshSections.Empty();
 
+	// Every section collision body has to go
+	bAreAllCollisionBodiesDirty = true;
+
 	// Use the batch update if one is running
 	if (BatchState.IsBatchPending())
 	{
@@ -1209,8 +2156,8 @@ void URuntimeMeshComponent::SetMeshSectionVisible(int32 SectionIndex, bool bNewV
  		// Set game thread state
  		MeshSections[SectionIndex]->bIsVisible = bNewVisibility;
 
-		// Finish the update
-		UpdateSectionPropertiesInternal(SectionIndex, false);
+		// Static batches only check the visibility of their sections when sections are culled or merged
+		UpdateSectionPropertiesInternal(SectionIndex, !bCullSectionsIndividually && !bMergeStaticSections);
  	}
 }
 
@@ -1236,119 +2183,310 @@ bool URuntimeMeshComponent::IsMeshSectionCastingShadows(int32 SectionIndex) cons
 	return SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid() && MeshSections[SectionIndex]->bCastsShadow;
 }
 
-void URuntimeMeshComponent::SetMeshSectionCollisionEnabled(int32 SectionIndex, bool bNewCollisionEnabled)
+void URuntimeMeshComponent::SetMeshSectionMaxDrawDistance(int32 SectionIndex, float NewMaxDrawDistance)
 {
 	if (SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid())
 	{
-		auto& Section = MeshSections[SectionIndex];
-		if (Section->CollisionEnabled != bNewCollisionEnabled)
-		{
-			Section->CollisionEnabled = bNewCollisionEnabled;
-			
-			// Use the batch update if one is running
-			if (BatchState.IsBatchPending())
-			{
-				// Mark render state dirty
-				BatchState.MarkCollisionDirty();
-			}
-			else
-			{
-				MarkCollisionDirty();
-			}
-		}
+		// Set game thread state
+		MeshSections[SectionIndex]->MaxDrawDistance = FMath::Max(NewMaxDrawDistance, 0.0f);
+
+		// Finish the update
+		UpdateSectionPropertiesInternal(SectionIndex, false);
 	}
 }
 
-bool URuntimeMeshComponent::IsMeshSectionCollisionEnabled(int32 SectionIndex)
+float URuntimeMeshComponent::GetMeshSectionMaxDrawDistance(int32 SectionIndex) const
 {
-	return SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid() && MeshSections[SectionIndex]->CollisionEnabled;
+	return SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid() ? MeshSections[SectionIndex]->MaxDrawDistance : 0.0f;
 }
 
-
-
-int32 URuntimeMeshComponent::GetNumSections() const
+void URuntimeMeshComponent::SetMeshSectionLOD(int32 SectionIndex, int32 LODIndex)
 {
-	int32 SectionCount = 0;
-	for (int32 Index = 0; Index < MeshSections.Num(); Index++)
+	if (SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid())
 	{
-		if (MeshSections[Index].IsValid())
-		{
-			SectionCount++;
-		}
-	}
+		// Set game thread state
+		MeshSections[SectionIndex]->LODIndex = FMath::Max(LODIndex, (int32)INDEX_NONE);
 
-	return SectionCount;
+		// Finish the update. Static sections are submitted to the static draw lists per LOD so they need the proxy recreated
+		UpdateSectionPropertiesInternal(SectionIndex, true);
+	}
 }
 
-bool URuntimeMeshComponent::DoesSectionExist(int32 SectionIndex) const
+int32 URuntimeMeshComponent::GetMeshSectionLOD(int32 SectionIndex) const
 {
-	return SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid();
+	return SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid() ? MeshSections[SectionIndex]->LODIndex : INDEX_NONE;
 }
 
-int32 URuntimeMeshComponent::FirstAvailableMeshSectionIndex(int32 SectionIndex) const
+void URuntimeMeshComponent::SetMeshSectionInstanced(int32 SectionIndex, bool bNewInstanced)
 {
-	for (int32 Index = 0; Index < MeshSections.Num(); Index++)
+	if (SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid())
 	{
-		if (!MeshSections[Index].IsValid())
+		RuntimeMeshSectionPtr& Section = MeshSections[SectionIndex];
+		if (Section->bIsInstanced != bNewInstanced)
 		{
-			return Index;
+			// Set game thread state
+			Section->bIsInstanced = bNewInstanced;
+			if (!bNewInstanced)
+			{
+				Section->InstanceTransforms.Empty();
+			}
+
+			// Finish the update
+			UpdateSectionInstancesInternal(SectionIndex, true);
 		}
 	}
-	return MeshSections.Num();
 }
 
+bool URuntimeMeshComponent::IsMeshSectionInstanced(int32 SectionIndex) const
+{
+	return SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid() && MeshSections[SectionIndex]->bIsInstanced;
+}
 
-void URuntimeMeshComponent::SetMeshCollisionSection(int32 CollisionSectionIndex, const TArray<FVector>& Vertices, const TArray<int32>& Triangles)
+int32 URuntimeMeshComponent::AddMeshSectionInstance(int32 SectionIndex, const FTransform& InstanceTransform)
 {
-	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_SetMeshCollisionSection);
+	TArray<FTransform> InstanceTransforms;
+	InstanceTransforms.Add(InstanceTransform);
+	return AddMeshSectionInstances(SectionIndex, InstanceTransforms);
+}
 
-	if (MeshCollisionSections.Num() <= CollisionSectionIndex)
+int32 URuntimeMeshComponent::AddMeshSectionInstances(int32 SectionIndex, const TArray<FTransform>& InstanceTransforms)
+{
+	if (SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid())
 	{
-		MeshCollisionSections.SetNum(CollisionSectionIndex + 1, false);
-	}
+		RuntimeMeshSectionPtr& Section = MeshSections[SectionIndex];
+		const bool bInstancingChanged = !Section->bIsInstanced;
 
-	auto& Section = MeshCollisionSections[CollisionSectionIndex];
-	Section.VertexBuffer = Vertices;
-	Section.IndexBuffer = Triangles;
+		// Set game thread state
+		const int32 FirstInstanceIndex = Section->InstanceTransforms.Num();
+		Section->bIsInstanced = true;
+		Section->InstanceTransforms.Append(InstanceTransforms);
 
-	// Use the batch update if one is running
-	if (BatchState.IsBatchPending())
-	{
-		// Mark render state dirty
-		BatchState.MarkCollisionDirty();
-	}
-	else
-	{
-		MarkCollisionDirty();
+		// Finish the update
+		UpdateSectionInstancesInternal(SectionIndex, bInstancingChanged);
+		return FirstInstanceIndex;
 	}
+	return INDEX_NONE;
 }
 
-void URuntimeMeshComponent::ClearMeshCollisionSection(int32 CollisionSectionIndex)
+bool URuntimeMeshComponent::UpdateMeshSectionInstance(int32 SectionIndex, int32 InstanceIndex, const FTransform& NewInstanceTransform)
 {
-	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_ClearMeshCollisionSection);
-
-	if (MeshCollisionSections.Num() <= CollisionSectionIndex)
-		return;
+	if (SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid() && MeshSections[SectionIndex]->InstanceTransforms.IsValidIndex(InstanceIndex))
+	{
+		// Set game thread state
+		MeshSections[SectionIndex]->InstanceTransforms[InstanceIndex] = NewInstanceTransform;
 
-	MeshCollisionSections[CollisionSectionIndex].Reset();
+		// Finish the update
+		UpdateSectionInstancesInternal(SectionIndex, false);
+		return true;
+	}
+	return false;
+}
 
-	// Use the batch update if one is running
-	if (BatchState.IsBatchPending())
+bool URuntimeMeshComponent::RemoveMeshSectionInstance(int32 SectionIndex, int32 InstanceIndex)
+{
+	if (SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid() && MeshSections[SectionIndex]->InstanceTransforms.IsValidIndex(InstanceIndex))
 	{
-		// Mark render state dirty
-		BatchState.MarkCollisionDirty();
+		// Set game thread state
+		MeshSections[SectionIndex]->InstanceTransforms.RemoveAt(InstanceIndex);
+
+		// Finish the update
+		UpdateSectionInstancesInternal(SectionIndex, false);
+		return true;
 	}
-	else
+	return false;
+}
+
+void URuntimeMeshComponent::ClearMeshSectionInstances(int32 SectionIndex)
+{
+	if (SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid() && MeshSections[SectionIndex]->InstanceTransforms.Num() > 0)
 	{
-		MarkCollisionDirty();
+		// Set game thread state
+		MeshSections[SectionIndex]->InstanceTransforms.Empty();
+
+		// Finish the update
+		UpdateSectionInstancesInternal(SectionIndex, false);
 	}
 }
 
-void URuntimeMeshComponent::ClearAllMeshCollisionSections()
+int32 URuntimeMeshComponent::GetMeshSectionInstanceCount(int32 SectionIndex) const
 {
-	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_ClearAllMeshCollisionSections);
-
-	MeshCollisionSections.Empty();
+	return SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid() ? MeshSections[SectionIndex]->InstanceTransforms.Num() : 0;
+}
+
+bool URuntimeMeshComponent::GetMeshSectionInstanceTransform(int32 SectionIndex, int32 InstanceIndex, FTransform& OutInstanceTransform) const
+{
+	if (SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid() && MeshSections[SectionIndex]->InstanceTransforms.IsValidIndex(InstanceIndex))
+	{
+		OutInstanceTransform = MeshSections[SectionIndex]->InstanceTransforms[InstanceIndex];
+		return true;
+	}
+	return false;
+}
+
+void URuntimeMeshComponent::SetLODScreenSizes(const TArray<float>& NewLODScreenSizes)
+{
+	LODScreenSizes = NewLODScreenSizes;
+
+	// The proxy keeps its own copy
+	if (BatchState.IsBatchPending())
+	{
+		BatchState.MarkRenderStateDirty();
+	}
+	else
+	{
+		MarkRenderStateDirty();
+	}
+}
+
+void URuntimeMeshComponent::SetMeshSectionVertexStreams(int32 SectionIndex, ERuntimeMeshVertexStream Streams)
+{
+	if (SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid())
+	{
+		auto& Section = MeshSections[SectionIndex];
+		if (Section->SeparateStreams != Streams)
+		{
+			Section->SeparateStreams = Streams;
+
+			// The vertex layout is fixed when the section proxy is created, so it has to be recreated
+			if (BatchState.IsBatchPending())
+			{
+				BatchState.MarkRenderStateDirty();
+			}
+			else
+			{
+				MarkRenderStateDirty();
+			}
+		}
+	}
+}
+
+ERuntimeMeshVertexStream URuntimeMeshComponent::GetMeshSectionVertexStreams(int32 SectionIndex) const
+{
+	return SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid() ? MeshSections[SectionIndex]->SeparateStreams : ERuntimeMeshVertexStream::None;
+}
+
+void URuntimeMeshComponent::SetMeshSectionCollisionEnabled(int32 SectionIndex, bool bNewCollisionEnabled)
+{
+	if (SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid())
+	{
+		auto& Section = MeshSections[SectionIndex];
+		if (Section->CollisionEnabled != bNewCollisionEnabled)
+		{
+			Section->CollisionEnabled = bNewCollisionEnabled;
+			
+			// Use the batch update if one is running
+			if (BatchState.IsBatchPending())
+			{
+				// Mark render state dirty
+				SectionsWithDirtyCollision.Add(SectionIndex);
+				BatchState.MarkCollisionDirty();
+			}
+			else
+			{
+				SectionsWithDirtyCollision.Add(SectionIndex);
+				MarkCollisionDirty();
+			}
+		}
+	}
+}
+
+bool URuntimeMeshComponent::IsMeshSectionCollisionEnabled(int32 SectionIndex)
+{
+	return SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid() && MeshSections[SectionIndex]->CollisionEnabled;
+}
+
+
+
+int32 URuntimeMeshComponent::GetNumSections() const
+{
+	int32 SectionCount = 0;
+	for (int32 Index = 0; Index < MeshSections.Num(); Index++)
+	{
+		if (MeshSections[Index].IsValid())
+		{
+			SectionCount++;
+		}
+	}
+
+	return SectionCount;
+}
+
+bool URuntimeMeshComponent::DoesSectionExist(int32 SectionIndex) const
+{
+	return SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid();
+}
+
+int32 URuntimeMeshComponent::FirstAvailableMeshSectionIndex(int32 SectionIndex) const
+{
+	for (int32 Index = 0; Index < MeshSections.Num(); Index++)
+	{
+		if (!MeshSections[Index].IsValid())
+		{
+			return Index;
+		}
+	}
+	return MeshSections.Num();
+}
+
+
+void URuntimeMeshComponent::SetMeshCollisionSection(int32 CollisionSectionIndex, const TArray<FVector>& Vertices, const TArray<int32>& Triangles)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_SetMeshCollisionSection);
+
+	if (MeshCollisionSections.Num() <= CollisionSectionIndex)
+	{
+		MeshCollisionSections.SetNum(CollisionSectionIndex + 1, false);
+	}
+
+	auto& Section = MeshCollisionSections[CollisionSectionIndex];
+	Section.VertexBuffer = Vertices;
+	Section.IndexBuffer = Triangles;
+
+	// Use the batch update if one is running
+	if (BatchState.IsBatchPending())
+	{
+		// Mark render state dirty
+		CollisionSectionsWithDirtyCollision.Add(CollisionSectionIndex);
+		BatchState.MarkCollisionDirty();
+	}
+	else
+	{
+		CollisionSectionsWithDirtyCollision.Add(CollisionSectionIndex);
+		MarkCollisionDirty();
+	}
+}
+
+void URuntimeMeshComponent::ClearMeshCollisionSection(int32 CollisionSectionIndex)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_ClearMeshCollisionSection);
+
+	if (MeshCollisionSections.Num() <= CollisionSectionIndex)
+		return;
+
+	MeshCollisionSections[CollisionSectionIndex].Reset();
+
+	// Use the batch update if one is running
+	if (BatchState.IsBatchPending())
+	{
+		// Mark render state dirty
+		CollisionSectionsWithDirtyCollision.Add(CollisionSectionIndex);
+		BatchState.MarkCollisionDirty();
+	}
+	else
+	{
+		CollisionSectionsWithDirtyCollision.Add(CollisionSectionIndex);
+		MarkCollisionDirty();
+	}
+}
+
+void URuntimeMeshComponent::ClearAllMeshCollisionSections()
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_ClearAllMeshCollisionSections);
+
+	MeshCollisionSections.Empty();
+
+	// Every collision section body has to go
+	bAreAllCollisionBodiesDirty = true;
 
 	// Use the batch update if one is running
 	if (BatchState.IsBatchPending())
@@ -1374,6 +2512,8 @@ void URuntimeMeshComponent::AddCollisionConvexMesh(TArray<FVector> ConvexVerts)
 		ConvexSection.BoundingBox = FBox(ConvexVerts);
 		ConvexCollisionSections.Add(ConvexSection);
 		
+		// Simple collision lives in the component's own body
+		bIsBodySetupDirty = true;
 
 		// Use the batch update if one is running
 		if (BatchState.IsBatchPending())
@@ -1395,6 +2535,8 @@ void URuntimeMeshComponent::ClearCollisionConvexMeshes()
 	// Empty simple collision info
 	ConvexCollisionSections.Empty();
 
+	// Simple collision lives in the component's own body
+	bIsBodySetupDirty = true;
 
 	// Use the batch update if one is running
 	if (BatchState.IsBatchPending())
@@ -1423,6 +2565,8 @@ void URuntimeMeshComponent::SetCollisionConvexMeshes(const TArray< TArray<FVecto
 		ConvexCollisionSections.Add(ConvexSection);
 	}
 
+	// Simple collision lives in the component's own body
+	bIsBodySetupDirty = true;
 
 	// Use the batch update if one is running
 	if (BatchState.IsBatchPending())
@@ -1441,17 +2585,15 @@ void URuntimeMeshComponent::UpdateLocalBounds(bool bMarkRenderTransform)
 {
 	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_UpdateLocalBounds);
 	
-	FBox LocalBox(0);
+	LocalBox.Init();
 
-	for (const RuntimeMeshSectionPtr& Section : MeshSections)
+	for (int32 SectionIndex = 0; SectionIndex < MeshSections.Num(); SectionIndex++)
 	{
-		if (Section.IsValid() && Section->bIsVisible)
-		{
-			LocalBox += Section->LocalBoundingBox;
-		}
+		LocalBox += GetSectionLocalBox(SectionIndex);
 	}
 
 	LocalBounds = LocalBox.IsValid ? FBoxSphereBounds(LocalBox) : FBoxSphereBounds(FVector(0, 0, 0), FVector(0, 0, 0), 0); // fallback to reset box sphere bounds
+	bIsLocalBoundsRebuildPending = false;
 
 	// Update global bounds
 	UpdateBounds();
@@ -1460,6 +2602,57 @@ void URuntimeMeshComponent::UpdateLocalBounds(bool bMarkRenderTransform)
 	{
 		// Need to send to render thread
 		MarkRenderTransformDirty();
+		bIsRenderTransformUpdatePending = false;
+	}
+}
+
+void URuntimeMeshComponent::UpdateLocalBoundsForSection(int32 SectionIndex, bool bMayHaveShrunk)
+{
+	// Growing only needs the section's box added in, so creating many sections doesn't rescan all of them each time
+	const FBox SectionBox = GetSectionLocalBox(SectionIndex);
+	if (SectionBox.IsValid && !(LocalBox.IsValid && LocalBox.IsInside(SectionBox)))
+	{
+		LocalBox += SectionBox;
+		LocalBounds = FBoxSphereBounds(LocalBox);
+
+		// Update global bounds now, so they're right for anything else this frame
+		UpdateBounds();
+		bIsRenderTransformUpdatePending = true;
+	}
+
+	// Shrinking needs every section, so is left until the end of the frame. The bounds only stay too big until then.
+	bIsLocalBoundsRebuildPending |= bMayHaveShrunk;
+
+	if (bIsLocalBoundsRebuildPending || bIsRenderTransformUpdatePending)
+	{
+		BatchUpdateTick.SetTickFunctionEnable(true);
+	}
+}
+
+FBox URuntimeMeshComponent::GetSectionLocalBox(int32 SectionIndex) const
+{
+	const RuntimeMeshSectionPtr& Section = MeshSections[SectionIndex];
+	if (Section.IsValid() && Section->bIsVisible)
+	{
+		return Section->bIsInstanced ? Section->GetInstancedBoundingBox() : Section->LocalBoundingBox;
+	}
+	return FBox(0);
+}
+
+void URuntimeMeshComponent::FlushLocalBounds()
+{
+	if (bIsLocalBoundsRebuildPending)
+	{
+		const FBox OldLocalBox = LocalBox;
+		UpdateLocalBounds(false);
+
+		bIsRenderTransformUpdatePending |= !(OldLocalBox == LocalBox);
+	}
+
+	if (bIsRenderTransformUpdatePending)
+	{
+		MarkRenderTransformDirty();
+		bIsRenderTransformUpdatePending = false;
 	}
 }
 
@@ -1490,8 +2683,8 @@ void URuntimeMeshComponent::EndBatchUpdates()
 	if (!BatchState.IsBatchPending())
 		return;
 
-	// Handle all pending rendering updates..
-	if (BatchState.RequiresSceneProxyRecreate())
+	// Handle all pending rendering updates. Without a proxy there's nothing to update, it'll be built from the sections when created.
+	if (BatchState.RequiresSceneProxyRecreate() || !SceneProxy)
 	{
 		MarkRenderStateDirty();
 	}
@@ -1510,11 +2703,34 @@ void URuntimeMeshComponent::EndBatchUpdates()
 			// Check that we don't have both create and destroy flagged
 			check(!(BatchState.HasFlagSet(Index, ERuntimeMeshSectionBatchUpdateType::Create) && BatchState.HasFlagSet(Index, ERuntimeMeshSectionBatchUpdateType::Destroy)));
 
+			// Instance updates can go along with any other update, except create which already sends the instances
+			if (BatchState.HasFlagSet(Index, ERuntimeMeshSectionBatchUpdateType::InstancesUpdate) &&
+				!BatchState.HasFlagSet(Index, ERuntimeMeshSectionBatchUpdateType::Create) && 
+				!BatchState.HasFlagSet(Index, ERuntimeMeshSectionBatchUpdateType::Destroy))
+			{
+				// Validate section exists
+				check(MeshSections.Num() >= Index && MeshSections[Index].IsValid());
+
+				auto SectionInstances = TRuntimeMeshCommandPool<FRuntimeMeshSectionInstanceUpdateData>::Allocate();
+				SectionInstances->SetTargetSection(Index);
+				SectionInstances->bIsInstanced = MeshSections[Index]->bIsInstanced;
+				MeshSections[Index]->GetInstanceMatrices(SectionInstances->InstanceTransforms);
+
+				BatchUpdateData->InstanceUpdateSections.Add(SectionInstances);
+			}
+
 			// Handle section created
 			if (BatchState.HasFlagSet(Index, ERuntimeMeshSectionBatchUpdateType::Create))
 			{
 				// Validate section exists
 				check(MeshSections.Num() >= Index && MeshSections[Index].IsValid());
+
+				// Leave the upload to the scheduler if the section uses it
+				if (ShouldScheduleUpload(Index))
+				{
+					FRuntimeMeshUploadScheduler::Get().Schedule(this, Index, ERuntimeMeshSectionBatchUpdateType::Create);
+					continue;
+				}
 				
 				UMaterialInterface* Material = GetMaterial(Index);
 				if (Material == nullptr)
@@ -1543,24 +2759,63 @@ void URuntimeMeshComponent::EndBatchUpdates()
 				bool bHadPositionUpdates = BatchState.HasFlagSet(Index, ERuntimeMeshSectionBatchUpdateType::PositionsUpdate);
 				bool bHadVertexUpdates = BatchState.HasFlagSet(Index, ERuntimeMeshSectionBatchUpdateType::VerticesUpdate);
 				bool bHadIndexUpdates = BatchState.HasFlagSet(Index, ERuntimeMeshSectionBatchUpdateType::IndicesUpdate);
+
+				// Leave the upload to the scheduler if the section uses it
+				if (ShouldScheduleUpload(Index))
+				{
+					ERuntimeMeshSectionBatchUpdateType UpdateType = ERuntimeMeshSectionBatchUpdateType::None;
+					UpdateType |= bHadPositionUpdates ? ERuntimeMeshSectionBatchUpdateType::PositionsUpdate : ERuntimeMeshSectionBatchUpdateType::None;
+					UpdateType |= bHadVertexUpdates ? ERuntimeMeshSectionBatchUpdateType::VerticesUpdate : ERuntimeMeshSectionBatchUpdateType::None;
+					UpdateType |= bHadIndexUpdates ? ERuntimeMeshSectionBatchUpdateType::IndicesUpdate : ERuntimeMeshSectionBatchUpdateType::None;
+
+					FRuntimeMeshUploadScheduler::Get().Schedule(this, Index, UpdateType);
+					continue;
+				}
+
 				auto SectionUpdateData = MeshSections[Index]->GetSectionUpdateData(bHadPositionUpdates, bHadVertexUpdates, bHadIndexUpdates);
 				SectionUpdateData->SetTargetSection(Index);
 
 				BatchUpdateData->UpdateSections.Add(SectionUpdateData);
 			}
+			// Handle separate vertex stream updates
+			else if (BatchState.HasFlagSet(Index, ERuntimeMeshSectionBatchUpdateType::StreamsUpdate))
+			{
+				// Validate section exists
+				check(MeshSections.Num() >= Index && MeshSections[Index].IsValid());
+
+				// Leave the upload to the scheduler if the section uses it
+				if (ShouldScheduleUpload(Index))
+				{
+					FRuntimeMeshUploadScheduler::Get().Schedule(this, Index, ERuntimeMeshSectionBatchUpdateType::StreamsUpdate);
+					continue;
+				}
+
+				// Streams aren't tracked individually across the batch, so send all the section has
+				auto SectionUpdateData = MeshSections[Index]->GetSectionStreamUpdateData(MeshSections[Index]->SeparateStreams);
+				SectionUpdateData->SetTargetSection(Index);
+
+				BatchUpdateData->UpdateSections.Add(SectionUpdateData);
+			}
 			// Handle property updates
 			else if (BatchState.HasFlagSet(Index, ERuntimeMeshSectionBatchUpdateType::PropertyUpdate))
 			{
 				// Validate section exists
 				check(MeshSections.Num() >= Index && MeshSections[Index].IsValid());
 
-				auto SectionProperties = new(BatchUpdateData->PropertyUpdateSections) FRuntimeMeshSectionPropertyUpdateData;
+				auto SectionProperties = TRuntimeMeshCommandPool<FRuntimeMeshSectionPropertyUpdateData>::Allocate();
+				BatchUpdateData->PropertyUpdateSections.Add(SectionProperties);
 
 				auto& Section = MeshSections[Index];
 
 				SectionProperties->SetTargetSection(Index);
 				SectionProperties->bIsVisible = Section->bIsVisible;
 				SectionProperties->bCastsShadow = Section->bCastsShadow;
+				SectionProperties->MaxDrawDistance = Section->MaxDrawDistance;
+				SectionProperties->LODIndex = Section->LODIndex;
+			}
+			// Instance updates were handled above
+			else if (BatchState.HasFlagSet(Index, ERuntimeMeshSectionBatchUpdateType::InstancesUpdate))
+			{
 			}
 			else
 			{
@@ -1618,6 +2873,20 @@ void URuntimeMeshComponent::GetSectionMesh(int32 SectionIndex, const IRuntimeMes
 bool URuntimeMeshComponent::GetPhysicsTriMeshData(struct FTriMeshCollisionData* CollisionData, bool InUseAllTriData)
 {
 	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_GetPhysicsTriMeshData);
+
+	// Cooks read what was already gathered to look them up in the cache, or the snapshot an async cook was started with
+	if (IsInGameThread() && SynchronousCollisionCook != nullptr)
+	{
+		*CollisionData = SynchronousCollisionCook->CollisionData;
+		return SynchronousCollisionCook->bHasCollisionData;
+	}
+
+	// Sections are cooked into their own bodies, so only the convex collision goes in the component's body
+	if (bUseSectionCollisionBodies)
+	{
+		return false;
+	}
+
  	int32 VertexBase = 0; // Base vertex index for current section
  
 	bool HadCollision = false;
@@ -1634,7 +2903,8 @@ bool URuntimeMeshComponent::GetPhysicsTriMeshData(struct FTriMeshCollisionData*
 	{ 
 		const RuntimeMeshSectionPtr& Section = MeshSections[SectionIdx];
 
-		if (Section.IsValid() && Section->CollisionEnabled)
+		// Instanced sections don't get collision, it would have to be duplicated for every instance
+		if (Section.IsValid() && Section->CollisionEnabled && !Section->bIsInstanced)
 		{
 			// Copy vertex data
 			Section->GetAllVertexPositions(CollisionData->Vertices);
@@ -1702,9 +2972,19 @@ bool URuntimeMeshComponent::GetPhysicsTriMeshData(struct FTriMeshCollisionData*
 
  bool URuntimeMeshComponent::ContainsPhysicsTriMeshData(bool InUseAllTriData) const
  {
+	if (IsInGameThread() && SynchronousCollisionCook != nullptr)
+	{
+		return SynchronousCollisionCook->bHasCollisionData;
+	}
+
+	if (bUseSectionCollisionBodies)
+	{
+		return false;
+	}
+
  	for (const RuntimeMeshSectionPtr& Section : MeshSections)
  	{
- 		if (Section.IsValid() && Section->IndexBuffer.Num() >= 3 && Section->CollisionEnabled)
+ 		if (Section.IsValid() && Section->IndexBuffer.Num() >= 3 && Section->CollisionEnabled && !Section->bIsInstanced)
  		{
  			return true;
  		}
@@ -1726,14 +3006,39 @@ void URuntimeMeshComponent::EnsureBodySetupCreated()
 {
 	if (BodySetup == nullptr)
 	{
-		BodySetup = NewObject<UBodySetup>(this);
-		BodySetup->BodySetupGuid = FGuid::NewGuid();
-
-		BodySetup->bGenerateMirroredCollision = false;
-		BodySetup->bDoubleSidedGeometry = true;
+		BodySetup = CreateBodySetupHelper();
 	}
 }
 
+UBodySetup* URuntimeMeshComponent::CreateBodySetupHelper()
+{
+	UBodySetup* NewBodySetup = NewObject<UBodySetup>(this);
+	NewBodySetup->BodySetupGuid = FGuid::NewGuid();
+
+	NewBodySetup->bGenerateMirroredCollision = false;
+	NewBodySetup->bDoubleSidedGeometry = true;
+	return NewBodySetup;
+}
+
+void URuntimeMeshComponent::FillBodySetup(UBodySetup* NewBodySetup)
+{
+	// Fill in simple collision convex elements
+	NewBodySetup->AggGeom.ConvexElems.SetNum(ConvexCollisionSections.Num());
+	for (int32 Index = 0; Index < ConvexCollisionSections.Num(); Index++)
+	{
+		FKConvexElem& NewConvexElem = NewBodySetup->AggGeom.ConvexElems[Index];
+
+		NewConvexElem.VertexData = ConvexCollisionSections[Index].VertexBuffer;
+		NewConvexElem.ElemBox = FBox(NewConvexElem.VertexData);
+	} 
+
+	// Set trace flag
+	NewBodySetup->CollisionTraceFlag = bUseComplexAsSimpleCollision ? CTF_UseComplexAsSimple : CTF_UseDefault;
+
+	// New GUID as collision has changed
+	NewBodySetup->BodySetupGuid = FGuid::NewGuid();
+}
+
 void URuntimeMeshComponent::UpdateCollision()
 {
 	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_UpdateCollision);
@@ -1749,30 +3054,27 @@ void URuntimeMeshComponent::UpdateCollision()
 
 	// Ensure we have a BodySetup
 	EnsureBodySetupCreated();
+	FillBodySetup(BodySetup);
 
-	// Fill in simple collision convex elements
-	BodySetup->AggGeom.ConvexElems.SetNum(ConvexCollisionSections.Num());
-	for (int32 Index = 0; Index < ConvexCollisionSections.Num(); Index++)
+#if WITH_RUNTIME_PHYSICS_COOKING || WITH_EDITOR
+	// Clear current mesh data
+	BodySetup->InvalidatePhysicsData();
+
+	// Fill in the cooked data from the cache, or cook it and add it to the cache
+	if (bUseCollisionCache)
 	{
-		FKConvexElem& NewConvexElem = BodySetup->AggGeom.ConvexElems[Index];
+		// Gathered once for the key, then handed back to the cook through GetPhysicsTriMeshData() on a miss
+		FRuntimeMeshCollisionCookState CookState;
+		CookState.bHasCollisionData = GetPhysicsTriMeshData(&CookState.CollisionData, true);
 
-		NewConvexElem.VertexData = ConvexCollisionSections[Index].VertexBuffer;
-		NewConvexElem.ElemBox = FBox(NewConvexElem.VertexData);
-	} 
+		SynchronousCollisionCook = &CookState;
+		FRuntimeMeshCollisionCache::Get().CookBodySetup(BodySetup, CookState.bHasCollisionData ? &CookState.CollisionData : nullptr);
+		SynchronousCollisionCook = nullptr;
+	}
 
-	// Set trace flag
-	BodySetup->CollisionTraceFlag = bUseComplexAsSimpleCollision ? CTF_UseComplexAsSimple : CTF_UseDefault;
-
-	// New GUID as collision has changed
-	BodySetup->BodySetupGuid = FGuid::NewGuid();
-
-
-#if WITH_RUNTIME_PHYSICS_COOKING || WITH_EDITOR
-	// Clear current mesh data
-	BodySetup->InvalidatePhysicsData();
-	// Create new mesh data
-	BodySetup->CreatePhysicsMeshes();
-#endif // WITH_RUNTIME_PHYSICS_COOKING || WITH_EDITOR
+	// Create new mesh data
+	BodySetup->CreatePhysicsMeshes();
+#endif // WITH_RUNTIME_PHYSICS_COOKING || WITH_EDITOR
 
 	// Recreate physics state if necessary
 	if (NeedsNewPhysicsState)
@@ -1791,6 +3093,12 @@ UBodySetup* URuntimeMeshComponent::GetBodySetup()
 
 void URuntimeMeshComponent::MarkCollisionDirty()
 {
+	// Anything cooking now is out of date
+	if (PendingCollisionCook.IsValid())
+	{
+		PendingCollisionCook->bIsCancelled = true;
+	}
+
 	if (!bCollisionDirty)
 	{
 		bCollisionDirty = true;
@@ -1801,13 +3109,572 @@ void URuntimeMeshComponent::MarkCollisionDirty()
 
 void URuntimeMeshComponent::BakeCollision()
 {
+	if (bUseSectionCollisionBodies)
+	{
+		UpdateSectionCollisionBodies();
+
+		// The component's own body only holds the convex collision, which is cheap enough to always cook here
+		if (bIsBodySetupDirty || BodySetup == nullptr)
+		{
+			UpdateCollision();
+		}
+
+		bIsBodySetupDirty = false;
+		bCollisionDirty = false;
+		PrePhysicsTick.SetTickFunctionEnable(false);
+		return;
+	}
+
+	// Only one async cook runs at a time. FinishAsyncCollisionCook() starts ticking again if there's more to cook.
+	if (PendingCollisionCook.IsValid())
+	{
+		PrePhysicsTick.SetTickFunctionEnable(false);
+		return;
+	}
+
+	// Everything is in the one mesh, so there's nothing to track per section
+	SectionsWithDirtyCollision.Reset();
+	CollisionSectionsWithDirtyCollision.Reset();
+	bAreAllCollisionBodiesDirty = false;
+	bIsBodySetupDirty = false;
+
 	// Bake the collision
-	UpdateCollision();
+	if (bUseAsyncCooking)
+	{
+		StartAsyncCollisionCook();
+	}
+	else
+	{
+		UpdateCollision();
+	}
 
 	bCollisionDirty = false;
 	PrePhysicsTick.SetTickFunctionEnable(false);
 }
 
+void URuntimeMeshComponent::StartAsyncCollisionCook()
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_StartCollisionCook);
+
+	// The cook goes into a new body setup, so the current one stays in use until it's done
+	UBodySetup* NewBodySetup = CreateBodySetupHelper();
+	FillBodySetup(NewBodySetup);
+
+	TSharedPtr<FRuntimeMeshCollisionCookState, ESPMode::ThreadSafe> CookState = MakeShareable(new FRuntimeMeshCollisionCookState());
+	CookState->bHasCollisionData = GetPhysicsTriMeshData(&CookState->CollisionData, true);
+	PendingCollisionCook = CookState;
+
+	// Rooting the body setup keeps both it and this component, its outer, alive until the worker is done with them
+	NewBodySetup->AddToRoot();
+
+	const bool bUseCache = bUseCollisionCache;
+
+	TWeakObjectPtr<URuntimeMeshComponent> WeakThis(this);
+	AsyncTask(ENamedThreads::AnyThread, [WeakThis, NewBodySetup, CookState, bUseCache]()
+	{
+		SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_PrepareCollisionCookAsync);
+
+		// Only the cache lookup happens here. GetCookedData() is game thread only on 4.10-4.14, so a miss is cooked in 
+		// FinishAsyncCollisionCook(). Don't bother if the collision has changed again since the snapshot
+		if (bUseCache && !CookState->bIsCancelled)
+		{
+			CookState->bIsCookedDataLoaded = FRuntimeMeshCollisionCache::Get().LoadCookedData(NewBodySetup, 
+				CookState->bHasCollisionData ? &CookState->CollisionData : nullptr, CookState->CacheKey);
+			CookState->bHasCacheKey = true;
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, NewBodySetup, CookState]()
+		{
+			if (WeakThis.IsValid())
+			{
+				WeakThis->FinishAsyncCollisionCook(NewBodySetup, CookState);
+			}
+			NewBodySetup->RemoveFromRoot();
+		});
+	});
+}
+
+void URuntimeMeshComponent::FinishAsyncCollisionCook(UBodySetup* NewBodySetup, const TSharedPtr<FRuntimeMeshCollisionCookState, ESPMode::ThreadSafe>& CookState)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_FinishCollisionCook);
+
+	check(PendingCollisionCook == CookState);
+	PendingCollisionCook.Reset();
+
+	// Start the next cook if the collision changed while this one was running
+	if (bCollisionDirty)
+	{
+		PrePhysicsTick.SetTickFunctionEnable(true);
+	}
+
+	if (CookState->bIsCancelled)
+	{
+		return;
+	}
+
+	bool NeedsNewPhysicsState = false;
+
+	// Destroy physics state if it exists
+	if (bPhysicsStateCreated)
+	{
+		DestroyPhysicsState();
+		NeedsNewPhysicsState = true;
+	}
+
+	// Swap in the new body, the old one is left to be garbage collected
+	BodySetup = NewBodySetup;
+
+#if WITH_RUNTIME_PHYSICS_COOKING || WITH_EDITOR
+	// The cook reads the snapshot, which still matches the sections as any change since would have cancelled it
+	SynchronousCollisionCook = CookState.Get();
+	if (!CookState->bIsCookedDataLoaded && CookState->bHasCacheKey)
+	{
+		FRuntimeMeshCollisionCache::Get().CookMissedBodySetup(BodySetup, CookState->CacheKey);
+	}
+
+	// Cooks here if the cache wasn't used, otherwise only creates the physics meshes from the cooked data
+	BodySetup->CreatePhysicsMeshes();
+	SynchronousCollisionCook = nullptr;
+#endif // WITH_RUNTIME_PHYSICS_COOKING || WITH_EDITOR
+
+	// Recreate physics state if necessary
+	if (NeedsNewPhysicsState)
+	{
+		CreatePhysicsState();
+	}
+
+	UpdateNavigation();
+}
+
+void URuntimeMeshComponent::UpdateSectionCollisionBodies()
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_UpdateSectionCollisionBodies);
+
+	if (bAreAllCollisionBodiesDirty)
+	{
+		// Covers sections that have been removed as well as the ones still around
+		for (URuntimeMeshCollisionBody* PendingBody : PendingCollisionBodies)
+		{
+			(PendingBody->IsCollisionSection() ? CollisionSectionsWithDirtyCollision : SectionsWithDirtyCollision).Add(PendingBody->GetSectionIndex());
+		}
+		for (int32 SectionIndex = 0; SectionIndex < FMath::Max(MeshSections.Num(), SectionCollisionBodies.Num()); SectionIndex++)
+		{
+			SectionsWithDirtyCollision.Add(SectionIndex);
+		}
+		for (int32 SectionIndex = 0; SectionIndex < FMath::Max(MeshCollisionSections.Num(), CollisionSectionCollisionBodies.Num()); SectionIndex++)
+		{
+			CollisionSectionsWithDirtyCollision.Add(SectionIndex);
+		}
+		bAreAllCollisionBodiesDirty = false;
+	}
+
+	if (SectionsWithDirtyCollision.Num() == 0 && CollisionSectionsWithDirtyCollision.Num() == 0)
+	{
+		return;
+	}
+
+	for (int32 SectionIndex : SectionsWithDirtyCollision)
+	{
+		UpdateSectionCollisionBody(false, SectionIndex);
+	}
+	for (int32 SectionIndex : CollisionSectionsWithDirtyCollision)
+	{
+		UpdateSectionCollisionBody(true, SectionIndex);
+	}
+
+	SectionsWithDirtyCollision.Reset();
+	CollisionSectionsWithDirtyCollision.Reset();
+
+	UpdateNavigation();
+}
+
+void URuntimeMeshComponent::UpdateSectionCollisionBody(bool bIsCollisionSection, int32 SectionIndex)
+{
+	// Anything still cooking for this section is out of date
+	for (URuntimeMeshCollisionBody* PendingBody : PendingCollisionBodies)
+	{
+		if (PendingBody->IsCollisionSection() == bIsCollisionSection && PendingBody->GetSectionIndex() == SectionIndex)
+		{
+			PendingBody->Cancel();
+		}
+	}
+
+	TArray<FVector> Vertices;
+	const TArray<int32>* Triangles = nullptr;
+
+	if (bIsCollisionSection)
+	{
+		if (SectionIndex < MeshCollisionSections.Num())
+		{
+			const FRuntimeMeshCollisionSection& Section = MeshCollisionSections[SectionIndex];
+			if (Section.VertexBuffer.Num() > 0 && Section.IndexBuffer.Num() > 0)
+			{
+				Vertices = Section.VertexBuffer;
+				Triangles = &Section.IndexBuffer;
+			}
+		}
+	}
+	else
+	{
+		if (SectionIndex < MeshSections.Num())
+		{
+			// Instanced sections don't get collision, it would have to be duplicated for every instance
+			const RuntimeMeshSectionPtr& Section = MeshSections[SectionIndex];
+			if (Section.IsValid() && Section->IndexBuffer.Num() >= 3 && Section->CollisionEnabled && !Section->bIsInstanced)
+			{
+				Section->GetAllVertexPositions(Vertices);
+				Triangles = &Section->IndexBuffer;
+			}
+		}
+	}
+
+	// Nothing left to collide with
+	if (Triangles == nullptr)
+	{
+		SetSectionCollisionBody(bIsCollisionSection, SectionIndex, nullptr);
+		return;
+	}
+
+	URuntimeMeshCollisionBody* NewBody = NewObject<URuntimeMeshCollisionBody>(this);
+	NewBody->SetCollisionData(bIsCollisionSection, SectionIndex, Vertices, *Triangles, bUseComplexAsSimpleCollision);
+
+	if (!bUseAsyncCooking)
+	{
+		NewBody->Cook(bUseCollisionCache);
+		NewBody->CreatePhysicsMeshes();
+		SetSectionCollisionBody(bIsCollisionSection, SectionIndex, NewBody);
+		return;
+	}
+
+	// The old body stays in use until the new one is cooked. Rooting the new body keeps both it and this component, 
+	// its outer, alive until the worker is done with them
+	NewBody->AddToRoot();
+	PendingCollisionBodies.Add(NewBody);
+
+	const bool bUseCache = bUseCollisionCache;
+
+	TWeakObjectPtr<URuntimeMeshComponent> WeakThis(this);
+	AsyncTask(ENamedThreads::AnyThread, [WeakThis, NewBody, bUseCache]()
+	{
+		SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_PrepareCollisionCookAsync);
+
+		// Only the cache lookup happens here, a miss is cooked on the game thread in FinishSectionCollisionBodyCook().
+		// Don't bother if the section has changed again since
+		if (bUseCache && !NewBody->IsCancelled())
+		{
+			NewBody->LoadFromCollisionCache();
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, NewBody]()
+		{
+			if (WeakThis.IsValid())
+			{
+				WeakThis->FinishSectionCollisionBodyCook(NewBody);
+			}
+			NewBody->RemoveFromRoot();
+		});
+	});
+}
+
+void URuntimeMeshComponent::FinishSectionCollisionBodyCook(URuntimeMeshCollisionBody* NewBody)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_FinishCollisionCook);
+
+	PendingCollisionBodies.RemoveSingleSwap(NewBody);
+
+	if (NewBody->IsCancelled())
+	{
+		return;
+	}
+
+	// Does nothing if the worker found the cooked data in the cache
+	NewBody->Cook(bUseCollisionCache);
+	NewBody->CreatePhysicsMeshes();
+	SetSectionCollisionBody(NewBody->IsCollisionSection(), NewBody->GetSectionIndex(), NewBody);
+
+	UpdateNavigation();
+}
+
+void URuntimeMeshComponent::SetSectionCollisionBody(bool bIsCollisionSection, int32 SectionIndex, URuntimeMeshCollisionBody* NewBody)
+{
+	TArray<URuntimeMeshCollisionBody*>& Bodies = bIsCollisionSection ? CollisionSectionCollisionBodies : SectionCollisionBodies;
+
+	if (SectionIndex >= Bodies.Num())
+	{
+		if (NewBody == nullptr)
+		{
+			return;
+		}
+		Bodies.SetNumZeroed(SectionIndex + 1);
+	}
+
+	// The old body is left to be garbage collected
+	if (Bodies[SectionIndex] != nullptr)
+	{
+		Bodies[SectionIndex]->TermBody();
+	}
+
+	Bodies[SectionIndex] = NewBody;
+
+	// Only this section's physics body changes, the rest of the physics state is left alone
+	if (NewBody != nullptr && bPhysicsStateCreated)
+	{
+		NewBody->InitBody(this);
+	}
+
+	// Trim bodies of removed sections off the end
+	while (Bodies.Num() > 0 && Bodies.Last() == nullptr)
+	{
+		Bodies.Pop(false);
+	}
+}
+
+void URuntimeMeshComponent::UpdateSectionCollisionBodyTransforms(ETeleportType Teleport)
+{
+	for (URuntimeMeshCollisionBody* Body : SectionCollisionBodies)
+	{
+		if (Body != nullptr)
+		{
+			Body->SetBodyTransform(ComponentToWorld, Teleport);
+		}
+	}
+	for (URuntimeMeshCollisionBody* Body : CollisionSectionCollisionBodies)
+	{
+		if (Body != nullptr)
+		{
+			Body->SetBodyTransform(ComponentToWorld, Teleport);
+		}
+	}
+}
+
+void URuntimeMeshComponent::OnCreatePhysicsState()
+{
+	Super::OnCreatePhysicsState();
+
+	for (URuntimeMeshCollisionBody* Body : SectionCollisionBodies)
+	{
+		if (Body != nullptr)
+		{
+			Body->InitBody(this);
+		}
+	}
+	for (URuntimeMeshCollisionBody* Body : CollisionSectionCollisionBodies)
+	{
+		if (Body != nullptr)
+		{
+			Body->InitBody(this);
+		}
+	}
+}
+
+void URuntimeMeshComponent::OnDestroyPhysicsState()
+{
+	for (URuntimeMeshCollisionBody* Body : SectionCollisionBodies)
+	{
+		if (Body != nullptr)
+		{
+			Body->TermBody();
+		}
+	}
+	for (URuntimeMeshCollisionBody* Body : CollisionSectionCollisionBodies)
+	{
+		if (Body != nullptr)
+		{
+			Body->TermBody();
+		}
+	}
+
+	Super::OnDestroyPhysicsState();
+}
+
+#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION >= 14
+void URuntimeMeshComponent::OnUpdateTransform(EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	Super::OnUpdateTransform(UpdateTransformFlags, Teleport);
+
+	if (!(UpdateTransformFlags & EUpdateTransformFlags::SkipPhysicsUpdate))
+	{
+		UpdateSectionCollisionBodyTransforms(Teleport);
+	}
+}
+#else
+void URuntimeMeshComponent::OnUpdateTransform(bool bSkipPhysicsMove, ETeleportType Teleport)
+{
+	Super::OnUpdateTransform(bSkipPhysicsMove, Teleport);
+
+	if (!bSkipPhysicsMove)
+	{
+		UpdateSectionCollisionBodyTransforms(Teleport);
+	}
+}
+#endif
+
+void URuntimeMeshComponent::OnComponentCollisionSettingsChanged()
+{
+	Super::OnComponentCollisionSettingsChanged();
+
+	// Section bodies run apart from the component's body instance, so they have to be given the new settings themselves
+	for (URuntimeMeshCollisionBody* Body : SectionCollisionBodies)
+	{
+		if (Body != nullptr)
+		{
+			Body->UpdateCollisionSettings(this);
+		}
+	}
+	for (URuntimeMeshCollisionBody* Body : CollisionSectionCollisionBodies)
+	{
+		if (Body != nullptr)
+		{
+			Body->UpdateCollisionSettings(this);
+		}
+	}
+}
+
+bool URuntimeMeshComponent::DoCustomNavigableGeometryExport(FNavigableGeometryExport& GeomExport) const
+{
+	// Section collision bodies aren't part of the component's body setup, so the default export doesn't see them
+	for (const URuntimeMeshCollisionBody* Body : SectionCollisionBodies)
+	{
+		if (Body != nullptr && Body->GetBodySetup() != nullptr)
+		{
+			GeomExport.ExportRigidBodySetup(*Body->GetBodySetup(), ComponentToWorld);
+		}
+	}
+	for (const URuntimeMeshCollisionBody* Body : CollisionSectionCollisionBodies)
+	{
+		if (Body != nullptr && Body->GetBodySetup() != nullptr)
+		{
+			GeomExport.ExportRigidBodySetup(*Body->GetBodySetup(), ComponentToWorld);
+		}
+	}
+
+	// Carry on with the default export of the component's own body
+	return true;
+}
+
+bool URuntimeMeshComponent::ShouldBatchUpdate()
+{
+	if (bAutoBatchUpdates && !BatchState.IsBatchPending())
+	{
+		BatchState.StartBatch(true);
+		BatchUpdateTick.SetTickFunctionEnable(true);
+	}
+
+	return BatchState.IsBatchPending();
+}
+
+void URuntimeMeshComponent::FlushDeferredUpdates()
+{
+	// An explicit batch could have taken over the automatic one, in which case it's up to EndBatchUpdates()
+	if (BatchState.IsAutomaticBatchPending())
+	{
+		EndBatchUpdates();
+	}
+
+	FlushLocalBounds();
+
+	BatchUpdateTick.SetTickFunctionEnable(false);
+}
+
+void URuntimeMeshComponent::SetUploadBudget(int32 BytesPerFrame, float MillisecondsPerFrame)
+{
+	FRuntimeMeshUploadScheduler::Get().SetFrameBudget(BytesPerFrame, MillisecondsPerFrame);
+}
+
+void URuntimeMeshComponent::SetCollisionCacheLimits(int32 MaxMemoryMegabytes, bool bUseDiskCache, int32 MaxDiskMegabytes)
+{
+	FRuntimeMeshCollisionCache::Get().SetLimits((int64)MaxMemoryMegabytes * 1024 * 1024, bUseDiskCache, (int64)MaxDiskMegabytes * 1024 * 1024);
+}
+
+bool URuntimeMeshComponent::ShouldScheduleUpload(int32 SectionIndex) const
+{
+	// Static sections are part of the proxy, and volatile sections are rewritten every frame so can't wait
+	return bUseUploadScheduler && MeshSections[SectionIndex]->UpdateFrequency != EUpdateFrequency::Infrequent && 
+		MeshSections[SectionIndex]->UpdateFrequency != EUpdateFrequency::Volatile;
+}
+
+void URuntimeMeshComponent::SendSectionCreate(int32 SectionIndex)
+{
+	check(SceneProxy);
+	RuntimeMeshSectionPtr& Section = MeshSections[SectionIndex];
+
+	// Gather all needed update info
+	auto* SectionData = Section->GetSectionCreationData(GetScene(), GetSectionMaterial(SectionIndex));
+	SectionData->SetTargetSection(SectionIndex);
+
+	// Enqueue update on RT
+	ENQUEUE_UNIQUE_RENDER_COMMAND_TWOPARAMETER(
+		FRuntimeMeshSectionCreate,
+		FRuntimeMeshSceneProxy*, RuntimeMeshSceneProxy, (FRuntimeMeshSceneProxy*)SceneProxy,
+		FRuntimeMeshSectionCreateDataInterface*, SectionData, SectionData,
+		{
+			RuntimeMeshSceneProxy->CreateSection_RenderThread(SectionData);
+		}
+	);
+}
+
+void URuntimeMeshComponent::SendSectionUpdate(int32 SectionIndex, bool bHadVertexPositionsUpdate, bool bHadVertexUpdates, bool bHadIndexUpdates)
+{
+	check(SceneProxy);
+	RuntimeMeshSectionPtr& Section = MeshSections[SectionIndex];
+
+	auto* SectionData = Section->GetSectionUpdateData(bHadVertexPositionsUpdate, bHadVertexUpdates, bHadIndexUpdates);
+	SectionData->SetTargetSection(SectionIndex);
+
+	// Enqueue update on RT
+	ENQUEUE_UNIQUE_RENDER_COMMAND_TWOPARAMETER(
+		FRuntimeMeshSectionUpdate,
+		FRuntimeMeshSceneProxy*, RuntimeMeshSceneProxy, (FRuntimeMeshSceneProxy*)SceneProxy,
+		FRuntimeMeshRenderThreadCommandInterface*, SectionData, SectionData,
+		{
+			RuntimeMeshSceneProxy->UpdateSection_RenderThread(SectionData);
+		}
+	);
+}
+
+void URuntimeMeshComponent::SendSectionStreamUpdate(int32 SectionIndex, ERuntimeMeshVertexStream Streams)
+{
+	check(SceneProxy);
+	RuntimeMeshSectionPtr& Section = MeshSections[SectionIndex];
+
+	auto* SectionData = Section->GetSectionStreamUpdateData(Streams);
+	SectionData->SetTargetSection(SectionIndex);
+
+	// Enqueue update on RT
+	ENQUEUE_UNIQUE_RENDER_COMMAND_TWOPARAMETER(
+		FRuntimeMeshSectionStreamUpdate,
+		FRuntimeMeshSceneProxy*, RuntimeMeshSceneProxy, (FRuntimeMeshSceneProxy*)SceneProxy,
+		FRuntimeMeshRenderThreadCommandInterface*, SectionData, SectionData,
+		{
+			RuntimeMeshSceneProxy->UpdateSection_RenderThread(SectionData);
+		}
+	);
+}
+
+void URuntimeMeshComponent::SendScheduledUpload(int32 SectionIndex, ERuntimeMeshSectionBatchUpdateType Updates)
+{
+	if (!!(Updates & ERuntimeMeshSectionBatchUpdateType::Create))
+	{
+		SendSectionCreate(SectionIndex);
+		return;
+	}
+
+	const bool bHadPositionUpdates = !!(Updates & ERuntimeMeshSectionBatchUpdateType::PositionsUpdate);
+	const bool bHadVertexUpdates = !!(Updates & ERuntimeMeshSectionBatchUpdateType::VerticesUpdate);
+	const bool bHadIndexUpdates = !!(Updates & ERuntimeMeshSectionBatchUpdateType::IndicesUpdate);
+
+	if (bHadPositionUpdates || bHadVertexUpdates || bHadIndexUpdates)
+	{
+		SendSectionUpdate(SectionIndex, bHadPositionUpdates, bHadVertexUpdates, bHadIndexUpdates);
+	}
+
+	// A whole vertex update already rewrites every stream
+	if (!!(Updates & ERuntimeMeshSectionBatchUpdateType::StreamsUpdate) && !bHadVertexUpdates)
+	{
+		SendSectionStreamUpdate(SectionIndex, MeshSections[SectionIndex]->SeparateStreams);
+	}
+}
+
 
 void URuntimeMeshComponent::UpdateNavigation()
 {
@@ -1833,6 +3700,12 @@ void URuntimeMeshComponent::RegisterComponentTickFunctions(bool bRegister)
 			PrePhysicsTick.Target = this;
 			PrePhysicsTick.SetTickFunctionEnable(bCollisionDirty);
 		}
+
+		if (SetupActorComponentTickFunction(&BatchUpdateTick))
+		{
+			BatchUpdateTick.Target = this;
+			BatchUpdateTick.SetTickFunctionEnable(BatchState.IsAutomaticBatchPending() || bIsLocalBoundsRebuildPending || bIsRenderTransformUpdatePending);
+		}
 	}
 	else
 	{
@@ -1840,6 +3713,11 @@ void URuntimeMeshComponent::RegisterComponentTickFunctions(bool bRegister)
 		{
 			PrePhysicsTick.UnRegisterTickFunction();
 		}
+
+		if (BatchUpdateTick.IsTickFunctionRegistered())
+		{
+			BatchUpdateTick.UnRegisterTickFunction();
+		}
 	}
 }
 
@@ -1946,6 +3824,8 @@ void URuntimeMeshComponent::PostLoad()
 	Super::PostLoad();
 
 	// Rebuild collision and local bounds.
+	bIsBodySetupDirty = true;
+	bAreAllCollisionBodiesDirty = true;
 	MarkCollisionDirty();
 	UpdateLocalBounds();
 
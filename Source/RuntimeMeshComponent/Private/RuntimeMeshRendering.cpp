@@ -0,0 +1,347 @@
+// Copyright 2016 Chris Conway (Koderz). All Rights Reserved.
+
+#include "RuntimeMeshComponentPluginPrivatePCH.h"
+#include "RuntimeMeshRendering.h"
+#include "ShaderParameterUtils.h"
+
+
+FRuntimeMeshVolatileRingBuffer::FRuntimeMeshVolatileRingBuffer()
+	: CurrentRingIndex(0), LastCommittedFrame(MAX_uint32), bIsLayoutDirty(false), LayoutGeneration(1), TotalVertexBytes(0), TotalIndices(0)
+{
+	for (int32 RingIndex = 0; RingIndex < NumRingFrames; RingIndex++)
+	{
+		VertexRingCapacity[RingIndex] = 0;
+		IndexRingCapacity[RingIndex] = 0;
+		RingLayoutGeneration[RingIndex] = 0;
+	}
+}
+
+FRuntimeMeshVolatileRingBuffer& FRuntimeMeshVolatileRingBuffer::Get()
+{
+	check(IsInRenderingThread());
+
+	static TGlobalResource<FRuntimeMeshVolatileRingBuffer> RingBuffer;
+	return RingBuffer;
+}
+
+void FRuntimeMeshVolatileRingBuffer::Register(FRuntimeMeshVolatileSectionInterface* Section)
+{
+	check(IsInRenderingThread());
+
+	if (Sections.ContainsByPredicate([Section](const FSectionSlot& Slot) { return Slot.Section == Section; }))
+	{
+		return;
+	}
+
+	FSectionSlot& Slot = Sections[Sections.AddZeroed()];
+	Slot.Section = Section;
+	bIsLayoutDirty = true;
+}
+
+void FRuntimeMeshVolatileRingBuffer::Unregister(FRuntimeMeshVolatileSectionInterface* Section)
+{
+	check(IsInRenderingThread());
+
+	const int32 SlotIndex = Sections.IndexOfByPredicate([Section](const FSectionSlot& Slot) { return Slot.Section == Section; });
+	if (SlotIndex != INDEX_NONE)
+	{
+		Sections.RemoveAtSwap(SlotIndex);
+		bIsLayoutDirty = true;
+	}
+}
+
+void FRuntimeMeshVolatileRingBuffer::UpdateLayout()
+{
+	// Vertices are aligned to their own stride so each section can be addressed by a base vertex index.
+	TotalVertexBytes = 0;
+	TotalIndices = 0;
+	for (FSectionSlot& Slot : Sections)
+	{
+		Slot.Stride = Slot.Section->GetVolatileVertexStride();
+		Slot.NumVertices = Slot.Section->GetVolatileNumVertices();
+		Slot.NumIndices = Slot.Section->GetVolatileNumIndices();
+
+		TotalVertexBytes = ((TotalVertexBytes + Slot.Stride - 1) / Slot.Stride) * Slot.Stride;
+		Slot.VertexByteOffset = TotalVertexBytes;
+		Slot.FirstIndex = TotalIndices;
+
+		TotalVertexBytes += Slot.NumVertices * Slot.Stride;
+		TotalIndices += Slot.NumIndices;
+	}
+
+	LayoutGeneration++;
+	bIsLayoutDirty = false;
+}
+
+void FRuntimeMeshVolatileRingBuffer::CommitFrame()
+{
+	check(IsInRenderingThread());
+
+	// Only commit once per frame, no matter how many proxies or views ask for it
+	if (LastCommittedFrame == GFrameNumberRenderThread)
+	{
+		return;
+	}
+	LastCommittedFrame = GFrameNumberRenderThread;
+
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_CommitVolatileBuffers);
+
+	// Sections keep their place until one is added, removed or resized
+	bool bLayoutChanged = bIsLayoutDirty;
+	for (int32 SlotIndex = 0; SlotIndex < Sections.Num() && !bLayoutChanged; SlotIndex++)
+	{
+		const FSectionSlot& Slot = Sections[SlotIndex];
+		bLayoutChanged = Slot.Stride != Slot.Section->GetVolatileVertexStride() || Slot.NumVertices != Slot.Section->GetVolatileNumVertices() ||
+			Slot.NumIndices != Slot.Section->GetVolatileNumIndices();
+	}
+	if (bLayoutChanged)
+	{
+		UpdateLayout();
+	}
+
+	if (TotalVertexBytes == 0 || TotalIndices == 0)
+	{
+		return;
+	}
+
+	// Nothing to write if the current ring entry already holds the latest data of every section
+	bool bIsCurrentEntryUpToDate = RingLayoutGeneration[CurrentRingIndex] == LayoutGeneration;
+	for (int32 SlotIndex = 0; SlotIndex < Sections.Num() && bIsCurrentEntryUpToDate; SlotIndex++)
+	{
+		bIsCurrentEntryUpToDate = Sections[SlotIndex].WrittenVersion[CurrentRingIndex] == Sections[SlotIndex].Section->GetVolatileDataVersion();
+	}
+
+	if (!bIsCurrentEntryUpToDate)
+	{
+		// Move to the next buffer in the ring so we don't write to one the GPU could still be reading
+		CurrentRingIndex = (CurrentRingIndex + 1) % NumRingFrames;
+
+		// Grow this ring entry if it can't hold the frame. The whole entry is rewritten below, so it can be a dynamic buffer.
+		int32 NewCapacity;
+		bool bVertexReallocation = FRuntimeMeshBufferSizing::NeedsReallocation(TotalVertexBytes, VertexRingCapacity[CurrentRingIndex], true, NewCapacity);
+		if (bVertexReallocation)
+		{
+			FRHIResourceCreateInfo CreateInfo;
+			VertexRing[CurrentRingIndex] = RHICreateVertexBuffer(NewCapacity, BUF_Dynamic, CreateInfo);
+			VertexRingCapacity[CurrentRingIndex] = NewCapacity;
+		}
+		FRuntimeMeshBufferSizing::TrackResize(bVertexReallocation);
+
+		bool bIndexReallocation = FRuntimeMeshBufferSizing::NeedsReallocation(TotalIndices, IndexRingCapacity[CurrentRingIndex], true, NewCapacity);
+		if (bIndexReallocation)
+		{
+			FRHIResourceCreateInfo CreateInfo;
+			IndexRing[CurrentRingIndex] = RHICreateIndexBuffer(sizeof(uint32), NewCapacity * sizeof(uint32), BUF_Dynamic, CreateInfo);
+			IndexRingCapacity[CurrentRingIndex] = NewCapacity;
+		}
+		FRuntimeMeshBufferSizing::TrackResize(bIndexReallocation);
+
+		// Locking part of a buffer doesn't keep the rest of it on every RHI, so the whole entry is written with one lock
+		// of each buffer. Unchanged sections are still copied, but frames where nothing changed skip all of this.
+		uint8* VertexData = (uint8*)RHILockVertexBuffer(VertexRing[CurrentRingIndex], 0, TotalVertexBytes, RLM_WriteOnly);
+		uint32* IndexData = (uint32*)RHILockIndexBuffer(IndexRing[CurrentRingIndex], 0, TotalIndices * sizeof(uint32), RLM_WriteOnly);
+
+		for (FSectionSlot& Slot : Sections)
+		{
+			if (Slot.NumVertices > 0 && Slot.NumIndices > 0)
+			{
+				Slot.Section->WriteVolatileData(VertexData + Slot.VertexByteOffset, IndexData + Slot.FirstIndex, Slot.VertexByteOffset / Slot.Stride);
+			}
+			Slot.WrittenVersion[CurrentRingIndex] = Slot.Section->GetVolatileDataVersion();
+		}
+
+		RHIUnlockIndexBuffer(IndexRing[CurrentRingIndex]);
+		RHIUnlockVertexBuffer(VertexRing[CurrentRingIndex]);
+
+		RingLayoutGeneration[CurrentRingIndex] = LayoutGeneration;
+
+		// Point the shared buffers at this frame's ring entry
+		VertexBuffer.VertexBufferRHI = VertexRing[CurrentRingIndex];
+		IndexBuffer.IndexBufferRHI = IndexRing[CurrentRingIndex];
+
+		INC_DWORD_STAT_BY(STAT_RuntimeMesh_VolatileSectionsWritten, Sections.Num());
+		INC_DWORD_STAT_BY(STAT_RuntimeMesh_VolatileBytesWritten, TotalVertexBytes + TotalIndices * sizeof(uint32));
+	}
+
+	// Every section draws this frame from wherever it already is
+	for (const FSectionSlot& Slot : Sections)
+	{
+		Slot.Section->SetVolatileRange(Slot.VertexByteOffset / Slot.Stride, Slot.FirstIndex, LastCommittedFrame);
+	}
+}
+
+void FRuntimeMeshVolatileRingBuffer::ReleaseRHI()
+{
+	for (int32 RingIndex = 0; RingIndex < NumRingFrames; RingIndex++)
+	{
+		VertexRing[RingIndex].SafeRelease();
+		IndexRing[RingIndex].SafeRelease();
+		VertexRingCapacity[RingIndex] = 0;
+		IndexRingCapacity[RingIndex] = 0;
+	}
+
+	VertexBuffer.VertexBufferRHI.SafeRelease();
+	IndexBuffer.IndexBufferRHI.SafeRelease();
+	LastCommittedFrame = MAX_uint32;
+
+	// Nothing written survives, so the next commit starts from scratch
+	for (int32 RingIndex = 0; RingIndex < NumRingFrames; RingIndex++)
+	{
+		RingLayoutGeneration[RingIndex] = 0;
+	}
+}
+
+
+
+/*
+ *	Sets the loose parameters of the instancing path of the local vertex factory shader. Sections have no fading 
+ *	or LOD transitions between instances, so these are the same for every draw.
+ */
+class FRuntimeMeshInstancedVertexFactoryShaderParameters : public FVertexFactoryShaderParameters
+{
+public:
+	virtual void Bind(const FShaderParameterMap& ParameterMap) override
+	{
+		InstancingFadeOutParamsParameter.Bind(ParameterMap, TEXT("InstancingFadeOutParams"));
+		InstancingViewZCompareZeroParameter.Bind(ParameterMap, TEXT("InstancingViewZCompareZero"));
+		InstancingViewZCompareOneParameter.Bind(ParameterMap, TEXT("InstancingViewZCompareOne"));
+		InstancingViewZConstantParameter.Bind(ParameterMap, TEXT("InstancingViewZConstant"));
+		InstancingWorldViewOriginZeroParameter.Bind(ParameterMap, TEXT("InstancingWorldViewOriginZero"));
+		InstancingWorldViewOriginOneParameter.Bind(ParameterMap, TEXT("InstancingWorldViewOriginOne"));
+	}
+
+	virtual void Serialize(FArchive& Ar) override
+	{
+		Ar << InstancingFadeOutParamsParameter;
+		Ar << InstancingViewZCompareZeroParameter;
+		Ar << InstancingViewZCompareOneParameter;
+		Ar << InstancingViewZConstantParameter;
+		Ar << InstancingWorldViewOriginZeroParameter;
+		Ar << InstancingWorldViewOriginOneParameter;
+	}
+
+	virtual void SetMesh(FRHICommandList& RHICmdList, FShader* VertexShader, const FVertexFactory* VertexFactory, const FSceneView& View, const FMeshBatchElement& BatchElement, uint32 DataFlags) const override
+	{
+		FVertexShaderRHIParamRef ShaderRHI = VertexShader->GetVertexShader();
+
+		// Never faded out by distance, and drawn whether or not the component is selected
+		SetShaderValue(RHICmdList, ShaderRHI, InstancingFadeOutParamsParameter, FVector4(0.0f, 0.0f, 1.0f, 1.0f));
+
+		// Every instance is in the same LOD
+		SetShaderValue(RHICmdList, ShaderRHI, InstancingViewZCompareZeroParameter, FVector4(MIN_flt, MIN_flt, MAX_flt, 1.0f));
+		SetShaderValue(RHICmdList, ShaderRHI, InstancingViewZCompareOneParameter, FVector4(MIN_flt, MIN_flt, MAX_flt, 0.0f));
+		SetShaderValue(RHICmdList, ShaderRHI, InstancingViewZConstantParameter, FVector4(ForceInit));
+		SetShaderValue(RHICmdList, ShaderRHI, InstancingWorldViewOriginZeroParameter, FVector4(ForceInit));
+		SetShaderValue(RHICmdList, ShaderRHI, InstancingWorldViewOriginOneParameter, FVector4(0.0f, 0.0f, 0.0f, 1.0f));
+	}
+
+	virtual uint32 GetSize() const override { return sizeof(*this); }
+
+private:
+	FShaderParameter InstancingFadeOutParamsParameter;
+	FShaderParameter InstancingViewZCompareZeroParameter;
+	FShaderParameter InstancingViewZCompareOneParameter;
+	FShaderParameter InstancingViewZConstantParameter;
+	FShaderParameter InstancingWorldViewOriginZeroParameter;
+	FShaderParameter InstancingWorldViewOriginOneParameter;
+};
+
+
+void FRuntimeMeshInstancedVertexFactory::Init(const RuntimeMeshVertexStructure& VertexStructure, const FRuntimeMeshInstanceBuffer& InstanceBuffer)
+{
+	check(IsInRenderingThread());
+
+	typedef FRuntimeMeshInstanceBuffer::FInstance FInstance;
+	InstanceOriginComponent = FVertexStreamComponent(&InstanceBuffer, STRUCT_OFFSET(FInstance, Origin), sizeof(FInstance), VET_Float4, true);
+	for (int32 RowIndex = 0; RowIndex < 3; RowIndex++)
+	{
+		InstanceTransformComponent[RowIndex] = FVertexStreamComponent(&InstanceBuffer, STRUCT_OFFSET(FInstance, Transform) + RowIndex * sizeof(FVector4), sizeof(FInstance), VET_Float4, true);
+	}
+	InstanceLightmapAndShadowMapUVBiasComponent = FVertexStreamComponent(&InstanceBuffer, STRUCT_OFFSET(FInstance, LightmapAndShadowMapUVBias), sizeof(FInstance), VET_Float4, true);
+
+	// Rebuilds the declaration if we're already initialized
+	SetData(VertexStructure);
+}
+
+bool FRuntimeMeshInstancedVertexFactory::ShouldCache(EShaderPlatform Platform, const FMaterial* Material, const FShaderType* ShaderType)
+{
+	return (Material->IsUsedWithInstancedStaticMeshes() || Material->IsSpecialEngineMaterial()) && FLocalVertexFactory::ShouldCache(Platform, Material, ShaderType);
+}
+
+void FRuntimeMeshInstancedVertexFactory::ModifyCompilationEnvironment(EShaderPlatform Platform, const FMaterial* Material, FShaderCompilerEnvironment& OutEnvironment)
+{
+	FLocalVertexFactory::ModifyCompilationEnvironment(Platform, Material, OutEnvironment);
+	OutEnvironment.SetDefine(TEXT("USE_INSTANCING"), TEXT("1"));
+}
+
+FVertexFactoryShaderParameters* FRuntimeMeshInstancedVertexFactory::ConstructShaderParameters(EShaderFrequency ShaderFrequency)
+{
+	return ShaderFrequency == SF_Vertex ? new FRuntimeMeshInstancedVertexFactoryShaderParameters() : nullptr;
+}
+
+void FRuntimeMeshInstancedVertexFactory::InitRHI()
+{
+	// Same attributes as the local vertex factory, plus the instance streams the instancing path of its shader reads
+	FVertexDeclarationElementList Elements;
+	if (Data.PositionComponent.VertexBuffer != nullptr)
+	{
+		Elements.Add(AccessStreamComponent(Data.PositionComponent, 0));
+	}
+
+	// Only the tangent and normal are streamed, the binormal is derived in the shader
+	uint8 TangentBasisAttributes[2] = { 1, 2 };
+	for (int32 AxisIndex = 0; AxisIndex < 2; AxisIndex++)
+	{
+		if (Data.TangentBasisComponents[AxisIndex].VertexBuffer != nullptr)
+		{
+			Elements.Add(AccessStreamComponent(Data.TangentBasisComponents[AxisIndex], TangentBasisAttributes[AxisIndex]));
+		}
+	}
+
+	if (Data.ColorComponent.VertexBuffer != nullptr)
+	{
+		Elements.Add(AccessStreamComponent(Data.ColorComponent, 3));
+	}
+	else
+	{
+		// Without colors, read white from the null color buffer with a stride of 0
+		FVertexStreamComponent NullColorComponent(&GNullColorVertexBuffer, 0, 0, VET_Color);
+		Elements.Add(AccessStreamComponent(NullColorComponent, 3));
+	}
+
+	if (Data.TextureCoordinates.Num())
+	{
+		const int32 BaseTexCoordAttribute = 4;
+		for (int32 CoordinateIndex = 0; CoordinateIndex < Data.TextureCoordinates.Num(); CoordinateIndex++)
+		{
+			Elements.Add(AccessStreamComponent(Data.TextureCoordinates[CoordinateIndex], BaseTexCoordAttribute + CoordinateIndex));
+		}
+
+		// The shader reads every channel, so the unused ones repeat the last
+		for (int32 CoordinateIndex = Data.TextureCoordinates.Num(); CoordinateIndex < MAX_STATIC_TEXCOORDS / 2; CoordinateIndex++)
+		{
+			Elements.Add(AccessStreamComponent(Data.TextureCoordinates[Data.TextureCoordinates.Num() - 1], BaseTexCoordAttribute + CoordinateIndex));
+		}
+	}
+
+	Elements.Add(AccessStreamComponent(InstanceOriginComponent, 8));
+	for (int32 RowIndex = 0; RowIndex < 3; RowIndex++)
+	{
+		Elements.Add(AccessStreamComponent(InstanceTransformComponent[RowIndex], 9 + RowIndex));
+	}
+	Elements.Add(AccessStreamComponent(InstanceLightmapAndShadowMapUVBiasComponent, 12));
+
+	if (Data.LightMapCoordinateComponent.VertexBuffer != nullptr)
+	{
+		Elements.Add(AccessStreamComponent(Data.LightMapCoordinateComponent, 15));
+	}
+	else if (Data.TextureCoordinates.Num())
+	{
+		Elements.Add(AccessStreamComponent(Data.TextureCoordinates[0], 15));
+	}
+
+	InitDeclaration(Elements, Data);
+}
+
+// Compiled from the engine's local vertex factory shader. Sections have no static lighting
+IMPLEMENT_VERTEX_FACTORY_TYPE(FRuntimeMeshInstancedVertexFactory, "LocalVertexFactory", true, false, true, false, false);
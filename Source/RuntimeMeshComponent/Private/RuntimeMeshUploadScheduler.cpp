@@ -0,0 +1,207 @@
+// Copyright 2016 Chris Conway (Koderz). All Rights Reserved.
+
+#include "RuntimeMeshComponentPluginPrivatePCH.h"
+#include "RuntimeMeshUploadScheduler.h"
+
+
+FRuntimeMeshUploadScheduler& FRuntimeMeshUploadScheduler::Get()
+{
+	check(IsInGameThread());
+
+	static FRuntimeMeshUploadScheduler Scheduler;
+	return Scheduler;
+}
+
+FRuntimeMeshUploadScheduler::FRuntimeMeshUploadScheduler()
+	: BytesPerFrame(DefaultBytesPerFrame)
+	, MillisecondsPerFrame(DefaultMillisecondsPerFrame)
+	, LastDrainFrame(0)
+{
+}
+
+void FRuntimeMeshUploadScheduler::SetFrameBudget(int32 InBytesPerFrame, float InMillisecondsPerFrame)
+{
+	BytesPerFrame = FMath::Max(InBytesPerFrame, 0);
+	MillisecondsPerFrame = FMath::Max(InMillisecondsPerFrame, 0.0f);
+}
+
+void FRuntimeMeshUploadScheduler::Schedule(URuntimeMeshComponent* Component, int32 SectionIndex, ERuntimeMeshSectionBatchUpdateType Updates)
+{
+	check(IsInGameThread());
+	check(Component && Component->SceneProxy);
+
+	FUploadKey Key(Component, SectionIndex);
+	FRuntimeMeshPendingUpload* Upload = PendingUploads.Find(Key);
+
+	// Merge with the upload already waiting, unless the proxy it was queued for has been replaced since
+	if (Upload && Upload->SceneProxy == Component->SceneProxy)
+	{
+		if (!!(Updates & ERuntimeMeshSectionBatchUpdateType::Create))
+		{
+			Upload->Updates = ERuntimeMeshSectionBatchUpdateType::Create;
+		}
+		else if (!(Upload->Updates & ERuntimeMeshSectionBatchUpdateType::Create))
+		{
+			// A create already sends everything, otherwise send the union of both
+			Upload->Updates |= Updates;
+		}
+
+		INC_DWORD_STAT(STAT_RuntimeMesh_ScheduledUploadsCoalesced);
+		return;
+	}
+
+	if (Upload == nullptr)
+	{
+		Upload = &PendingUploads.Add(Key);
+	}
+
+	Upload->Component = Component;
+	Upload->SectionIndex = SectionIndex;
+	Upload->Updates = Updates;
+	Upload->SceneProxy = Component->SceneProxy;
+
+	SET_DWORD_STAT(STAT_RuntimeMesh_ScheduledUploadsPending, PendingUploads.Num());
+}
+
+void FRuntimeMeshUploadScheduler::Unschedule(URuntimeMeshComponent* Component, int32 SectionIndex)
+{
+	check(IsInGameThread());
+
+	if (PendingUploads.Remove(FUploadKey(Component, SectionIndex)) > 0)
+	{
+		SET_DWORD_STAT(STAT_RuntimeMesh_ScheduledUploadsPending, PendingUploads.Num());
+	}
+}
+
+bool FRuntimeMeshUploadScheduler::IsScheduled(URuntimeMeshComponent* Component, int32 SectionIndex) const
+{
+	check(IsInGameThread());
+
+	return PendingUploads.Contains(FUploadKey(Component, SectionIndex));
+}
+
+bool FRuntimeMeshUploadScheduler::PrepareUpload(FRuntimeMeshPendingUpload& Upload)
+{
+	URuntimeMeshComponent* Component = Upload.Component.Get();
+
+	// Drop the upload if the component's gone, or its proxy has been recreated since with the latest data
+	if (Component == nullptr || Component->SceneProxy == nullptr || Component->SceneProxy != Upload.SceneProxy)
+	{
+		return false;
+	}
+
+	// Drop the upload if the section's gone or has become part of the static draw path
+	if (!Component->MeshSections.IsValidIndex(Upload.SectionIndex) || !Component->MeshSections[Upload.SectionIndex].IsValid() ||
+		Component->MeshSections[Upload.SectionIndex]->UpdateFrequency == EUpdateFrequency::Infrequent)
+	{
+		return false;
+	}
+
+	const RuntimeMeshSectionPtr& Section = Component->MeshSections[Upload.SectionIndex];
+
+	const bool bIsCreate = !!(Upload.Updates & ERuntimeMeshSectionBatchUpdateType::Create);
+	Upload.UploadSize = Section->GetUploadSize(
+		bIsCreate || !!(Upload.Updates & ERuntimeMeshSectionBatchUpdateType::PositionsUpdate),
+		bIsCreate || !!(Upload.Updates & (ERuntimeMeshSectionBatchUpdateType::VerticesUpdate | ERuntimeMeshSectionBatchUpdateType::StreamsUpdate)),
+		bIsCreate || !!(Upload.Updates & ERuntimeMeshSectionBatchUpdateType::IndicesUpdate));
+
+	Upload.Priority = Component->UploadPriority;
+
+	UWorld* World = Component->GetWorld();
+	Upload.bIsVisible = Section->bIsVisible && World != nullptr && (World->GetTimeSeconds() - Component->LastRenderTime) <= RecentlyRenderedTime;
+
+	// Distance from the section to the nearest viewer. New sections may not have bounds yet so fall back to the component's
+	const FBox SectionBounds = Section->LocalBoundingBox.IsValid
+		? Section->LocalBoundingBox.TransformBy(Component->ComponentToWorld)
+		: Component->Bounds.GetBox();
+
+	Upload.DistanceSquared = MAX_flt;
+	if (World != nullptr)
+	{
+		for (const FVector& ViewLocation : World->ViewLocationsRenderedLastFrame)
+		{
+			Upload.DistanceSquared = FMath::Min(Upload.DistanceSquared, SectionBounds.ComputeSquaredDistanceToPoint(ViewLocation));
+		}
+	}
+
+	return true;
+}
+
+void FRuntimeMeshUploadScheduler::Drain()
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_DrainUploadScheduler);
+	check(IsInGameThread());
+
+	// Gather the uploads that are still needed. Anything not sent this frame is queued again below.
+	TArray<FRuntimeMeshPendingUpload> Uploads;
+	Uploads.Reserve(PendingUploads.Num());
+	for (auto& Entry : PendingUploads)
+	{
+		if (PrepareUpload(Entry.Value))
+		{
+			Uploads.Add(Entry.Value);
+		}
+	}
+	PendingUploads.Reset();
+
+	Uploads.Sort([](const FRuntimeMeshPendingUpload& A, const FRuntimeMeshPendingUpload& B)
+	{
+		if (A.Priority != B.Priority)
+		{
+			return A.Priority > B.Priority;
+		}
+		if (A.bIsVisible != B.bIsVisible)
+		{
+			return A.bIsVisible;
+		}
+		return A.DistanceSquared < B.DistanceSquared;
+	});
+
+	const double StartTime = FPlatformTime::Seconds();
+	int32 BytesSent = 0;
+	int32 NumSent = 0;
+	bool bIsBudgetSpent = false;
+
+	for (const FRuntimeMeshPendingUpload& Upload : Uploads)
+	{
+		// Always send at least one upload so sections larger than the budget still get through
+		if (!bIsBudgetSpent && NumSent > 0)
+		{
+			const bool bIsOverBytes = BytesPerFrame > 0 && BytesSent + Upload.UploadSize > BytesPerFrame;
+			const bool bIsOverTime = MillisecondsPerFrame > 0.0f && (FPlatformTime::Seconds() - StartTime) * 1000.0 >= MillisecondsPerFrame;
+			bIsBudgetSpent = bIsOverBytes || bIsOverTime;
+		}
+
+		if (bIsBudgetSpent)
+		{
+			PendingUploads.Add(FUploadKey(Upload.Component.Get(), Upload.SectionIndex), Upload);
+			continue;
+		}
+
+		Upload.Component->SendScheduledUpload(Upload.SectionIndex, Upload.Updates);
+
+		BytesSent += Upload.UploadSize;
+		NumSent++;
+	}
+
+	INC_DWORD_STAT_BY(STAT_RuntimeMesh_ScheduledUploadsSent, NumSent);
+	INC_DWORD_STAT_BY(STAT_RuntimeMesh_ScheduledUploadBytesSent, BytesSent);
+	SET_DWORD_STAT(STAT_RuntimeMesh_ScheduledUploadsPending, PendingUploads.Num());
+}
+
+void FRuntimeMeshUploadScheduler::Tick(float DeltaTime)
+{
+	// Every ticking world ticks us, but the budget is per frame
+	if (LastDrainFrame == GFrameCounter)
+	{
+		return;
+	}
+	LastDrainFrame = GFrameCounter;
+
+	Drain();
+}
+
+TStatId FRuntimeMeshUploadScheduler::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(FRuntimeMeshUploadScheduler, STATGROUP_Tickables);
+}
@@ -0,0 +1,56 @@
+// Copyright 2016 Chris Conway (Koderz). All Rights Reserved.
+
+#pragma once
+
+#include "Engine.h"
+
+
+/*
+ *	Bounding box kernels for vertex data. Positions are read with vector loads straight out of the vertex structs, so
+ *	any vertex layout works without gathering the positions first. Copies are done in blocks, with the bounds of each
+ *	block taken while it's still in cache.
+ */
+struct RUNTIMEMESHCOMPONENT_API FRuntimeMeshBounds
+{
+	/* Calculates the bounds of Count positions, the first at FirstPosition and each after it Stride bytes further on */
+	static FBox CalculateStrided(const FVector* FirstPosition, int32 Count, int32 Stride);
+
+	/* Calculates the bounds of an array of positions */
+	static FBox Calculate(const FVector* Positions, int32 Count)
+	{
+		return CalculateStrided(Positions, Count, sizeof(FVector));
+	}
+
+	/* Calculates the bounds of the positions of an array of vertices */
+	template<typename VertexType>
+	static FBox Calculate(const VertexType* Vertices, int32 Count)
+	{
+		return Count > 0 ? CalculateStrided(&Vertices[0].Position, Count, sizeof(VertexType)) : FBox(0);
+	}
+
+	/* Copies an array of positions, returning their bounds */
+	static FBox CopyAndCalculate(FVector* Dest, const FVector* Source, int32 Count);
+
+	/* Copies an array of vertices, returning the bounds of their positions */
+	template<typename VertexType>
+	static FBox CopyAndCalculate(VertexType* Dest, const VertexType* Source, int32 Count)
+	{
+		const int32 BlockSize = FMath::Max(CopyBlockBytes / (int32)sizeof(VertexType), 1);
+
+		FBox Bounds(0);
+		for (int32 First = 0; First < Count; First += BlockSize)
+		{
+			const int32 NumInBlock = FMath::Min(BlockSize, Count - First);
+			CopyAssignItems(Dest + First, Source + First, NumInBlock);
+			Bounds += Calculate(Dest + First, NumInBlock);
+		}
+		return Bounds;
+	}
+
+	/* Times the kernels against plain FBox loops and logs the results */
+	static void RunBenchmark();
+
+private:
+	/* Size of the blocks copies are split into, small enough to still be in L1 when the bounds are taken */
+	static const int32 CopyBlockBytes = 16 * 1024;
+};
@@ -0,0 +1,224 @@
+// Copyright 2016 Chris Conway (Koderz). All Rights Reserved.
+
+#pragma once
+
+#include "Engine.h"
+#include "RuntimeMeshCore.h"
+
+
+/*
+ *	Tracks the free ranges of a buffer. Ranges are handed out first fit, and
+ *	neighbouring free ranges are merged back together as they're returned.
+ */
+class RUNTIMEMESHCOMPONENT_API FRuntimeMeshFreeList
+{
+public:
+	FRuntimeMeshFreeList() : Capacity(0) { }
+
+	/* Marks the whole buffer as free */
+	void Reset(int32 InCapacity);
+
+	/* Finds space for Count elements. Returns false if there's no range large enough */
+	bool Allocate(int32 Count, int32& OutStart);
+
+	/* Claims a specific range, which must currently be free. Returns false if it isn't */
+	bool AllocateAt(int32 Start, int32 Count);
+
+	/* Returns a range to the free list */
+	void Free(int32 Start, int32 Count);
+
+	/* Gets the total size of the buffer */
+	int32 GetCapacity() const { return Capacity; }
+
+	/* Gets the number of free elements */
+	int32 GetTotalFree() const;
+
+	/* Gets the size of the largest free range */
+	int32 GetLargestFree() const;
+
+	/* Gets the number of separate free ranges */
+	int32 GetNumFreeRanges() const { return FreeSpans.Num(); }
+
+private:
+	/* Free ranges, sorted by start */
+	TArray<FRuntimeMeshBufferSpan> FreeSpans;
+
+	/* Total size of the buffer */
+	int32 Capacity;
+};
+
+
+/* A range of a pooled page owned by a single section */
+struct FRuntimeMeshPoolAllocation
+{
+	/* The page the ranges live in */
+	class FRuntimeMeshBufferPoolPage* Page;
+
+	/* Range of the page vertex buffer, in vertices */
+	FRuntimeMeshBufferSpan Vertices;
+
+	/* Range of the page index buffer, in indices */
+	FRuntimeMeshBufferSpan Indices;
+
+	/* Pinned allocations are never moved by defragmentation, as the static draw path caches their offsets */
+	bool bIsPinned;
+
+	/* Incremented whenever defragmentation moves the allocation, so anything caching its offsets knows to refresh them */
+	uint32 Generation;
+
+	FRuntimeMeshPoolAllocation() : Page(nullptr), bIsPinned(false), Generation(0) { }
+};
+
+
+/*
+ *	A pair of large vertex/index buffers shared by many sections with the same vertex stride. The page keeps a
+ *	copy of its contents, as locking part of a buffer doesn't keep the rest of it on every RHI. Writes go to the
+ *	copy and the buffers are uploaded whole when the pool is flushed. The copy also lets the buffers be recreated.
+ */
+class RUNTIMEMESHCOMPONENT_API FRuntimeMeshBufferPoolPage
+{
+public:
+	FRuntimeMeshBufferPoolPage(int32 InVertexStride, bool bInIsPinned, int32 InVertexCapacity, int32 InIndexCapacity);
+	~FRuntimeMeshBufferPoolPage();
+
+	/* Gets the vertex buffer the vertex factories of sections in this page are bound to */
+	const FVertexBuffer& GetVertexBuffer() const { return VertexBuffer; }
+
+	/* Gets the index buffer the sections in this page draw with. Always 32 bit */
+	const FIndexBuffer& GetIndexBuffer() const { return IndexBuffer; }
+
+private:
+	/* Creates the RHI buffers and fills them from the copy */
+	void InitRHI();
+
+	/* Frees the RHI buffers */
+	void ReleaseRHI();
+
+	/* Uploads the whole copy of any buffer that was written since it was last uploaded */
+	void Flush();
+
+	FVertexBuffer VertexBuffer;
+	FIndexBuffer IndexBuffer;
+
+	/* Copy of the buffer contents */
+	TArray<uint8> VertexData;
+	TArray<uint32> IndexData;
+
+	/* Has the copy been written since the buffers were last uploaded */
+	bool bIsVertexDataDirty;
+	bool bIsIndexDataDirty;
+
+	/* Size of a single vertex */
+	const int32 VertexStride;
+
+	/* Does this page hold pinned allocations */
+	const bool bIsPinned;
+
+	FRuntimeMeshFreeList VertexFreeList;
+	FRuntimeMeshFreeList IndexFreeList;
+
+	/* All allocations currently in this page */
+	TArray<FRuntimeMeshPoolAllocation*> Allocations;
+
+	friend class FRuntimeMeshBufferPool;
+};
+
+
+/* Snapshot of the pool occupancy */
+struct FRuntimeMeshBufferPoolStats
+{
+	int32 NumPages;
+	int32 NumAllocations;
+	int64 AllocatedBytes;
+	int64 UsedBytes;
+	int64 FreeBytes;
+	int64 LargestFreeBytes;
+
+	FRuntimeMeshBufferPoolStats() : NumPages(0), NumAllocations(0), AllocatedBytes(0), UsedBytes(0), FreeBytes(0), LargestFreeBytes(0) { }
+
+	/* Fraction of the pool in use */
+	float GetOccupancy() const { return AllocatedBytes > 0 ? (float)UsedBytes / AllocatedBytes : 0.0f; }
+
+	/* Fraction of the free space that isn't part of the largest free range of its page. 0 when all free space is contiguous */
+	float GetFragmentation() const { return FreeBytes > 0 ? 1.0f - (float)LargestFreeBytes / FreeBytes : 0.0f; }
+};
+
+
+/*
+ *	Global pool of vertex/index buffers shared between sections of any component. Sections are given ranges
+ *	of large pages instead of their own buffers, which cuts the number of RHI buffers for scenes with lots
+ *	of small sections. Indices are stored as 32 bit and offset to the allocations vertices, so a section draws
+ *	with only a first index. Pages are static buffers and keyed by vertex stride and whether their
+ *	allocations can be moved. RT only.
+ */
+class RUNTIMEMESHCOMPONENT_API FRuntimeMeshBufferPool : public FRenderResource
+{
+public:
+	/* Default size of a page's vertex buffer in bytes. Larger sections get a page of their own */
+	static const int32 DefaultPageVertexBytes = 4 * 1024 * 1024;
+
+	/* Default size of a page's index buffer in indices */
+	static const int32 DefaultPageIndices = 1024 * 1024;
+
+	/* Gets the pool shared by all components */
+	static FRuntimeMeshBufferPool& Get();
+
+	virtual ~FRuntimeMeshBufferPool();
+
+	/* Allocates space for a section */
+	FRuntimeMeshPoolAllocation* Allocate(int32 VertexStride, int32 NumVertices, int32 NumIndices, bool bIsPinned);
+
+	/* Returns a sections space to the pool */
+	void Free(FRuntimeMeshPoolAllocation* Allocation);
+
+	/*
+	 *	Resizes an allocation, growing in place where possible. If either range has to move its contents
+	 *	are lost, so both vertices and indices must be rewritten. Returns true if the allocation changed page.
+	 */
+	bool Resize(FRuntimeMeshPoolAllocation* Allocation, int32 NumVertices, int32 NumIndices);
+
+	/* Writes vertices into an allocation starting at FirstVertex. Not visible to the GPU until Flush() */
+	void WriteVertices(FRuntimeMeshPoolAllocation* Allocation, const void* Vertices, int32 FirstVertex, int32 NumVertices);
+
+	/* 
+	 *	Writes NumIndices indices, starting at SourceIndex, into an allocation at FirstIndex, offsetting them to the 
+	 *	allocations vertices. Not visible to the GPU until Flush()
+	 */
+	void WriteIndices(FRuntimeMeshPoolAllocation* Allocation, const FRuntimeMeshIndexData& Indices, int32 SourceIndex, int32 FirstIndex, int32 NumIndices);
+
+	/* Uploads every page written since the last flush. Each page is uploaded whole, so write everything for a section first */
+	void Flush();
+
+	/* Compacts all pages, moving unpinned allocations down to close gaps, and frees empty pages */
+	void Defragment();
+
+	/* Gets the current pool occupancy */
+	FRuntimeMeshBufferPoolStats GetStats() const;
+
+	/* Writes the pool occupancy to the log */
+	void LogStats() const;
+
+	virtual void InitRHI() override;
+	virtual void ReleaseRHI() override;
+
+private:
+	/* Finds a page with room for the allocation, creating one if necessary */
+	void AllocateInPage(FRuntimeMeshPoolAllocation* Allocation, int32 VertexStride, int32 NumVertices, int32 NumIndices);
+
+	/* Tries to fit an allocation in a specific page */
+	bool TryAllocateInPage(FRuntimeMeshBufferPoolPage* Page, FRuntimeMeshPoolAllocation* Allocation, int32 NumVertices, int32 NumIndices);
+
+	/* Releases an allocations ranges from its page */
+	void FreeFromPage(FRuntimeMeshPoolAllocation* Allocation);
+
+	/* Resizes one range of an allocation within its page. Returns false if it doesn't fit */
+	static bool ResizeSpan(FRuntimeMeshFreeList& FreeList, FRuntimeMeshBufferSpan& Span, int32 NewCount);
+
+	/* Compacts a single page */
+	void DefragmentPage(FRuntimeMeshBufferPoolPage* Page);
+
+	/* Pushes the occupancy to the stats system */
+	void UpdateStats() const;
+
+	TArray<FRuntimeMeshBufferPoolPage*> Pages;
+};
@@ -0,0 +1,137 @@
+// Copyright 2016 Chris Conway (Koderz). All Rights Reserved.
+
+#pragma once
+
+#include "Engine.h"
+
+
+/*
+ *	Bounding volume hierarchy over the sections of a single component, so a view can cull whole regions
+ *	of sections with a single test. The leaves are chunks of nearby sections, which are also what gets
+ *	occlusion tested. Sections without bounds are left out, and have to be handled by the caller.
+ *	Built and used on the RT only.
+ */
+class RUNTIMEMESHCOMPONENT_API FRuntimeMeshChunkTree
+{
+public:
+	FRuntimeMeshChunkTree() { }
+
+	/* Rebuilds the tree from the local bounds of each section. Sections with invalid bounds aren't added */
+	void Build(const TArray<FBox>& SectionBounds, int32 MaxSectionsPerChunk);
+
+	/* Updates the bounds of the chunks and nodes for sections that have moved, without changing which chunk they're in */
+	void Refit(const TArray<FBox>& SectionBounds);
+
+	/* Removes everything from the tree */
+	void Reset();
+
+	/* Is a section part of the tree */
+	bool ContainsSection(int32 SectionIndex) const { return SectionIndex < SectionInTree.Num() && SectionInTree[SectionIndex]; }
+
+	/* Gets the number of chunks, the leaves of the tree */
+	int32 GetNumChunks() const { return Chunks.Num(); }
+
+	/* Gets the local bounds of a chunk */
+	const FBox& GetChunkBounds(int32 ChunkIndex) const { return Chunks[ChunkIndex].Bounds; }
+
+	/* Gets the sections in a chunk */
+	const int32* GetChunkSections(int32 ChunkIndex) const { return SectionIndices.GetData() + Chunks[ChunkIndex].FirstSection; }
+	int32 GetChunkNumSections(int32 ChunkIndex) const { return Chunks[ChunkIndex].NumSections; }
+
+	/*
+	 *	Calls Visitor(ChunkIndex, bFullyContained) for every chunk intersecting the frustum. Nodes entirely inside
+	 *	the frustum pass that on to their chunks without testing them again. Returns the number of chunks culled.
+	 */
+	template<typename VisitorType>
+	int32 ForEachChunkInFrustum(const FConvexVolume& Frustum, const FMatrix& LocalToWorld, VisitorType Visitor) const
+	{
+		if (Nodes.Num() == 0)
+		{
+			return 0;
+		}
+
+		int32 NumChunksCulled = 0;
+
+		struct FStackEntry
+		{
+			int32 NodeIndex;
+			bool bFullyContained;
+		};
+		TArray<FStackEntry, TInlineAllocator<64>> Stack;
+		Stack.Add({ 0, false });
+
+		while (Stack.Num() > 0)
+		{
+			const FStackEntry Entry = Stack.Pop(false);
+			const FNode& Node = Nodes[Entry.NodeIndex];
+
+			// Nodes whose sections have all lost their bounds since the last build have nothing to draw
+			if (!Node.Bounds.IsValid)
+			{
+				NumChunksCulled += Node.NumChunks;
+				continue;
+			}
+
+			bool bFullyContained = Entry.bFullyContained;
+			if (!bFullyContained)
+			{
+				const FBox WorldBounds = Node.Bounds.TransformBy(LocalToWorld);
+				if (!Frustum.IntersectBox(WorldBounds.GetCenter(), WorldBounds.GetExtent(), bFullyContained))
+				{
+					NumChunksCulled += Node.NumChunks;
+					continue;
+				}
+			}
+
+			if (Node.ChunkIndex != INDEX_NONE)
+			{
+				Visitor(Node.ChunkIndex, bFullyContained);
+			}
+			else
+			{
+				Stack.Add({ Node.FirstChild, bFullyContained });
+				Stack.Add({ Node.FirstChild + 1, bFullyContained });
+			}
+		}
+
+		return NumChunksCulled;
+	}
+
+private:
+	/* Fills in an already added node with the sections in SectionIndices[First, First + Count), adding everything below it */
+	void BuildNode(int32 NodeIndex, const TArray<FVector>& SectionCenters, int32 First, int32 Count, int32 MaxSectionsPerChunk);
+
+	struct FNode
+	{
+		FBox Bounds;
+
+		/* Index of the first of two children, which are always next to each other. INDEX_NONE for leaves */
+		int32 FirstChild;
+
+		/* Chunk held by a leaf. INDEX_NONE for inner nodes */
+		int32 ChunkIndex;
+
+		/* Number of chunks below this node */
+		int32 NumChunks;
+	};
+
+	struct FChunk
+	{
+		FBox Bounds;
+
+		/* Range of SectionIndices holding the sections of this chunk */
+		int32 FirstSection;
+		int32 NumSections;
+	};
+
+	/* All nodes, with the root first. Children always come after their parent */
+	TArray<FNode> Nodes;
+
+	TArray<FChunk> Chunks;
+
+	/* Indices of the sections in the tree, grouped by chunk */
+	TArray<int32> SectionIndices;
+
+	/* Which sections are part of the tree */
+	TBitArray<> SectionInTree;
+};
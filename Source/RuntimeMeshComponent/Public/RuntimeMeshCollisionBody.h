@@ -0,0 +1,89 @@
+// Copyright 2016 Chris Conway (Koderz). All Rights Reserved.
+
+#pragma once
+
+#include "Engine.h"
+#include "SecureHash.h"
+#include "RuntimeMeshCollisionBody.generated.h"
+
+
+/*
+ *	Collision for a single section of a URuntimeMeshComponent, with its own body setup and physics body, so changing one
+ *	section only recooks that section. Holds a copy of the section's collision geometry, which is what gets cooked, so
+ *	the collision cache can be searched on any thread while the section keeps changing.
+ */
+UCLASS(Transient)
+class RUNTIMEMESHCOMPONENT_API URuntimeMeshCollisionBody : public UObject, public IInterface_CollisionDataProvider
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+	/* Sets up the body for a section, taking the geometry to cook. Vertices are moved from */
+	void SetCollisionData(bool bInIsCollisionSection, int32 InSectionIndex, TArray<FVector>& Vertices, const TArray<int32>& Triangles, bool bUseComplexAsSimpleCollision);
+
+	/* Fills in the cooked data from the collision cache, returning whether it was found. Safe to call from any thread */
+	bool LoadFromCollisionCache();
+
+	/* Cooks the geometry into the body setup, optionally through the collision cache. Does nothing if LoadFromCollisionCache() found it. Game thread only */
+	void Cook(bool bUseCollisionCache);
+
+	/* Creates the physics meshes, cooking first if Cook() hasn't been called. Game thread only */
+	void CreatePhysicsMeshes();
+
+	/* Creates the physics body in the scene of the owning component, with its collision settings */
+	void InitBody(UPrimitiveComponent* Owner);
+
+	/* Copies the collision settings of the owning component to the running physics body */
+	void UpdateCollisionSettings(UPrimitiveComponent* Owner);
+
+	/* Removes the physics body from the scene */
+	void TermBody();
+
+	/* Moves the physics body to follow the owning component */
+	void SetBodyTransform(const FTransform& NewTransform, ETeleportType Teleport);
+
+	/* Stops a cook that hasn't started yet and keeps the result from being used */
+	void Cancel() { bIsCancelled = true; }
+	bool IsCancelled() const { return bIsCancelled; }
+
+	/* Is this the body of a collision only section, or of a render section */
+	bool IsCollisionSection() const { return bIsCollisionSection; }
+	int32 GetSectionIndex() const { return SectionIndex; }
+
+	UBodySetup* GetBodySetup() const { return BodySetup; }
+
+	//~ Begin Interface_CollisionDataProvider Interface
+	virtual bool GetPhysicsTriMeshData(struct FTriMeshCollisionData* OutCollisionData, bool InUseAllTriData) override;
+	virtual bool ContainsPhysicsTriMeshData(bool InUseAllTriData) const override;
+	virtual bool WantsNegXTriMesh() override { return false; }
+	//~ End Interface_CollisionDataProvider Interface
+
+	//~ Begin UObject Interface
+	virtual void BeginDestroy() override;
+	//~ End UObject Interface
+
+private:
+	/* Body setup holding the cooked section */
+	UPROPERTY()
+	UBodySetup* BodySetup;
+
+	/* Copies the collision enabled state, object type and responses of the owning component */
+	void CopyCollisionSettings(UPrimitiveComponent* Owner, bool bUpdatePhysicsFilterData);
+
+	/* Physics body of the section */
+	FBodyInstance BodyInstance;
+
+	/* Copy of the section's geometry the body setup is cooked from */
+	FTriMeshCollisionData CollisionData;
+
+	/* Set when the section changed again before this body was swapped in */
+	FThreadSafeBool bIsCancelled;
+
+	/* Set by LoadFromCollisionCache(), along with the key a miss is cooked into the cache under */
+	bool bIsCookedDataLoaded;
+	bool bHasCacheKey;
+	FSHAHash CacheKey;
+
+	bool bIsCollisionSection;
+	int32 SectionIndex;
+};
@@ -0,0 +1,116 @@
+// Copyright 2016 Chris Conway (Koderz). All Rights Reserved.
+
+#pragma once
+
+#include "Engine.h"
+#include "SecureHash.h"
+
+
+/*
+ *	Cache of cooked collision, keyed by a hash of the collision geometry and every body setup and project physics setting 
+ *	the cook depends on, so regenerating a mesh identical to one cooked before reuses the cooked data instead of cooking it again. Recently used
+ *	entries are held in memory up to a size limit, with the least recently used thrown out first. Entries can also be written
+ *	to the saved directory, so they're still around after the memory cache drops them or the game restarts. The files on
+ *	disk have their own size limit, with the files least recently written or read removed first.
+ *	Lookups are safe from any thread, cooking a miss has to happen on the game thread.
+ */
+class RUNTIMEMESHCOMPONENT_API FRuntimeMeshCollisionCache
+{
+public:
+	/* Default size of the memory cache */
+	static const int64 DefaultMaxMemory = 64 * 1024 * 1024;
+
+	/* Default size of the files stored on disk */
+	static const int64 DefaultMaxDiskSize = 256 * 1024 * 1024;
+
+	/* Gets the cache shared by all components */
+	static FRuntimeMeshCollisionCache& Get();
+
+	FRuntimeMeshCollisionCache();
+
+	/* 
+	 *	Sets the size of the memory cache, and whether entries are also stored on disk and how much space they can take there. 
+	 *	A memory size of 0 disables the memory cache. Files over the new disk limit are removed straight away.
+	 */
+	void SetLimits(int64 InMaxMemory, bool bInUseDiskCache, int64 InMaxDiskSize = DefaultMaxDiskSize);
+
+	/* Removes everything from the memory cache. Nothing is removed from disk */
+	void Empty();
+
+	/*
+	 *	Cooks the collision of a body setup, reusing the cooked data of an earlier cook with the same key if there is one.
+	 *	CollisionData is the geometry the body setup's collision data provider gives the cook, or null if it has none.
+	 *	Game thread only.
+	 */
+	void CookBodySetup(UBodySetup* BodySetup, const FTriMeshCollisionData* CollisionData);
+
+	/*
+	 *	Fills in the cooked data of a body setup from an earlier cook with the same key, returning false if there is none.
+	 *	Gives the body setup a guid made from the key, so the editor's derived data cache can also reuse it. Safe to call from 
+	 *	any thread, as long as nothing else is using the body setup. OutKey is what to pass to CookMissedBodySetup() on a miss.
+	 */
+	bool LoadCookedData(UBodySetup* BodySetup, const FTriMeshCollisionData* CollisionData, FSHAHash& OutKey);
+
+	/* Cooks a body setup LoadCookedData() had no entry for, and adds the result under its key. Game thread only */
+	void CookMissedBodySetup(UBodySetup* BodySetup, const FSHAHash& Key);
+
+	/* Logs the number of entries, memory used, and hits and misses */
+	void LogStats();
+
+private:
+	/* Hashes everything the cooked data of a body setup depends on */
+	static FSHAHash ComputeKey(const UBodySetup* BodySetup, const FTriMeshCollisionData* CollisionData, FName Format);
+
+	/* Gets the directory the entries are stored in on disk */
+	static FString GetDiskCacheDir();
+
+	/* Gets the file an entry is stored in on disk */
+	static FString GetDiskCachePath(const FSHAHash& Key);
+
+	/* Writes an entry to disk, removing the oldest files to stay under the disk limit */
+	void AddToDiskCache(const FSHAHash& Key, const TArray<uint8>& CookedData);
+
+	/* Works out the size of the files on disk, and removes the oldest until they fit in MaxDiskSize. DiskLock has to be held */
+	void EvictDiskToLimit();
+
+	/* Adds an entry to the memory cache, evicting the least recently used entries to stay under the limit */
+	void AddToMemoryCache(const FSHAHash& Key, const TArray<uint8>& CookedData);
+
+	/* Removes least recently used entries until the memory cache fits in MaxMemory. Lock has to be held */
+	void EvictToLimit();
+
+	struct FEntry
+	{
+		TArray<uint8> CookedData;
+
+		/* Value of UseCounter when the entry was last used */
+		uint64 LastUsed;
+	};
+
+	/* Guards everything below */
+	FCriticalSection Lock;
+
+	TMap<FSHAHash, FEntry> Entries;
+
+	/* Total size of the cooked data in the memory cache */
+	int64 MemoryUsed;
+
+	int64 MaxMemory;
+	bool bUseDiskCache;
+
+	/* Increased with every use, to order entries by when they were last used */
+	uint64 UseCounter;
+
+	int32 NumHits;
+	int32 NumDiskHits;
+	int32 NumMisses;
+
+	/* Guards the files on disk and everything below, kept apart from Lock so disk access doesn't hold up memory hits */
+	FCriticalSection DiskLock;
+
+	/* Total size of the files on disk, once they've been looked at */
+	int64 DiskUsed;
+	bool bIsDiskUsedKnown;
+
+	int64 MaxDiskSize;
+};
@@ -8,6 +8,8 @@
 #include "RuntimeMeshGenericVertex.h"
 #include "RuntimeMeshBuilder.h"
 #include "PhysicsEngine/ConvexElem.h"
+#include "Async/Async.h"
+#include "SecureHash.h"
 #include "RuntimeMeshComponent.generated.h"
 
 // This set of macros is only meant for argument validation as it will return out of whatever scope.
@@ -48,6 +50,10 @@
 		RMC_VALIDATE_UPDATEPARAMETERS(SectionIndex, RetVal) \
 		RMC_CHECKINGAME_LOGINEDITOR((MeshSections[SectionIndex]->IsDualBufferSection()), "Section is not dual buffer.", RetVal);
 
+#define RMC_VALIDATE_RANGEPARAMETERS(FirstElement, Elements, ExistingLength, RetVal) \
+		RMC_CHECKINGAME_LOGINEDITOR((Elements.Num() > 0), "Range must not be empty.", RetVal); \
+		RMC_CHECKINGAME_LOGINEDITOR((FirstElement >= 0 && FirstElement + Elements.Num() <= ExistingLength), "Range must lie within the existing buffer.", RetVal);
+
 
 
 /* 
@@ -68,6 +74,56 @@ struct RUNTIMEMESHCOMPONENT_API FRuntimeMeshComponentPrePhysicsTickFunction : pu
 	virtual FString DiagnosticMessage() override;
 };
 
+/* State shared between an asynchronous section creation and the component waiting on it */
+struct FRuntimeMeshAsyncSectionState
+{
+	/* Set when the section is replaced or cleared before the async creation finishes */
+	FThreadSafeBool bIsCancelled;
+};
+
+/* Snapshot of the collision geometry an async cook works from, shared between the component and the worker preparing it */
+struct FRuntimeMeshCollisionCookState
+{
+	FRuntimeMeshCollisionCookState()
+		: bHasCollisionData(false)
+		, bIsCookedDataLoaded(false)
+		, bHasCacheKey(false)
+	{
+	}
+
+	/* Collision geometry at the time the cook was started */
+	FTriMeshCollisionData CollisionData;
+	bool bHasCollisionData;
+
+	/* Set by the worker when the cooked data was found in the collision cache, so there's nothing left to cook */
+	bool bIsCookedDataLoaded;
+
+	/* Collision cache key the worker computed, so a miss is stored without hashing the snapshot again */
+	bool bHasCacheKey;
+	FSHAHash CacheKey;
+
+	/* Set when the collision changes again before the cook finishes, so its result is thrown away */
+	FThreadSafeBool bIsCancelled;
+};
+
+/*
+*	This tick function flushes automatic batch updates and deferred bounds updates. It is only enabled while one of those 
+*	is pending, and runs late in the frame so updates made by anything that ticked before it are sent to the RT together.
+*/
+USTRUCT()
+struct RUNTIMEMESHCOMPONENT_API FRuntimeMeshComponentBatchUpdateTickFunction : public FTickFunction
+{
+	GENERATED_USTRUCT_BODY()
+
+	/* Target RMC to tick */
+	class URuntimeMeshComponent* Target;
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread,
+		const FGraphEventRef& MyCompletionGraphEvent) override;
+
+	virtual FString DiagnosticMessage() override;
+};
+
 /**
 *	Component that allows you to specify custom triangle mesh geometry for rendering and collision.
 */
@@ -88,9 +144,25 @@ private:
 			MeshSections.SetNum(SectionIndex + 1, false);
 		}
 
+		// This replaces anything still being built for this section
+		CancelAsyncSection(SectionIndex);
+
 		// Create new section
 		TSharedPtr<SectionType> NewSection = MakeShareable(new SectionType(bWantsSeparatePositionBuffer));
 		NewSection->bIsInternalSectionType = bIsInternalSectionType;
+		NewSection->bUseSharedBufferPool = bUseSharedBufferPool;
+
+		// Replacing a section can shrink the bounds
+		if (MeshSections[SectionIndex].IsValid())
+		{
+			bIsLocalBoundsRebuildPending = true;
+
+			// The old section's collision has to go, even if the new section has none
+			if (MeshSections[SectionIndex]->CollisionEnabled)
+			{
+				SectionsWithDirtyCollision.Add(SectionIndex);
+			}
+		}
 
 		// Store section at index
 		MeshSections[SectionIndex] = NewSection;
@@ -112,14 +184,27 @@ private:
 	/* Finishes creating a section, including entering it for batch updating, or updating the RT directly */
 	void CreateSectionInternal(int32 SectionIndex, ESectionUpdateFlags UpdateFlags);
 
-	/* Finishes updating a section, including entering it for batch updating, or updating the RT directly */
-	void UpdateSectionInternal(int32 SectionIndex, bool bHadVertexPositionsUpdate, bool bHadVertexUpdates, bool bHadIndexUpdates, bool bNeedsBoundsUpdate, ESectionUpdateFlags UpdateFlags);
+	/* Places a section built by CreateMeshSectionAsync() into the component, unless it was cancelled while being built */
+	void FinishCreateSectionAsync(int32 SectionIndex, FRuntimeMeshSectionInterface* NewSection, bool bIsValid, 
+		const TSharedPtr<FRuntimeMeshAsyncSectionState, ESPMode::ThreadSafe>& State, ESectionUpdateFlags UpdateFlags);
+
+	/* Cancels a pending async creation of a section, if there is one */
+	void CancelAsyncSection(int32 SectionIndex);
+
+	/* Finishes updating a section, including entering it for batch updating, or updating the RT directly. Range updates only send the dirty ranges of the section. */
+	void UpdateSectionInternal(int32 SectionIndex, bool bHadVertexPositionsUpdate, bool bHadVertexUpdates, bool bHadIndexUpdates, bool bNeedsBoundsUpdate, ESectionUpdateFlags UpdateFlags, bool bIsRangeUpdate = false);
+
+	/* Finishes updating a sections separate vertex streams, including entering it for batch updating, or updating the RT directly */
+	void UpdateSectionStreamsInternal(int32 SectionIndex, ERuntimeMeshVertexStream Streams, bool bNeedsBoundsUpdate, ESectionUpdateFlags UpdateFlags);
 
 	/* Finishes updating a sections positions (Only used if section is dual vertex buffer), including entering it for batch updating, or updating the RT directly */
 	void UpdateSectionVertexPositionsInternal(int32 SectionIndex, bool bNeedsBoundsUpdate);
 
 	/* Finishes updating a sections properties, like visible/casts shadow, a*/
 	void UpdateSectionPropertiesInternal(int32 SectionIndex, bool bUpdateRequiresProxyRecreateIfStatic);
+
+	/* Finishes updating a sections instances, including entering it for batch updating, or updating the RT directly */
+	void UpdateSectionInstancesInternal(int32 SectionIndex, bool bInstancingChanged);
 	
 	/* Internal log helper for the templates to be able to use the internal logger */
 	static void Log(FString Text, bool bIsError = false)
@@ -276,6 +361,83 @@ public:
 		// Finalize section.
 		CreateSectionInternal(SectionIndex, UpdateFlags);
 	}
+
+	/**
+	*	Create/replace a section, building it on a worker thread. The generator fills in the vertices and triangles off the game thread, 
+	*	where the bounding box and any normal/tangent or tessellation generation requested by the flags are computed too. The section 
+	*	is then created on the game thread once it's ready. Creating, clearing or asynchronously creating the section again before 
+	*	then cancels this one. The generator runs on a worker thread, so it must not access the component or any other UObject.
+	*	@param	SectionIndex		Index of the section to create or replace.
+	*	@param	Generator			Function filling in the vertex and index buffers for this section.
+	*	@param	bCreateCollision	Indicates whether collision should be created for this section. This adds significant cost.
+	*	@param	UpdateFrequency		Indicates how frequently the section will be updated. Allows the RMC to optimize itself to a particular use.
+	*	@param	UpdateFlags			Flags pertaining to this particular update. MoveArrays is implied.
+	*/
+	template<typename VertexType>
+	void CreateMeshSectionAsync(int32 SectionIndex, TFunction<void(TArray<VertexType>& /*Vertices*/, TArray<int32>& /*Triangles*/)> Generator, 
+		bool bCreateCollision = false, EUpdateFrequency UpdateFrequency = EUpdateFrequency::Average, ESectionUpdateFlags UpdateFlags = ESectionUpdateFlags::None)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_CreateMeshSectionAsync_VertexType);
+
+		RMC_CHECKINGAME_LOGINEDITOR((SectionIndex >= 0), "SectionIndex cannot be negative.", /*VoidReturn*/);
+
+		// Replace anything still being built for this section
+		CancelAsyncSection(SectionIndex);
+		TSharedPtr<FRuntimeMeshAsyncSectionState, ESPMode::ThreadSafe> State = MakeShareable(new FRuntimeMeshAsyncSectionState());
+		PendingAsyncSections.Add(SectionIndex, State);
+
+		TWeakObjectPtr<URuntimeMeshComponent> WeakThis(this);
+		AsyncTask(ENamedThreads::AnyThread, [WeakThis, SectionIndex, Generator, State, bCreateCollision, UpdateFrequency, UpdateFlags]()
+		{
+			SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_BuildMeshSectionAsync);
+
+			if (State->bIsCancelled)
+			{
+				return;
+			}
+
+			TArray<VertexType> Vertices;
+			TArray<int32> Triangles;
+			Generator(Vertices, Triangles);
+
+			// Don't bother with the rest if we've been replaced in the meantime
+			if (State->bIsCancelled)
+			{
+				return;
+			}
+
+			bool bIsValid = Vertices.Num() > 0 && Triangles.Num() > 0;
+
+			// The section is handed to the game thread as a raw pointer, as its shared pointer isn't thread safe
+			auto* Section = new FRuntimeMeshSection<VertexType>(false);
+			Section->UpdateVertexBuffer(Vertices, nullptr, true);
+			Section->UpdateIndexBuffer(Triangles, true);
+			Section->CollisionEnabled = bCreateCollision;
+			Section->UpdateFrequency = UpdateFrequency;
+
+			if (bIsValid && !!(UpdateFlags & ESectionUpdateFlags::CalculateNormalTangent))
+			{
+				Section->GenerateNormalTangent();
+			}
+
+			if (bIsValid && !!(UpdateFlags & ESectionUpdateFlags::CalculateTessellationIndices))
+			{
+				Section->GenerateTessellationIndices();
+			}
+
+			AsyncTask(ENamedThreads::GameThread, [WeakThis, SectionIndex, Section, bIsValid, State, UpdateFlags]()
+			{
+				if (WeakThis.IsValid())
+				{
+					WeakThis->FinishCreateSectionAsync(SectionIndex, Section, bIsValid, State, UpdateFlags);
+				}
+				else
+				{
+					delete Section;
+				}
+			});
+		});
+	}
 	
 
 	/**
@@ -299,7 +461,7 @@ public:
 		TSharedPtr<FRuntimeMeshSection<VertexType>> Section = StaticCastSharedPtr<FRuntimeMeshSection<VertexType>>(MeshSections[SectionIndex]);
 		
 		// Check dual buffer section status
-		if (Section->IsDualBufferSection() && Vertices.Num() != Section->VertexBuffer.Num())
+		if (Section->IsDualBufferSection() && Vertices.Num() != Section->GetVertexBuffer().Num())
 		{
 			Log(TEXT("UpdateMeshSection() - Vertices cannot change length unless the positions are updated as well."), true);
 			return;
@@ -350,7 +512,7 @@ public:
 		TSharedPtr<FRuntimeMeshSection<VertexType>> Section = StaticCastSharedPtr<FRuntimeMeshSection<VertexType>>(MeshSections[SectionIndex]);
 
 		// Check dual buffer section status
-		if (Section->IsDualBufferSection() && Vertices.Num() != Section->VertexBuffer.Num())
+		if (Section->IsDualBufferSection() && Vertices.Num() != Section->GetVertexBuffer().Num())
 		{
 			Log(TEXT("UpdateMeshSection() - Vertices cannot change length unless the positions are updated as well."), true);
 			return;
@@ -400,7 +562,7 @@ public:
 		TSharedPtr<FRuntimeMeshSection<VertexType>> Section = StaticCastSharedPtr<FRuntimeMeshSection<VertexType>>(MeshSections[SectionIndex]);
 
 		// Check dual buffer section status
-		if (Section->IsDualBufferSection() && Vertices.Num() != Section->VertexBuffer.Num())
+		if (Section->IsDualBufferSection() && Vertices.Num() != Section->GetVertexBuffer().Num())
 		{
 			Log(TEXT("UpdateMeshSection() - Vertices cannot change length unless the positions are updated as well."), true);
 			return;
@@ -464,7 +626,7 @@ public:
 		TSharedPtr<FRuntimeMeshSection<VertexType>> Section = StaticCastSharedPtr<FRuntimeMeshSection<VertexType>>(MeshSections[SectionIndex]);
 
 		// Check dual buffer section status
-		if (Section->IsDualBufferSection() && Vertices.Num() != Section->VertexBuffer.Num())
+		if (Section->IsDualBufferSection() && Vertices.Num() != Section->GetVertexBuffer().Num())
 		{
 			Log(TEXT("UpdateMeshSection() - Vertices cannot change length unless the positions are updated as well."), true);
 			return;
@@ -528,7 +690,7 @@ public:
 
 		// Check dual buffer section status
 		if (Section->IsDualBufferSection() && 
-			VertexData.Num() != Section->VertexBuffer.Num() &&
+			VertexData.Num() != Section->GetVertexBuffer().Num() &&
 			VertexPositions.Num() != VertexData.Num())
 		{
 			Log(TEXT("UpdateMeshSection() - Vertices cannot change length unless the positions are updated as well."), true);
@@ -594,7 +756,7 @@ public:
 
 		// Check dual buffer section status
 		if (Section->IsDualBufferSection() &&
-			VertexData.Num() != Section->VertexBuffer.Num() &&
+			VertexData.Num() != Section->GetVertexBuffer().Num() &&
 			VertexPositions.Num() != VertexData.Num())
 		{
 			Log(TEXT("UpdateMeshSection() - Vertices cannot change length unless the positions are updated as well."), true);
@@ -659,7 +821,7 @@ public:
 
 		// Check dual buffer section status
 		if (Section->IsDualBufferSection() &&
-			VertexData.Num() != Section->VertexBuffer.Num() &&
+			VertexData.Num() != Section->GetVertexBuffer().Num() &&
 			VertexPositions.Num() != VertexData.Num())
 		{
 			Log(TEXT("UpdateMeshSection() - Vertices cannot change length unless the positions are updated as well."), true);
@@ -738,7 +900,7 @@ public:
 
 		// Check dual buffer section status
 		if (Section->IsDualBufferSection() &&
-			VertexData.Num() != Section->VertexBuffer.Num() &&
+			VertexData.Num() != Section->GetVertexBuffer().Num() &&
 			VertexPositions.Num() != VertexData.Num())
 		{
 			Log(TEXT("UpdateMeshSection() - Vertices cannot change length unless the positions are updated as well."), true);
@@ -791,6 +953,123 @@ public:
 		}
 	}
 
+
+	/**
+	*	Updates a range of a sections vertices. Only the changed ranges are sent to the GPU, and ranges updated
+	*	within the same batch are merged. The range cannot extend past the current length of the vertex buffer.
+	*	The bounds of the section will only grow from this, they won't shrink until the vertices are fully updated.
+	*	@param	SectionIndex		Index of the section to update.
+	*	@param	FirstVertex			Index of the first vertex to overwrite.
+	*	@param	Vertices			New vertex data for the range, or in the case of dual buffer section it contains everything but position.
+	*	@param	UpdateFlags			Flags pertaining to this particular update.
+	*/
+	template<typename VertexType>
+	void UpdateMeshSectionRange(int32 SectionIndex, int32 FirstVertex, const TArray<VertexType>& Vertices, ESectionUpdateFlags UpdateFlags = ESectionUpdateFlags::None)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_UpdateMeshSectionRange_VertexType);
+
+		// Validate all update parameters
+		RMC_VALIDATE_UPDATEPARAMETERS(SectionIndex, /*VoidReturn*/);
+
+		// Validate section type
+		MeshSections[SectionIndex]->GetVertexType()->EnsureEquals<VertexType>();
+
+		// Cast section to correct type
+		TSharedPtr<FRuntimeMeshSection<VertexType>> Section = StaticCastSharedPtr<FRuntimeMeshSection<VertexType>>(MeshSections[SectionIndex]);
+
+		// Validate the range
+		RMC_VALIDATE_RANGEPARAMETERS(FirstVertex, Vertices, Section->GetVertexBuffer().Num(), /*VoidReturn*/);
+
+		bool bNeedsBoundsUpdate = Section->UpdateVertexBufferRange(Vertices, FirstVertex);
+
+		// Finalize section update
+		UpdateSectionInternal(SectionIndex, false, true, false, bNeedsBoundsUpdate, UpdateFlags, true);
+	}
+
+	/**
+	*	Updates a range of a sections triangles. Only the changed ranges are sent to the GPU, and ranges updated
+	*	within the same batch are merged. The range cannot extend past the current length of the index buffer.
+	*	@param	SectionIndex		Index of the section to update.
+	*	@param	FirstIndex			Index of the first index to overwrite.
+	*	@param	Triangles			New indices for the range.
+	*	@param	UpdateFlags			Flags pertaining to this particular update.
+	*/
+	void UpdateMeshSectionTrianglesRange(int32 SectionIndex, int32 FirstIndex, const TArray<int32>& Triangles, ESectionUpdateFlags UpdateFlags = ESectionUpdateFlags::None);
+
+	/**
+	*	Adds vertices and triangles to the end of a section. Only the new data is sent to the GPU where the section's buffers
+	*	have room for it, and buffers outgrown this way are given room for more so that repeated appends rarely reallocate.
+	*	The bounds of the section are grown by the new vertices instead of being recalculated. This cannot be used on a dual buffer section.
+	*	@param	SectionIndex		Index of the section to append to.
+	*	@param	Vertices			Vertices to add to the end of the vertex buffer.
+	*	@param	Triangles			Indices to add to the end of the index buffer. These index the whole section, so they can join onto existing vertices.
+	*	@param	UpdateFlags			Flags pertaining to this particular update.
+	*/
+	template<typename VertexType>
+	void AppendToMeshSection(int32 SectionIndex, const TArray<VertexType>& Vertices, const TArray<int32>& Triangles, ESectionUpdateFlags UpdateFlags = ESectionUpdateFlags::None)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_AppendToMeshSection_VertexType);
+
+		// Validate all update parameters
+		RMC_VALIDATE_UPDATEPARAMETERS(SectionIndex, /*VoidReturn*/);
+		RMC_CHECKINGAME_LOGINEDITOR((Vertices.Num() > 0 || Triangles.Num() > 0), "Vertices and Triangles must not both be empty.", /*VoidReturn*/);
+		RMC_CHECKINGAME_LOGINEDITOR((!MeshSections[SectionIndex]->IsDualBufferSection()), "Section must not be dual buffer.", /*VoidReturn*/);
+
+		// Validate section type
+		MeshSections[SectionIndex]->GetVertexType()->EnsureEquals<VertexType>();
+
+		// Cast section to correct type
+		TSharedPtr<FRuntimeMeshSection<VertexType>> Section = StaticCastSharedPtr<FRuntimeMeshSection<VertexType>>(MeshSections[SectionIndex]);
+
+		bool bNeedsBoundsUpdate = false;
+		if (Vertices.Num() > 0)
+		{
+			bNeedsBoundsUpdate = Section->AppendVertexBuffer(Vertices);
+		}
+
+		if (Triangles.Num() > 0)
+		{
+			Section->AppendIndexBuffer(Triangles);
+		}
+
+		// Finalize section update
+		UpdateSectionInternal(SectionIndex, false, Vertices.Num() > 0, Triangles.Num() > 0, bNeedsBoundsUpdate, UpdateFlags, true);
+	}
+
+	/**
+	*	Updates some of the attributes of a sections vertices. Only the separate vertex streams named are sent to the GPU,
+	*	so for example colors can be changed without uploading positions, normals and UVs. The streams must have been
+	*	separated with SetMeshSectionVertexStreams(), and the number of vertices can't change.
+	*	@param	SectionIndex		Index of the section to update.
+	*	@param	Streams				Streams that changed. Attributes outside these are still copied into the section but not sent to the GPU.
+	*	@param	Vertices			New vertex data for the section.
+	*	@param	UpdateFlags			Flags pertaining to this particular update.
+	*/
+	template<typename VertexType>
+	void UpdateMeshSectionStreams(int32 SectionIndex, ERuntimeMeshVertexStream Streams, TArray<VertexType>& Vertices, ESectionUpdateFlags UpdateFlags = ESectionUpdateFlags::None)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_UpdateMeshSectionStreams_VertexType);
+
+		// Validate all update parameters
+		RMC_VALIDATE_UPDATEPARAMETERS(SectionIndex, /*VoidReturn*/);
+		RMC_CHECKINGAME_LOGINEDITOR(Streams != ERuntimeMeshVertexStream::None, "Streams must not be empty.", /*VoidReturn*/);
+		RMC_CHECKINGAME_LOGINEDITOR(((Streams & MeshSections[SectionIndex]->SeparateStreams) == Streams), "Streams must be separated on the section.", /*VoidReturn*/);
+
+		// Validate section type
+		MeshSections[SectionIndex]->GetVertexType()->EnsureEquals<VertexType>();
+
+		// Cast section to correct type
+		TSharedPtr<FRuntimeMeshSection<VertexType>> Section = StaticCastSharedPtr<FRuntimeMeshSection<VertexType>>(MeshSections[SectionIndex]);
+
+		RMC_CHECKINGAME_LOGINEDITOR((Vertices.Num() == Section->GetVertexBuffer().Num()), "Vertices length must match the section.", /*VoidReturn*/);
+
+		bool bShouldUseMove = (UpdateFlags & ESectionUpdateFlags::MoveArrays) != ESectionUpdateFlags::None;
+		bool bNeedsBoundsUpdate = Section->UpdateVertexBuffer(Vertices, nullptr, bShouldUseMove);
+
+		// Finalize section update
+		UpdateSectionStreamsInternal(SectionIndex, Streams, bNeedsBoundsUpdate, UpdateFlags);
+	}
+
 	
 	/**
 	*	Updates a sections position buffer only. This cannot be used on a non-dual buffer section. You cannot change the length of the vertex position buffer with this function.
@@ -843,6 +1122,9 @@ public:
 		// Cast section to correct type
 		TSharedPtr<FRuntimeMeshSection<VertexType>> Section = StaticCastSharedPtr<FRuntimeMeshSection<VertexType>>(MeshSections[SectionIndex]);
 
+		// The caller is going to modify the vertices in place, so they can't be shared with the RT
+		Section->ReclaimSharedVertexBuffer();
+
 		Vertices = &Section->VertexBuffer;
 	}
 
@@ -857,6 +1139,9 @@ public:
 		// Cast section to correct type
 		TSharedPtr<FRuntimeMeshSection<VertexType>> Section = StaticCastSharedPtr<FRuntimeMeshSection<VertexType>>(MeshSections[SectionIndex]);
 
+		// The caller is going to modify the vertices in place, so they can't be shared with the RT
+		Section->ReclaimSharedVertexBuffer();
+
 		Vertices = &Section->VertexBuffer;
 		Triangles = &Section->IndexBuffer;
 	}
@@ -872,6 +1157,9 @@ public:
 		// Cast section to correct type
 		TSharedPtr<FRuntimeMeshSection<VertexType>> Section = StaticCastSharedPtr<FRuntimeMeshSection<VertexType>>(MeshSections[SectionIndex]);
 
+		// The caller is going to modify the vertices in place, so they can't be shared with the RT
+		Section->ReclaimSharedVertexBuffer();
+
 		Positions = &Section->PositionVertexBuffer;
 		Vertices = &Section->VertexBuffer;
 	}
@@ -887,6 +1175,9 @@ public:
 		// Cast section to correct type
 		TSharedPtr<FRuntimeMeshSection<VertexType>> Section = StaticCastSharedPtr<FRuntimeMeshSection<VertexType>>(MeshSections[SectionIndex]);
 
+		// The caller is going to modify the vertices in place, so they can't be shared with the RT
+		Section->ReclaimSharedVertexBuffer();
+
 		Positions = &Section->PositionVertexBuffer;
 		Vertices = &Section->VertexBuffer;
 		Triangles = &Section->IndexBuffer;
@@ -1069,6 +1360,88 @@ public:
 	bool IsMeshSectionCastingShadows(int32 SectionIndex) const;
 
 
+	/** 
+	 *	Keeps some of a sections vertex attributes in separate GPU buffers, so that they can be updated on their own with 
+	 *	UpdateMeshSectionStreams(). Sections with separate streams can't use the shared buffer pool, range updates or the 
+	 *	volatile ring buffer. Changing the streams of an existing section recreates its GPU resources.
+	 */
+	void SetMeshSectionVertexStreams(int32 SectionIndex, ERuntimeMeshVertexStream Streams);
+
+	/** Returns the vertex attributes a particular section keeps in separate GPU buffers */
+	ERuntimeMeshVertexStream GetMeshSectionVertexStreams(int32 SectionIndex) const;
+
+
+	/** 
+	 *	Sets the distance past which a particular section isn't drawn, measured from the viewer to the nearest point of 
+	 *	the sections bounds. 0 removes the limit. Only applies to sections drawn through the dynamic path.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
+	void SetMeshSectionMaxDrawDistance(int32 SectionIndex, float NewMaxDrawDistance);
+
+	/** Returns the distance past which a particular section isn't drawn. 0 for no limit */
+	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
+	float GetMeshSectionMaxDrawDistance(int32 SectionIndex) const;
+
+
+	/** 
+	 *	Sets the LOD of the component a particular section is drawn at, so several versions of a mesh can stay resident 
+	 *	on the GPU and be switched between without any uploads. INDEX_NONE draws the section at every LOD. The LODs are 
+	 *	chosen per view from the components screen size, see LODScreenSizes.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
+	void SetMeshSectionLOD(int32 SectionIndex, int32 LODIndex);
+
+	/** Returns the LOD a particular section is drawn at. INDEX_NONE for every LOD */
+	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
+	int32 GetMeshSectionLOD(int32 SectionIndex) const;
+
+	/** Sets the screen size below which each LOD is used, recreating the render state to apply it. See LODScreenSizes. */
+	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
+	void SetLODScreenSizes(const TArray<float>& NewLODScreenSizes);
+
+
+	/** 
+	 *	Sets whether a particular section is drawn once per instance, instead of once at the component. All the instances 
+	 *	are drawn from the same GPU buffers in a single draw call, so a mesh can be placed many times while only being 
+	 *	uploaded once. The section's material must have "Used with Instanced Static Meshes" set. Instanced sections are 
+	 *	always drawn through the dynamic path and have no collision. Turning instancing off clears the instances.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
+	void SetMeshSectionInstanced(int32 SectionIndex, bool bNewInstanced);
+
+	/** Returns whether a particular section is drawn once per instance */
+	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
+	bool IsMeshSectionInstanced(int32 SectionIndex) const;
+
+	/** Adds an instance of a particular section, making the section instanced if it wasn't. Returns the index of the new instance */
+	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
+	int32 AddMeshSectionInstance(int32 SectionIndex, const FTransform& InstanceTransform);
+
+	/** Adds several instances of a particular section in one update. Returns the index of the first new instance */
+	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
+	int32 AddMeshSectionInstances(int32 SectionIndex, const TArray<FTransform>& InstanceTransforms);
+
+	/** Moves an instance of a particular section. The transform is relative to the component */
+	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
+	bool UpdateMeshSectionInstance(int32 SectionIndex, int32 InstanceIndex, const FTransform& NewInstanceTransform);
+
+	/** Removes an instance of a particular section. Instances after it move down by one */
+	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
+	bool RemoveMeshSectionInstance(int32 SectionIndex, int32 InstanceIndex);
+
+	/** Removes all the instances of a particular section, leaving it instanced but not drawn */
+	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
+	void ClearMeshSectionInstances(int32 SectionIndex);
+
+	/** Returns the number of instances of a particular section */
+	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
+	int32 GetMeshSectionInstanceCount(int32 SectionIndex) const;
+
+	/** Gets the transform of an instance of a particular section, relative to the component */
+	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
+	bool GetMeshSectionInstanceTransform(int32 SectionIndex, int32 InstanceIndex, FTransform& OutInstanceTransform) const;
+
+
 	/** Control whether a particular section has collision */
 	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
 	void SetMeshSectionCollisionEnabled(int32 SectionIndex, bool bNewCollisionEnabled);
@@ -1128,6 +1501,23 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
 	void EndBatchUpdates();
 
+	/**
+	*	Sets how much the upload scheduler sends to the GPU per frame, across all components using it.
+	*	@param	BytesPerFrame			Bytes of section data sent per frame. 0 is unlimited.
+	*	@param	MillisecondsPerFrame	Game thread time spent sending section data per frame. 0 is unlimited.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
+	static void SetUploadBudget(int32 BytesPerFrame, float MillisecondsPerFrame);
+
+	/**
+	*	Sets the size of the cooked collision cache shared by all components using it.
+	*	@param	MaxMemoryMegabytes		Memory held by the most recently used entries. 0 disables the memory cache.
+	*	@param	bUseDiskCache			Also store cooked collision in the saved directory, so it's reused after a restart.
+	*	@param	MaxDiskMegabytes		Space the stored files can take. The least recently used files are removed past it.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
+	static void SetCollisionCacheLimits(int32 MaxMemoryMegabytes, bool bUseDiskCache, int32 MaxDiskMegabytes = 256);
+
 
 
 	/**
@@ -1137,12 +1527,104 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "RuntimeMesh")
 	bool bUseComplexAsSimpleCollision;
 
+	/**
+	*	Bakes collision asynchronously. The old collision stays in use until the new one is ready, and cooks made stale by further
+	*	changes are thrown away. The collision cache lookup, with its hashing and disk reads, runs on a worker thread. The cook
+	*	itself has to stay on the game thread in the engine versions this plugin supports, so it runs once the lookup is back,
+	*	and only on a cache miss. Worth enabling together with bUseCollisionCache.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RuntimeMesh")
+	bool bUseAsyncCooking;
+
+	/**
+	*	Gives each section its own collision body instead of cooking every section into one mesh, so changing a section only
+	*	recooks that section. Convex collision stays in the component's own body, and is always cooked on the game thread.
+	*	Worth enabling for large components made of many sections that are edited often. Should be set before any collision is created.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "RuntimeMesh")
+	bool bUseSectionCollisionBodies;
+
+	/**
+	*	Reuses the cooked collision of earlier cooks with identical geometry and settings, from a cache shared by all components,
+	*	instead of cooking again. Worth enabling when the same meshes are regenerated often. See SetCollisionCacheLimits().
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RuntimeMesh")
+	bool bUseCollisionCache;
+
 	/**
 	*	Controls whether the mesh data should be serialized with the component.
 	*/
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "RuntimeMesh")
 	bool bShouldSerializeMeshData;
 
+	/**
+	*	Controls whether sections should be placed in buffers shared with other sections and components instead of 
+	*	each owning their own buffers. This cuts down the number of GPU buffers when using lots of small sections.
+	*	Only applies to sections created after it's changed. Dual buffer and volatile sections always use their own buffers.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "RuntimeMesh")
+	bool bUseSharedBufferPool;
+
+	/**
+	*	Controls whether section creates, updates and clears made outside of BeginBatchUpdates()/EndBatchUpdates() are 
+	*	batched automatically and sent to the render thread once, late in the frame. Sections updated several times in 
+	*	a frame are then only sent once, with their latest data. Bounds and collision are also updated when the batch is sent.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RuntimeMesh")
+	bool bAutoBatchUpdates;
+
+	/**
+	*	Controls whether section uploads to the GPU go through the global upload scheduler, which spreads the uploads of
+	*	all components over several frames under a per frame budget instead of sending everything as soon as it changes.
+	*	Sections changed several times while waiting are only sent once. Static and volatile sections are never scheduled.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RuntimeMesh")
+	bool bUseUploadScheduler;
+
+	/**
+	*	Priority of this components scheduled uploads. Higher priorities are sent first, ahead of visibility and distance to the viewer.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RuntimeMesh")
+	int32 UploadPriority;
+
+	/**
+	*	Cull each section against every view using its own bounds, so large components only draw the sections in view.
+	*	Disable this if the materials offset vertices past the section bounds. Takes effect when the render state is recreated.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RuntimeMesh")
+	bool bCullSectionsIndividually;
+
+	/**
+	*	Groups nearby sections into chunks held in a bounding volume hierarchy, so views cull whole regions of sections at once
+	*	and each chunk is occlusion tested on its own. Only used when culling sections individually. Worth enabling for
+	*	components made of hundreds of sections spread over a large area. Takes effect when the render state is recreated.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RuntimeMesh")
+	bool bUseSpatialChunks;
+
+	/** Most sections grouped into one chunk when using spatial chunks. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RuntimeMesh", meta = (ClampMin = "1", UIMin = "1"))
+	int32 MaxSectionsPerChunk;
+
+	/**
+	*	Screen size below which each LOD is drawn, in descending order. The first entry is LOD 0 and is used at any size.
+	*	Sections are assigned to LODs with SetMeshSectionLOD(). Empty, or a single entry, always draws LOD 0.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "RuntimeMesh|LOD")
+	TArray<float> LODScreenSizes;
+
+	/** Cross fade static sections between LODs using dithering. Requires materials with dithered LOD transitions enabled. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RuntimeMesh|LOD")
+	bool bDitheredLODTransitions;
+
+	/**
+	*	Packs static (Infrequent) sections into the shared buffer pool and draws those sharing a material and vertex type
+	*	with a single mesh batch, with each section still hidden or culled on its own. Cuts draw calls for components made
+	*	of many small static sections. Takes effect when the render state is recreated.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RuntimeMesh")
+	bool bMergeStaticSections;
+
 
 	/** Collision data */
 	UPROPERTY(Transient, DuplicateTransient)
@@ -1172,8 +1654,20 @@ private:
 	//~ Begin UPrimitiveComponent Interface.
 	virtual FPrimitiveSceneProxy* CreateSceneProxy() override;
 	virtual class UBodySetup* GetBodySetup() override;
+	virtual bool DoCustomNavigableGeometryExport(FNavigableGeometryExport& GeomExport) const override;
+	virtual void OnComponentCollisionSettingsChanged() override;
 	//~ End UPrimitiveComponent Interface.
 
+	//~ Begin UActorComponent Interface.
+	virtual void OnCreatePhysicsState() override;
+	virtual void OnDestroyPhysicsState() override;
+#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION >= 14
+	virtual void OnUpdateTransform(EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport = ETeleportType::None) override;
+#else
+	virtual void OnUpdateTransform(bool bSkipPhysicsMove, ETeleportType Teleport = ETeleportType::None) override;
+#endif
+	//~ End UActorComponent Interface.
+
 	//~ Begin UMeshComponent Interface.
 	virtual int32 GetNumMaterials() const override;
 	//~ End UMeshComponent Interface.
@@ -1182,8 +1676,24 @@ private:
 
 	/** Update LocalBounds member from the local box of each section */
 	void UpdateLocalBounds(bool bMarkRenderTransform = true);
+
+	/* 
+	*	Grows the bounds to fit a section straight away. If the section could have shrunk, the bounds are rebuilt from every 
+	*	section at the end of the frame instead. The render transform is also only sent once at the end of the frame.
+	*/
+	void UpdateLocalBoundsForSection(int32 SectionIndex, bool bMayHaveShrunk);
+
+	/* Gets the box a section adds to the bounds */
+	FBox GetSectionLocalBox(int32 SectionIndex) const;
+
+	/* Applies any bounds updates deferred by UpdateLocalBoundsForSection() */
+	void FlushLocalBounds();
 	/** Ensure ProcMeshBodySetup is allocated and configured */
 	void EnsureBodySetupCreated();
+	/* Creates a new body setup configured for this component */
+	class UBodySetup* CreateBodySetupHelper();
+	/* Fills a body setup with the simple collision and settings of this component */
+	void FillBodySetup(class UBodySetup* NewBodySetup);
 	/** Mark collision data as dirty, and re-create on instance if necessary */
 	void UpdateCollision();
 
@@ -1193,6 +1703,48 @@ private:
 	/* Cooks the new collision mesh updating the body */
 	void BakeCollision();
 
+	/* Snapshots the collision into a new body setup and starts looking it up in the collision cache on a worker thread */
+	void StartAsyncCollisionCook();
+
+	/* Cooks the body setup of an async cook if the cache had no entry for it, and swaps it in unless it was cancelled */
+	void FinishAsyncCollisionCook(class UBodySetup* NewBodySetup, const TSharedPtr<FRuntimeMeshCollisionCookState, ESPMode::ThreadSafe>& CookState);
+
+	/* Recooks the collision bodies of the sections changed since the last bake */
+	void UpdateSectionCollisionBodies();
+
+	/* Cooks a new collision body for a section, or removes its body if it no longer has collision */
+	void UpdateSectionCollisionBody(bool bIsCollisionSection, int32 SectionIndex);
+
+	/* Cooks a section collision body if the cache had no entry for it, and swaps it in unless it was cancelled */
+	void FinishSectionCollisionBodyCook(class URuntimeMeshCollisionBody* NewBody);
+
+	/* Replaces the collision body of a section, moving the physics body over if the physics state exists */
+	void SetSectionCollisionBody(bool bIsCollisionSection, int32 SectionIndex, class URuntimeMeshCollisionBody* NewBody);
+
+	/* Moves the section collision bodies to the component's transform */
+	void UpdateSectionCollisionBodyTransforms(ETeleportType Teleport);
+
+	/* Starts an automatic batch if auto batching is enabled and no batch is running. Returns whether the update should be batched */
+	bool ShouldBatchUpdate();
+
+	/* Sends a pending automatic batch to the RT, and applies deferred bounds updates */
+	void FlushDeferredUpdates();
+
+	/* Should uploads of this section go through the upload scheduler */
+	bool ShouldScheduleUpload(int32 SectionIndex) const;
+
+	/* Sends a sections creation data to the RT */
+	void SendSectionCreate(int32 SectionIndex);
+
+	/* Sends a sections update data to the RT */
+	void SendSectionUpdate(int32 SectionIndex, bool bHadVertexPositionsUpdate, bool bHadVertexUpdates, bool bHadIndexUpdates);
+
+	/* Sends a sections separate vertex streams to the RT */
+	void SendSectionStreamUpdate(int32 SectionIndex, ERuntimeMeshVertexStream Streams);
+
+	/* Sends an upload the upload scheduler has let through */
+	void SendScheduledUpload(int32 SectionIndex, ERuntimeMeshSectionBatchUpdateType Updates);
+
 	void UpdateNavigation();
 
 
@@ -1209,9 +1761,39 @@ private:
 	/* Current state of a batch update. */
 	FRuntimeMeshBatchUpdateState BatchState;
 
+	/* Sections currently being built by CreateMeshSectionAsync() */
+	TMap<int32, TSharedPtr<FRuntimeMeshAsyncSectionState, ESPMode::ThreadSafe>> PendingAsyncSections;
+
+	/* Async collision cook currently in flight, if any */
+	TSharedPtr<FRuntimeMeshCollisionCookState, ESPMode::ThreadSafe> PendingCollisionCook;
+
+	/* Collision geometry already gathered for a cook running now, so the cook doesn't gather it again */
+	const FRuntimeMeshCollisionCookState* SynchronousCollisionCook;
+
 	/* Is the collision in need of a rebake? */
 	bool bCollisionDirty;
 
+	/* Does the component's own body need rebuilding. Only tracked separately when using section collision bodies */
+	bool bIsBodySetupDirty;
+
+	/* Do all section collision bodies need rebuilding */
+	bool bAreAllCollisionBodiesDirty;
+
+	/* Sections and collision sections whose collision bodies need rebuilding */
+	TSet<int32> SectionsWithDirtyCollision;
+	TSet<int32> CollisionSectionsWithDirtyCollision;
+
+	/* Collision bodies of each section when using section collision bodies, indexed by section */
+	UPROPERTY(Transient)
+	TArray<class URuntimeMeshCollisionBody*> SectionCollisionBodies;
+
+	/* Collision bodies of each collision section when using section collision bodies, indexed by collision section */
+	UPROPERTY(Transient)
+	TArray<class URuntimeMeshCollisionBody*> CollisionSectionCollisionBodies;
+
+	/* Section collision bodies being cooked on worker threads. They're rooted until their cook is done */
+	TArray<class URuntimeMeshCollisionBody*> PendingCollisionBodies;
+
 	/** Array of sections of mesh */	
 	TArray<RuntimeMeshSectionPtr> MeshSections;
 
@@ -1227,11 +1809,26 @@ private:
 	UPROPERTY(Transient)
 	FBoxSphereBounds LocalBounds;
 
+	/* Box LocalBounds was made from, kept so sections can grow it */
+	FBox LocalBox;
+
+	/* Could the bounds have shrunk since they were last rebuilt from every section */
+	bool bIsLocalBoundsRebuildPending;
+
+	/* Have the bounds grown without the render transform being sent */
+	bool bIsRenderTransformUpdatePending;
+
 	/* Tick function used to cook collision when needed*/
 	UPROPERTY(Transient)
 	FRuntimeMeshComponentPrePhysicsTickFunction PrePhysicsTick;
 
+	/* Tick function used to flush automatic batches */
+	UPROPERTY(Transient)
+	FRuntimeMeshComponentBatchUpdateTickFunction BatchUpdateTick;
+
 
 	friend class FRuntimeMeshSceneProxy;
 	friend struct FRuntimeMeshComponentPrePhysicsTickFunction;
+	friend struct FRuntimeMeshComponentBatchUpdateTickFunction;
+	friend class FRuntimeMeshUploadScheduler;
 };
@@ -164,7 +164,9 @@ enum class EUpdateFrequency : uint8
 	/* Tries to skip recreating the scene proxy if possible and optimizes the buffers for frequent updates. */
 	Frequent UMETA(DisplayName = "Frequent"),
 	/* If the component is static it will try to use the static rendering path (this will force a recreate of the scene proxy) */
-	Infrequent UMETA(DisplayName = "Infrequent")
+	Infrequent UMETA(DisplayName = "Infrequent"),
+	/* For sections rewritten every frame. Instead of owning buffers the section is written into shared per-frame ring buffers. */
+	Volatile UMETA(DisplayName = "Volatile")
 };
 
 /* Control flags for update actions */
@@ -248,6 +250,208 @@ enum class ERuntimeMeshBuffer
 };
 ENUM_CLASS_FLAGS(ERuntimeMeshBuffer)
 
+/* 
+ *	Vertex attributes that can be kept in a GPU buffer of their own instead of the interleaved vertex buffer,
+ *	so they can be rewritten without uploading the rest of the vertex.
+ */
+enum class ERuntimeMeshVertexStream
+{
+	None = 0x0,
+	/* Position. Dual buffer sections already keep positions apart, so this is ignored for them */
+	Position = 0x1,
+	/* Normal and tangent */
+	Tangents = 0x2,
+	Color = 0x4,
+	/* All texture coordinate channels */
+	UVs = 0x8,
+};
+ENUM_CLASS_FLAGS(ERuntimeMeshVertexStream)
+
+/* Number of different vertex streams, one per ERuntimeMeshVertexStream flag */
+static const int32 RuntimeMeshNumVertexStreams = 4;
+
+
+
+/*
+*	Index data as it is handed to the render thread. This is stored as 16 bit indices whenever
+*	the section has few enough vertices to be addressed by them, and as 32 bit indices otherwise.
+*/
+struct FRuntimeMeshIndexData
+{
+	/* Indices when stored as 16 bit */
+	TArray<uint16> Indices16;
+
+	/* Indices when stored as 32 bit */
+	TArray<int32> Indices32;
+
+	/* Are the indices currently stored as 32 bit */
+	bool b32BitIndices;
+
+	FRuntimeMeshIndexData() : b32BitIndices(false) { }
+
+	/* Can a section with this many vertices be addressed with 16 bit indices */
+	static bool CanUse16BitIndices(int32 NumVertices)
+	{
+		return NumVertices <= (MAX_uint16 + 1);
+	}
+
+	/* Copies the supplied indices, packing them down to 16 bit if the vertex count allows it */
+	void Set(const TArray<int32>& Indices, int32 NumVertices)
+	{
+		Reset(!CanUse16BitIndices(NumVertices));
+		Append(Indices.GetData(), Indices.Num());
+	}
+
+	/* Clears all indices and sets the format for indices appended after this */
+	void Reset(bool bUse32BitIndices)
+	{
+		b32BitIndices = bUse32BitIndices;
+		Indices16.Reset();
+		Indices32.Reset();
+	}
+
+	/* Appends indices in the current format */
+	void Append(const int32* Indices, int32 NumIndices)
+	{
+		if (b32BitIndices)
+		{
+			Indices32.Append(Indices, NumIndices);
+		}
+		else
+		{
+			const int32 StartIndex = Indices16.Num();
+			Indices16.AddUninitialized(NumIndices);
+			for (int32 Index = 0; Index < NumIndices; Index++)
+			{
+				Indices16[StartIndex + Index] = (uint16)Indices[Index];
+			}
+		}
+	}
+
+	/* Gets the number of indices */
+	int32 Num() const { return b32BitIndices ? Indices32.Num() : Indices16.Num(); }
+
+	/* Gets the size of a single index in bytes */
+	int32 GetStride() const { return b32BitIndices ? sizeof(int32) : sizeof(uint16); }
+
+	/* Gets the raw index data */
+	const void* GetData() const { return b32BitIndices ? (const void*)Indices32.GetData() : (const void*)Indices16.GetData(); }
+
+	/* Gets the memory held by both index arrays */
+	SIZE_T GetAllocatedSize() const { return Indices16.GetAllocatedSize() + Indices32.GetAllocatedSize(); }
+};
+
+
+/* A contiguous range of elements within a buffer */
+struct FRuntimeMeshBufferSpan
+{
+	/* First element in the range */
+	int32 Start;
+
+	/* Number of elements in the range */
+	int32 Count;
+
+	FRuntimeMeshBufferSpan() : Start(0), Count(0) { }
+	FRuntimeMeshBufferSpan(int32 InStart, int32 InCount) : Start(InStart), Count(InCount) { }
+
+	/* One past the last element in the range */
+	int32 End() const { return Start + Count; }
+};
+
+/*
+*	Tracks which ranges of a buffer have changed since it was last sent to the render thread.
+*	Ranges are kept sorted, and overlapping or touching ranges are merged as they're added.
+*/
+struct FRuntimeMeshDirtySpans
+{
+	/* Past this many separate ranges they're collapsed into a single range covering all of them */
+	static const int32 MaxSpans = 16;
+
+	FRuntimeMeshDirtySpans() : bAllDirty(false) { }
+
+	/* Flags a range of the buffer as changed */
+	void Add(int32 Start, int32 Count)
+	{
+		if (bAllDirty || Count <= 0)
+		{
+			return;
+		}
+
+		int32 NewStart = Start;
+		int32 NewEnd = Start + Count;
+
+		// Absorb any existing range that overlaps or touches the new one
+		int32 InsertIndex = 0;
+		for (int32 Index = 0; Index < Spans.Num();)
+		{
+			const FRuntimeMeshBufferSpan& Span = Spans[Index];
+			if (Span.End() < NewStart)
+			{
+				InsertIndex = ++Index;
+			}
+			else if (Span.Start > NewEnd)
+			{
+				break;
+			}
+			else
+			{
+				NewStart = FMath::Min(NewStart, Span.Start);
+				NewEnd = FMath::Max(NewEnd, Span.End());
+				Spans.RemoveAt(Index, 1, false);
+			}
+		}
+
+		Spans.Insert(FRuntimeMeshBufferSpan(NewStart, NewEnd - NewStart), InsertIndex);
+
+		// Too fragmented to be worth individual writes
+		if (Spans.Num() > MaxSpans)
+		{
+			const int32 First = Spans[0].Start;
+			const int32 Last = Spans.Last().End();
+			Spans.Reset();
+			Spans.Add(FRuntimeMeshBufferSpan(First, Last - First));
+		}
+	}
+
+	/* Flags the entire buffer as changed */
+	void MarkAllDirty()
+	{
+		bAllDirty = true;
+		Spans.Reset();
+	}
+
+	/* Clears all tracked changes */
+	void Reset()
+	{
+		bAllDirty = false;
+		Spans.Reset();
+	}
+
+	/* Are there only partial changes, so that just the dirty ranges need to be sent */
+	bool IsPartial() const { return !bAllDirty && Spans.Num() > 0; }
+
+	/* Gets the changed ranges, sorted by start */
+	const TArray<FRuntimeMeshBufferSpan>& GetSpans() const { return Spans; }
+
+	/* Gets the number of changed elements across all ranges */
+	int32 GetNumDirty() const
+	{
+		int32 NumDirty = 0;
+		for (const FRuntimeMeshBufferSpan& Span : Spans)
+		{
+			NumDirty += Span.Count;
+		}
+		return NumDirty;
+	}
+
+private:
+	/* Sorted, disjoint ranges that have changed */
+	TArray<FRuntimeMeshBufferSpan> Spans;
+
+	/* Has the whole buffer changed */
+	bool bAllDirty;
+};
+
 
 USTRUCT()
 struct FRuntimeMeshCollisionSection
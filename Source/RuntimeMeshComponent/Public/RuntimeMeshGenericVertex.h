@@ -1502,6 +1502,9 @@ public:
 
 	virtual bool UpdateVertexBufferInternal(const TArray<FVector>& Positions, const TArray<FVector>& Normals, const TArray<FRuntimeMeshTangent>& Tangents, const TArray<FVector2D>& UV0, const TArray<FVector2D>& UV1, const TArray<FColor>& Colors) override
 	{
+		// Vertices are patched in place, so we need them back from the RT
+		Super::ReclaimSharedVertexBuffer();
+
 		int32 NewVertexCount = (Positions.Num() > 0) ? Positions.Num() : Super::VertexBuffer.Num();
 		int32 OldVertexCount = FMath::Min(Super::VertexBuffer.Num(), NewVertexCount);
 
@@ -1514,10 +1517,10 @@ public:
 			Super::VertexBuffer.SetNumZeroed(NewVertexCount);
 		}
 
-		// Clear the bounding box if we have new positions
+		// The positions are already packed together, so their bounds are quicker to take from there than from the vertices
 		if (HasPositions)
 		{
-			Super::LocalBoundingBox.Init();
+			Super::LocalBoundingBox = FRuntimeMeshBounds::Calculate(Positions.GetData(), Positions.Num());
 		}
 		
 		// Loop through existing range to update data
@@ -1525,11 +1528,10 @@ public:
 		{
 			auto& Vertex = Super::VertexBuffer[VertexIdx];
 
-			// Update position and bounding box
+			// Update position
 			if (Positions.Num() == NewVertexCount)
 			{
 				Vertex.Position = Positions[VertexIdx];
-				Super::LocalBoundingBox += Vertex.Position;
 			}
 
 			// see if we have a new normal and/or tangent
@@ -1574,8 +1576,6 @@ public:
 
 			// Set position
 			Vertex.Position = Positions[VertexIdx];
-			// Update bounding box
-			Super::LocalBoundingBox += Vertex.Position;
 
 			// see if we have a new normal and/or tangent
 			bool HasNormal = Normals.Num() > VertexIdx;
@@ -1629,6 +1629,7 @@ public:
 	virtual void Serialize(FArchive& Ar) override
 	{
 		Super::Serialize(Ar);
+		Super::ReclaimSharedVertexBuffer();
 	
 		int32 VertexBufferLength = Super::VertexBuffer.Num();
 		Ar << VertexBufferLength;
@@ -11,12 +11,51 @@ DECLARE_CYCLE_STAT(TEXT("Create Section (RT)"), STAT_RuntimeMesh_CreateSection_R
 DECLARE_CYCLE_STAT(TEXT("Update Section (RT)"), STAT_RuntimeMesh_UpdateSection_RenderThread, STATGROUP_RuntimeMesh);
 DECLARE_CYCLE_STAT(TEXT("Update Section - Position Only (RT)"), STAT_RuntimeMesh_UpdateSectionPositionOnly_RenderThread, STATGROUP_RuntimeMesh);
 DECLARE_CYCLE_STAT(TEXT("Update Section Properties (RT)"), STAT_RuntimeMesh_UpdateSectionProperties_RenderThread, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("Update Section Instances (RT)"), STAT_RuntimeMesh_UpdateSectionInstances_RenderThread, STATGROUP_RuntimeMesh);
 
 DECLARE_CYCLE_STAT(TEXT("Apply Batch Update (RT)"), STAT_RuntimeMesh_ApplyBatchUpdate_RenderThread, STATGROUP_RuntimeMesh);
 
 DECLARE_CYCLE_STAT(TEXT("On Transform Changed (RT)"), STAT_RuntimeMesh_OnTransformChanged, STATGROUP_RuntimeMesh);
 DECLARE_CYCLE_STAT(TEXT("Draw Static Elements (RT)"), STAT_RuntimeMesh_DrawStaticElements, STATGROUP_RuntimeMesh);
 DECLARE_CYCLE_STAT(TEXT("Get Dynamic Mesh Elements (RT)"), STAT_RuntimeMesh_GetDynamicMeshElements, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("Commit Volatile Buffers (RT)"), STAT_RuntimeMesh_CommitVolatileBuffers, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("Build Chunk Tree (RT)"), STAT_RuntimeMesh_BuildChunkTree, STATGROUP_RuntimeMesh);
+
+// Render Buffer Profiling
+DECLARE_DWORD_COUNTER_STAT(TEXT("Buffer Reallocations (RT)"), STAT_RuntimeMesh_BufferReallocations, STATGROUP_RuntimeMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Buffer Reallocations Avoided (RT)"), STAT_RuntimeMesh_BufferReallocationsAvoided, STATGROUP_RuntimeMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Volatile Sections Written (RT)"), STAT_RuntimeMesh_VolatileSectionsWritten, STATGROUP_RuntimeMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Volatile Bytes Written (RT)"), STAT_RuntimeMesh_VolatileBytesWritten, STATGROUP_RuntimeMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sections Culled (RT)"), STAT_RuntimeMesh_SectionsCulled, STATGROUP_RuntimeMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sections Skipped By LOD (RT)"), STAT_RuntimeMesh_SectionsSkippedByLOD, STATGROUP_RuntimeMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Mesh Batches Built (RT)"), STAT_RuntimeMesh_MeshBatchesBuilt, STATGROUP_RuntimeMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Chunks Culled (RT)"), STAT_RuntimeMesh_ChunksCulled, STATGROUP_RuntimeMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Instances Culled (RT)"), STAT_RuntimeMesh_InstancesCulled, STATGROUP_RuntimeMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Chunks Occluded (RT)"), STAT_RuntimeMesh_ChunksOccluded, STATGROUP_RuntimeMesh);
+
+// Buffer Pool Profiling
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Buffer Pool Pages"), STAT_RuntimeMesh_PoolPages, STATGROUP_RuntimeMesh);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Buffer Pool Allocations"), STAT_RuntimeMesh_PoolAllocations, STATGROUP_RuntimeMesh);
+DECLARE_MEMORY_STAT(TEXT("Buffer Pool Allocated Memory"), STAT_RuntimeMesh_PoolAllocatedMemory, STATGROUP_RuntimeMesh);
+DECLARE_MEMORY_STAT(TEXT("Buffer Pool Used Memory"), STAT_RuntimeMesh_PoolUsedMemory, STATGROUP_RuntimeMesh);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Buffer Pool Fragmentation (%)"), STAT_RuntimeMesh_PoolFragmentation, STATGROUP_RuntimeMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Buffer Pool Bytes Uploaded (RT)"), STAT_RuntimeMesh_PoolBytesUploaded, STATGROUP_RuntimeMesh);
+
+// Command Pool Profiling
+DECLARE_DWORD_COUNTER_STAT(TEXT("Command Pool Hits"), STAT_RuntimeMesh_CommandPoolHits, STATGROUP_RuntimeMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Command Pool Misses"), STAT_RuntimeMesh_CommandPoolMisses, STATGROUP_RuntimeMesh);
+
+// Upload Scheduler Profiling
+DECLARE_CYCLE_STAT(TEXT("Drain Upload Scheduler (GT)"), STAT_RuntimeMesh_DrainUploadScheduler, STATGROUP_RuntimeMesh);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Scheduled Uploads Pending"), STAT_RuntimeMesh_ScheduledUploadsPending, STATGROUP_RuntimeMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Scheduled Uploads Sent"), STAT_RuntimeMesh_ScheduledUploadsSent, STATGROUP_RuntimeMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Scheduled Upload Bytes Sent"), STAT_RuntimeMesh_ScheduledUploadBytesSent, STATGROUP_RuntimeMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Scheduled Uploads Coalesced"), STAT_RuntimeMesh_ScheduledUploadsCoalesced, STATGROUP_RuntimeMesh);
+
+// Collision Cache Profiling
+DECLARE_DWORD_COUNTER_STAT(TEXT("Collision Cache Hits"), STAT_RuntimeMesh_CollisionCacheHits, STATGROUP_RuntimeMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Collision Cache Misses"), STAT_RuntimeMesh_CollisionCacheMisses, STATGROUP_RuntimeMesh);
+DECLARE_MEMORY_STAT(TEXT("Collision Cache Memory"), STAT_RuntimeMesh_CollisionCacheMemory, STATGROUP_RuntimeMesh);
 
 // RuntimeMeshComponent Profiling
 
@@ -25,6 +64,9 @@ DECLARE_CYCLE_STAT(TEXT("CreateMeshSection<VertexType> (With Bounding Box) (GT)"
 DECLARE_CYCLE_STAT(TEXT("CreateMeshSectionDualBuffer<VertexType> (GT)"), STAT_RuntimeMesh_CreateMeshSectionDualBuffer_VertexType, STATGROUP_RuntimeMesh);
 DECLARE_CYCLE_STAT(TEXT("CreateMeshSectionDualBuffer<VertexType> (With Bounding Box) (GT)"), STAT_RuntimeMesh_CreateMeshSectionDualBuffer_VertexType_WithBoundingBox, STATGROUP_RuntimeMesh);
 DECLARE_CYCLE_STAT(TEXT("CreateMeshSection<VertexType> (From Mesh Builder) (GT)"), STAT_RuntimeMesh_CreateMeshSection_VertexType_FromMeshBuilder, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("CreateMeshSectionAsync<VertexType> (GT)"), STAT_RuntimeMesh_CreateMeshSectionAsync_VertexType, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("Build Mesh Section (Async)"), STAT_RuntimeMesh_BuildMeshSectionAsync, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("Finish Create Section Async (GT)"), STAT_RuntimeMesh_FinishCreateSectionAsync, STATGROUP_RuntimeMesh);
 
 
 
@@ -41,6 +83,11 @@ DECLARE_CYCLE_STAT(TEXT("UpdateMeshSection<VertexType> (Dual) (With Bounding Box
 DECLARE_CYCLE_STAT(TEXT("UpdateMeshSection<VertexType> (Dual) (With Triangles) (GT)"), STAT_RuntimeMesh_UpdateMeshSection_Dual_VertexType_WithTriangles, STATGROUP_RuntimeMesh);
 DECLARE_CYCLE_STAT(TEXT("UpdateMeshSection<VertexType> (Dual) (With Triangles and Bounding Box) (GT)"), STAT_RuntimeMesh_UpdateMeshSection_Dual_VertexType_WithTrianglesAndBoundinBox, STATGROUP_RuntimeMesh);
 
+DECLARE_CYCLE_STAT(TEXT("UpdateMeshSectionRange<VertexType> (GT)"), STAT_RuntimeMesh_UpdateMeshSectionRange_VertexType, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("UpdateMeshSectionTrianglesRange (GT)"), STAT_RuntimeMesh_UpdateMeshSectionTrianglesRange, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("AppendToMeshSection<VertexType> (GT)"), STAT_RuntimeMesh_AppendToMeshSection_VertexType, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("UpdateMeshSectionStreams<VertexType> (GT)"), STAT_RuntimeMesh_UpdateMeshSectionStreams_VertexType, STATGROUP_RuntimeMesh);
+
 DECLARE_CYCLE_STAT(TEXT("UpdateMeshSection (GT)"), STAT_RuntimeMesh_UpdateMeshSection, STATGROUP_RuntimeMesh);
 DECLARE_CYCLE_STAT(TEXT("UpdateMeshSection (GT)"), STAT_RuntimeMesh_UpdateMeshSection_DualUV, STATGROUP_RuntimeMesh);
 
@@ -67,6 +114,12 @@ DECLARE_CYCLE_STAT(TEXT("Set Collision Convex Meshes (GT)"), STAT_RuntimeMesh_Se
 DECLARE_CYCLE_STAT(TEXT("Create Scene Proxy (GT)"), STAT_RuntimeMesh_CreateSceneProxy, STATGROUP_RuntimeMesh);
 DECLARE_CYCLE_STAT(TEXT("Get Physics TriMesh Data (GT)"), STAT_RuntimeMesh_GetPhysicsTriMeshData, STATGROUP_RuntimeMesh);
 DECLARE_CYCLE_STAT(TEXT("Update Collision (GT)"), STAT_RuntimeMesh_UpdateCollision, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("Start Collision Cook (GT)"), STAT_RuntimeMesh_StartCollisionCook, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("Prepare Collision Cook (Async)"), STAT_RuntimeMesh_PrepareCollisionCookAsync, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("Finish Collision Cook (GT)"), STAT_RuntimeMesh_FinishCollisionCook, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("Update Section Collision Bodies (GT)"), STAT_RuntimeMesh_UpdateSectionCollisionBodies, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("Cook Body Setup Cached"), STAT_RuntimeMesh_CookBodySetupCached, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("Load Cooked Collision"), STAT_RuntimeMesh_LoadCookedData, STATGROUP_RuntimeMesh);
 DECLARE_CYCLE_STAT(TEXT("Update Local Bounds (GT)"), STAT_RuntimeMesh_UpdateLocalBounds, STATGROUP_RuntimeMesh);
 DECLARE_CYCLE_STAT(TEXT("Serialize"), STAT_RuntimeMesh_Serialize, STATGROUP_RuntimeMesh);
 
@@ -26,6 +26,66 @@ class FRuntimeMeshVisibilityInterface
 {
 public:
 	virtual bool ShouldRender() = 0;
+
+	/* Gets which elements of a static batch drawn with this sections vertex factory are visible */
+	virtual uint64 GetStaticBatchElementVisibility(const class FSceneView& View, const struct FMeshBatch* Batch) { return ShouldRender(); }
+
+	/* Gets which elements of a static batch drawn with this sections vertex factory cast shadows. The view is the camera's */
+	virtual uint64 GetStaticBatchElementShadowVisibility(const class FSceneView& View, const struct FMeshBatch* Batch) { return ShouldRender(); }
+};
+
+
+/* 
+ *	Sizing policy for the RT buffers. Buffers that are expected to be updated are allocated with some
+ *	headroom and only shrink once they're mostly empty, so that small size changes don't force the
+ *	buffer to be destroyed and recreated.
+ */
+struct FRuntimeMeshBufferSizing
+{
+	/* Extra capacity given to a buffer when it grows, as a fraction of the requested size */
+	static const int32 GrowthSlackDivisor = 2;
+
+	/* A buffer is shrunk once the used size drops below 1/ShrinkThresholdDivisor of its capacity */
+	static const int32 ShrinkThresholdDivisor = 4;
+
+	/* Capacity reserved for appended sections when they outgrow their buffer, as a multiple of the new size */
+	static const int32 AppendGrowthFactor = 2;
+
+	/* 
+	 *	Works out whether a buffer of CurrentCapacity elements can hold RequestedCount elements.
+	 *	Returns true if the buffer needs to be reallocated, in which case OutNewCapacity holds the new size.
+	 */
+	static bool NeedsReallocation(int32 RequestedCount, int32 CurrentCapacity, bool bAllowSlack, int32& OutNewCapacity)
+	{
+		if (!bAllowSlack)
+		{
+			OutNewCapacity = RequestedCount;
+			return RequestedCount != CurrentCapacity;
+		}
+
+		// Still fits, and isn't wasting enough space to be worth shrinking
+		if (RequestedCount <= CurrentCapacity && RequestedCount >= CurrentCapacity / ShrinkThresholdDivisor)
+		{
+			OutNewCapacity = CurrentCapacity;
+			return false;
+		}
+
+		OutNewCapacity = RequestedCount + RequestedCount / GrowthSlackDivisor;
+		return true;
+	}
+
+	/* Tracks whether a size change required a reallocation */
+	static void TrackResize(bool bReallocated)
+	{
+		if (bReallocated)
+		{
+			INC_DWORD_STAT(STAT_RuntimeMesh_BufferReallocations);
+		}
+		else
+		{
+			INC_DWORD_STAT(STAT_RuntimeMesh_BufferReallocationsAvoided);
+		}
+	}
 };
 
 
@@ -35,20 +95,25 @@ class FRuntimeMeshVertexBuffer : public FVertexBuffer
 {
 public:
 
-	FRuntimeMeshVertexBuffer(EUpdateFrequency SectionUpdateFrequency) : VertexCount(0)
+	FRuntimeMeshVertexBuffer(EUpdateFrequency SectionUpdateFrequency) : VertexCount(0), Capacity(0)
 	{
-		UsageFlags = SectionUpdateFrequency == EUpdateFrequency::Frequent ? BUF_Dynamic : BUF_Static;
+		UsageFlags = SectionUpdateFrequency == EUpdateFrequency::Frequent || SectionUpdateFrequency == EUpdateFrequency::Volatile ? BUF_Dynamic : BUF_Static;
+		bAllowSlack = SectionUpdateFrequency != EUpdateFrequency::Infrequent;
+		bKeepsLocalCopy = SectionUpdateFrequency == EUpdateFrequency::Average;
 	}
 
 	virtual void InitRHI() override
 	{
 		// Create the vertex buffer
 		FRHIResourceCreateInfo CreateInfo;
-		VertexBufferRHI = RHICreateVertexBuffer(sizeof(VertexType) * VertexCount, UsageFlags, CreateInfo);
+		VertexBufferRHI = RHICreateVertexBuffer(sizeof(VertexType) * Capacity, UsageFlags, CreateInfo);
 	}
 
 	/* Get the size of the vertex buffer */
 	int32 Num() { return VertexCount; }
+
+	/* Get the number of vertices the buffer can hold without reallocating */
+	int32 GetCapacity() const { return Capacity; }
 	
 	/* Set the size of the vertex buffer */
 	void SetNum(int32 NewVertexCount)
@@ -59,95 +124,635 @@ public:
 		if (NewVertexCount != VertexCount)
 		{
 			VertexCount = NewVertexCount;
-			
+
+			// Only rebuild the resource if it can't hold the new size
+			int32 NewCapacity;
+			bool bNeedsReallocation = FRuntimeMeshBufferSizing::NeedsReallocation(NewVertexCount, Capacity, bAllowSlack, NewCapacity);
+			if (bNeedsReallocation)
+			{
+				Capacity = NewCapacity;
+
+				// Rebuild resource
+				ReleaseResource();
+				InitResource();
+			}
+
+			FRuntimeMeshBufferSizing::TrackResize(bNeedsReallocation);
+		}
+	}
+
+	/* Makes sure the buffer can hold at least MinCapacity vertices. Reallocating loses the contents, so this must be followed by SetData() */
+	void Reserve(int32 MinCapacity)
+	{
+		if (MinCapacity > Capacity)
+		{
+			Capacity = MinCapacity;
+
 			// Rebuild resource
 			ReleaseResource();
 			InitResource();
+
+			FRuntimeMeshBufferSizing::TrackResize(true);
 		}
 	}
 
+	/* Extends the buffer into its existing capacity, keeping its contents */
+	void Grow(int32 NewVertexCount)
+	{
+		check(NewVertexCount <= Capacity);
+		VertexCount = FMath::Max(VertexCount, NewVertexCount);
+	}
+
 	/* Set the data for the vertex buffer */
 	void SetData(const TArray<VertexType>& Data)
 	{
 		check(Data.Num() == VertexCount);
 
-		// Lock the vertex buffer
- 		void* Buffer = RHILockVertexBuffer(VertexBufferRHI, 0, Data.Num() * sizeof(VertexType), RLM_WriteOnly);
- 		 
- 		// Write the vertices to the vertex buffer
- 		FMemory::Memcpy(Buffer, Data.GetData(), Data.Num() * sizeof(VertexType));
+		if (bKeepsLocalCopy)
+		{
+			LocalCopy = Data;
+		}
 
-		// Unlock the vertex buffer
- 		RHIUnlockVertexBuffer(VertexBufferRHI);
+		Upload(Data.GetData());
+	}
+
+	/*
+	 *	Writes only the supplied ranges of the vertex buffer. Data holds the vertices for each range back to back.
+	 *	Locking part of a buffer doesn't keep the rest of it on every RHI (D3D11 writes back the whole staging
+	 *	copy), so the ranges are patched into the local copy and the whole buffer is uploaded in one lock.
+	 */
+	void SetDataRanges(const TArray<VertexType>& Data, const TArray<FRuntimeMeshBufferSpan>& Spans)
+	{
+		check(bKeepsLocalCopy);
+
+		// Grow() may have extended the buffer, the new space is always covered by a range
+		LocalCopy.SetNum(VertexCount);
+
+		int32 DataOffset = 0;
+		for (const FRuntimeMeshBufferSpan& Span : Spans)
+		{
+			check(Span.End() <= VertexCount);
+			FMemory::Memcpy(LocalCopy.GetData() + Span.Start, Data.GetData() + DataOffset, Span.Count * sizeof(VertexType));
+			DataOffset += Span.Count;
+		}
+		check(DataOffset == Data.Num());
+
+		Upload(LocalCopy.GetData());
 	}
 
 private:
 
-	/* The number of vertices this buffer is currently allocated to hold */
+	/* Writes VertexCount vertices to the start of the buffer */
+	void Upload(const VertexType* Data)
+	{
+		// Lock the vertex buffer
+		void* Buffer = RHILockVertexBuffer(VertexBufferRHI, 0, VertexCount * sizeof(VertexType), RLM_WriteOnly);
+
+		// Write the vertices to the vertex buffer
+		FMemory::Memcpy(Buffer, Data, VertexCount * sizeof(VertexType));
+
+		// Unlock the vertex buffer
+		RHIUnlockVertexBuffer(VertexBufferRHI);
+	}
+
+	/* The number of vertices currently in use */
 	int32 VertexCount;
+	/* The number of vertices this buffer is currently allocated to hold */
+	int32 Capacity;
+	/* Can this buffer be allocated larger than needed to avoid reallocating on size changes */
+	bool bAllowSlack;
+	/* Does this buffer keep a copy of its contents so it can be updated in ranges */
+	bool bKeepsLocalCopy;
+	/* Copy of the buffer contents, only kept for buffers updated in ranges */
+	TArray<VertexType> LocalCopy;
 	/* The buffer configuration to use */
 	EBufferUsageFlags UsageFlags;
 };
 
-/** Index Buffer */
+/** Index Buffer. Uses 16 or 32 bit indices depending on the data it's given */
 class FRuntimeMeshIndexBuffer : public FIndexBuffer
 {
 public:
 
-	FRuntimeMeshIndexBuffer(EUpdateFrequency SectionUpdateFrequency) : IndexCount(0)
+	FRuntimeMeshIndexBuffer(EUpdateFrequency SectionUpdateFrequency) : IndexCount(0), Capacity(0), b32BitIndices(false)
 	{
-		UsageFlags = SectionUpdateFrequency == EUpdateFrequency::Frequent ? BUF_Dynamic : BUF_Static;
+		UsageFlags = SectionUpdateFrequency == EUpdateFrequency::Frequent || SectionUpdateFrequency == EUpdateFrequency::Volatile ? BUF_Dynamic : BUF_Static;
+		bAllowSlack = SectionUpdateFrequency != EUpdateFrequency::Infrequent;
+		bKeepsLocalCopy = SectionUpdateFrequency == EUpdateFrequency::Average;
 	}
 
 	virtual void InitRHI() override
 	{
 		// Create the index buffer
 		FRHIResourceCreateInfo CreateInfo;
-		IndexBufferRHI = RHICreateIndexBuffer(sizeof(int32), IndexCount * sizeof(int32), BUF_Dynamic, CreateInfo);
+		IndexBufferRHI = RHICreateIndexBuffer(GetStride(), Capacity * GetStride(), UsageFlags, CreateInfo);
 	}
 
 	/* Get the size of the index buffer */
 	int32 Num() { return IndexCount; }
 
-	/* Set the size of the index buffer */
-	void SetNum(int32 NewIndexCount)
+	/* Get the number of indices the buffer can hold without reallocating */
+	int32 GetCapacity() const { return Capacity; }
+
+	/* Is this buffer currently using 32 bit indices */
+	bool Is32Bit() const { return b32BitIndices; }
+
+	/* Set the size and index format of the index buffer */
+	void SetNum(int32 NewIndexCount, bool bUse32BitIndices)
 	{
 		check(NewIndexCount != 0);
 
-		// Make sure we're not already the right size
-		if (NewIndexCount != IndexCount)
+		// Make sure we're not already the right size and format
+		if (NewIndexCount != IndexCount || bUse32BitIndices != b32BitIndices)
 		{
 			IndexCount = NewIndexCount;
 
+			// Only rebuild the resource if it can't hold the new size, or the format changed
+			int32 NewCapacity;
+			bool bNeedsReallocation = FRuntimeMeshBufferSizing::NeedsReallocation(NewIndexCount, Capacity, bAllowSlack, NewCapacity) || bUse32BitIndices != b32BitIndices;
+			if (bNeedsReallocation)
+			{
+				Capacity = FMath::Max(NewCapacity, NewIndexCount);
+				b32BitIndices = bUse32BitIndices;
+
+				// Rebuild resource
+				ReleaseResource();
+				InitResource();
+			}
+
+			FRuntimeMeshBufferSizing::TrackResize(bNeedsReallocation);
+		}
+	}
+
+	/* Makes sure the buffer can hold at least MinCapacity indices. Reallocating loses the contents, so this must be followed by SetData() */
+	void Reserve(int32 MinCapacity)
+	{
+		if (MinCapacity > Capacity)
+		{
+			Capacity = MinCapacity;
+
 			// Rebuild resource
 			ReleaseResource();
 			InitResource();
+
+			FRuntimeMeshBufferSizing::TrackResize(true);
 		}
 	}
 
+	/* Extends the buffer into its existing capacity, keeping its contents */
+	void Grow(int32 NewIndexCount)
+	{
+		check(NewIndexCount <= Capacity);
+		IndexCount = FMath::Max(IndexCount, NewIndexCount);
+	}
+
 	/* Set the data for the index buffer */
-	void SetData(const TArray<int32>& Data)
+	void SetData(const FRuntimeMeshIndexData& Data)
 	{
 		check(Data.Num() == IndexCount);
+		check(Data.b32BitIndices == b32BitIndices);
+
+		if (bKeepsLocalCopy)
+		{
+			LocalCopy.SetNumUninitialized(IndexCount * GetStride());
+			FMemory::Memcpy(LocalCopy.GetData(), Data.GetData(), IndexCount * GetStride());
+		}
 
+		Upload(Data.GetData());
+	}
+
+	/*
+	 *	Writes only the supplied ranges of the index buffer. Data holds the indices for each range back to back.
+	 *	As with the vertex buffer, the ranges are patched into the local copy and the whole buffer is uploaded.
+	 */
+	void SetDataRanges(const FRuntimeMeshIndexData& Data, const TArray<FRuntimeMeshBufferSpan>& Spans)
+	{
+		check(bKeepsLocalCopy);
+		check(Data.b32BitIndices == b32BitIndices);
+
+		// Grow() may have extended the buffer, the new space is always covered by a range
+		LocalCopy.SetNumZeroed(IndexCount * GetStride());
+
+		const uint8* Source = (const uint8*)Data.GetData();
+		int32 DataOffset = 0;
+		for (const FRuntimeMeshBufferSpan& Span : Spans)
+		{
+			check(Span.End() <= IndexCount);
+			FMemory::Memcpy(LocalCopy.GetData() + Span.Start * GetStride(), Source + DataOffset * GetStride(), Span.Count * GetStride());
+			DataOffset += Span.Count;
+		}
+		check(DataOffset == Data.Num());
+
+		Upload(LocalCopy.GetData());
+	}
+
+private:
+
+	/* Gets the size of a single index */
+	uint32 GetStride() const { return b32BitIndices ? sizeof(int32) : sizeof(uint16); }
+
+	/* Writes IndexCount indices to the start of the buffer */
+	void Upload(const void* Data)
+	{
 		// Lock the index buffer
-		void* Buffer = RHILockIndexBuffer(IndexBufferRHI, 0, IndexCount * sizeof(int32), RLM_WriteOnly);
+		void* Buffer = RHILockIndexBuffer(IndexBufferRHI, 0, IndexCount * GetStride(), RLM_WriteOnly);
 
-		// Write the indices to the vertex buffer	
-		FMemory::Memcpy(Buffer, Data.GetData(), Data.Num() * sizeof(int32));
+		// Write the indices to the index buffer
+		FMemory::Memcpy(Buffer, Data, IndexCount * GetStride());
 
 		// Unlock the index buffer
 		RHIUnlockIndexBuffer(IndexBufferRHI);
 	}
 
+	/* The number of indices currently in use */
+	int32 IndexCount;
+	/* The number of indices this buffer is currently allocated to hold */
+	int32 Capacity;
+	/* Can this buffer be allocated larger than needed to avoid reallocating on size changes */
+	bool bAllowSlack;
+	/* Whether this buffer is currently using 32 bit indices */
+	bool b32BitIndices;
+	/* Does this buffer keep a copy of its contents so it can be updated in ranges */
+	bool bKeepsLocalCopy;
+	/* Copy of the buffer contents, only kept for buffers updated in ranges */
+	TArray<uint8> LocalCopy;
+	/* The buffer configuration to use */
+	EBufferUsageFlags UsageFlags;
+};
+
+/*
+ *	Vertex buffer holding a subset of the attributes of a section's vertices, packed tightly so that
+ *	those attributes can be rewritten without uploading the whole vertex. The attributes are gathered
+ *	from the interleaved vertices, so it works for any vertex type.
+ */
+class FRuntimeMeshVertexStreamBuffer : public FVertexBuffer
+{
+public:
+
+	FRuntimeMeshVertexStreamBuffer(EUpdateFrequency SectionUpdateFrequency) : Stride(0), VertexCount(0), Capacity(0)
+	{
+		UsageFlags = SectionUpdateFrequency == EUpdateFrequency::Frequent || SectionUpdateFrequency == EUpdateFrequency::Volatile ? BUF_Dynamic : BUF_Static;
+		bAllowSlack = SectionUpdateFrequency != EUpdateFrequency::Infrequent;
+	}
+
+	virtual void InitRHI() override
+	{
+		// Create the vertex buffer
+		FRHIResourceCreateInfo CreateInfo;
+		VertexBufferRHI = RHICreateVertexBuffer(Stride * Capacity, UsageFlags, CreateInfo);
+	}
+
+	/* Gets the size in bytes of a single vertex element */
+	static int32 GetVertexElementSize(EVertexElementType Type)
+	{
+		switch (Type)
+		{
+		case VET_Float1: return 4;
+		case VET_Float2: return 8;
+		case VET_Float3: return 12;
+		case VET_Float4: return 16;
+		case VET_Half2: return 4;
+		case VET_Half4: return 8;
+		case VET_Short2:
+		case VET_Short2N: return 4;
+		case VET_Short4:
+		case VET_Short4N: return 8;
+		case VET_PackedNormal:
+		case VET_UByte4:
+		case VET_UByte4N:
+		case VET_Color: return 4;
+		default:
+			checkf(false, TEXT("Unsupported vertex element type in a RuntimeMesh vertex stream."));
+			return 0;
+		}
+	}
+
+	/* 
+	 *	Moves the supplied components of the vertex factory data into this buffer. Components not bound to 
+	 *	a buffer are skipped. The components are pointed at this buffer, so this must be called before the 
+	 *	vertex factory is initialized.
+	 */
+	void SetComponents(const TArray<FVertexStreamComponent*>& Components)
+	{
+		Elements.Empty(Components.Num());
+		Stride = 0;
+
+		for (FVertexStreamComponent* Component : Components)
+		{
+			if (Component->VertexBuffer == nullptr)
+			{
+				continue;
+			}
+
+			FElement& Element = Elements[Elements.AddUninitialized()];
+			Element.SourceOffset = Component->Offset;
+			Element.Size = GetVertexElementSize(Component->Type);
+			Element.StreamOffset = Stride;
+			Stride += Element.Size;
+		}
+
+		int32 ElementIndex = 0;
+		for (FVertexStreamComponent* Component : Components)
+		{
+			if (Component->VertexBuffer != nullptr)
+			{
+				*Component = FVertexStreamComponent(this, Elements[ElementIndex++].StreamOffset, Stride, Component->Type);
+			}
+		}
+	}
+
+	/* Does this buffer hold any attributes */
+	bool HasComponents() const { return Elements.Num() > 0; }
+
+	/* Get the size of the vertex buffer */
+	int32 Num() { return VertexCount; }
+
+	/* Set the size of the vertex buffer */
+	void SetNum(int32 NewVertexCount)
+	{
+		check(NewVertexCount != 0);
+
+		// Make sure we're not already the right size
+		if (NewVertexCount != VertexCount)
+		{
+			VertexCount = NewVertexCount;
+
+			// Only rebuild the resource if it can't hold the new size
+			int32 NewCapacity;
+			bool bNeedsReallocation = FRuntimeMeshBufferSizing::NeedsReallocation(NewVertexCount, Capacity, bAllowSlack, NewCapacity);
+			if (bNeedsReallocation)
+			{
+				Capacity = NewCapacity;
+
+				// Rebuild resource
+				ReleaseResource();
+				InitResource();
+			}
+
+			FRuntimeMeshBufferSizing::TrackResize(bNeedsReallocation);
+		}
+	}
+
+	/* Gathers this buffer's attributes from interleaved vertices of VertexStride bytes each */
+	void SetData(const uint8* InterleavedVertices, int32 NumVertices, int32 VertexStride)
+	{
+		check(NumVertices == VertexCount);
+
+		// Lock the vertex buffer
+		uint8* Buffer = (uint8*)RHILockVertexBuffer(VertexBufferRHI, 0, NumVertices * Stride, RLM_WriteOnly);
+
+		// Copy each attribute out of the interleaved vertex
+		for (int32 VertexIndex = 0; VertexIndex < NumVertices; VertexIndex++)
+		{
+			const uint8* Source = InterleavedVertices + VertexIndex * VertexStride;
+			uint8* Dest = Buffer + VertexIndex * Stride;
+			for (const FElement& Element : Elements)
+			{
+				FMemory::Memcpy(Dest + Element.StreamOffset, Source + Element.SourceOffset, Element.Size);
+			}
+		}
+
+		// Unlock the vertex buffer
+		RHIUnlockVertexBuffer(VertexBufferRHI);
+	}
+
 private:
 
-	/* The number of indices this buffer is currently allocated to hold */
-	int32 IndexCount;
+	/* An attribute held by this buffer */
+	struct FElement
+	{
+		/* Offset of the attribute within the interleaved vertex */
+		int32 SourceOffset;
+		/* Size of the attribute in bytes */
+		int32 Size;
+		/* Offset of the attribute within this buffer's vertex */
+		int32 StreamOffset;
+	};
+
+	/* The attributes held by this buffer */
+	TArray<FElement, TInlineAllocator<MAX_TEXCOORDS>> Elements;
+	/* Size of a single vertex in this buffer */
+	int32 Stride;
+	/* The number of vertices currently in use */
+	int32 VertexCount;
+	/* The number of vertices this buffer is currently allocated to hold */
+	int32 Capacity;
+	/* Can this buffer be allocated larger than needed to avoid reallocating on size changes */
+	bool bAllowSlack;
 	/* The buffer configuration to use */
 	EBufferUsageFlags UsageFlags;
 };
 
+/*
+ *	Per instance vertex buffer of an instanced section, in the layout the instancing path of the local vertex 
+ *	factory shader reads. Each instance is read once for all of the section's vertices, so the whole section is drawn 
+ *	for every instance in a single draw call.
+ */
+class FRuntimeMeshInstanceBuffer : public FVertexBuffer
+{
+public:
+	/* Data of a single instance */
+	struct FInstance
+	{
+		/* Translation of the instance in xyz, and a random value for the material in w */
+		FVector4 Origin;
+		/* Rows of the rotation and scale of the instance */
+		FVector4 Transform[3];
+		/* Lightmap and shadowmap UV bias, unused as sections have no static lighting */
+		FVector4 LightmapAndShadowMapUVBias;
+	};
+
+	FRuntimeMeshInstanceBuffer() : InstanceCount(0), Capacity(0) { }
+
+	virtual void InitRHI() override
+	{
+		// Create the vertex buffer
+		FRHIResourceCreateInfo CreateInfo;
+		VertexBufferRHI = RHICreateVertexBuffer(sizeof(FInstance) * Capacity, BUF_Static, CreateInfo);
+	}
+
+	/* Get the number of instances in the buffer */
+	int32 Num() const { return InstanceCount; }
+
+	/* Set the number of instances in the buffer */
+	void SetNum(int32 NewInstanceCount)
+	{
+		check(NewInstanceCount != 0);
+
+		// Make sure we're not already the right size
+		if (NewInstanceCount != InstanceCount)
+		{
+			InstanceCount = NewInstanceCount;
+
+			// Instances are expected to come and go, so the buffer gets some room to grow
+			int32 NewCapacity;
+			bool bNeedsReallocation = FRuntimeMeshBufferSizing::NeedsReallocation(NewInstanceCount, Capacity, true, NewCapacity);
+			if (bNeedsReallocation)
+			{
+				Capacity = NewCapacity;
+
+				// Rebuild resource
+				ReleaseResource();
+				InitResource();
+			}
+
+			FRuntimeMeshBufferSizing::TrackResize(bNeedsReallocation);
+		}
+	}
+
+	/* Set the instances from their transforms relative to the component */
+	void SetData(const TArray<FMatrix>& Transforms)
+	{
+		check(Transforms.Num() == InstanceCount);
+
+		// Lock the vertex buffer
+		FInstance* Buffer = (FInstance*)RHILockVertexBuffer(VertexBufferRHI, 0, InstanceCount * sizeof(FInstance), RLM_WriteOnly);
+
+		// Seeded the same every time, so each instance keeps its random value across updates
+		FRandomStream RandomStream(0);
+		for (int32 InstanceIndex = 0; InstanceIndex < InstanceCount; InstanceIndex++)
+		{
+			const FMatrix& Transform = Transforms[InstanceIndex];
+			FInstance& Instance = Buffer[InstanceIndex];
+			Instance.Origin = FVector4(Transform.GetOrigin(), RandomStream.GetFraction());
+			Instance.Transform[0] = FVector4(Transform.M[0][0], Transform.M[0][1], Transform.M[0][2], 0.0f);
+			Instance.Transform[1] = FVector4(Transform.M[1][0], Transform.M[1][1], Transform.M[1][2], 0.0f);
+			Instance.Transform[2] = FVector4(Transform.M[2][0], Transform.M[2][1], Transform.M[2][2], 0.0f);
+			Instance.LightmapAndShadowMapUVBias = FVector4(0.0f, 0.0f, 0.0f, 0.0f);
+		}
+
+		// Unlock the vertex buffer
+		RHIUnlockVertexBuffer(VertexBufferRHI);
+	}
+
+private:
+
+	/* The number of instances currently in use */
+	int32 InstanceCount;
+	/* The number of instances this buffer is currently allocated to hold */
+	int32 Capacity;
+};
+
+/* 
+ *	Interface for RT sections that are rewritten every frame. Rather than owning their own buffers
+ *	these are written into the shared volatile ring buffers once per frame.
+ */
+class FRuntimeMeshVolatileSectionInterface
+{
+public:
+	virtual ~FRuntimeMeshVolatileSectionInterface() { }
+
+	/* Gets the size of a single vertex */
+	virtual int32 GetVolatileVertexStride() const = 0;
+
+	/* Gets the number of vertices to write this frame */
+	virtual int32 GetVolatileNumVertices() const = 0;
+
+	/* Gets the number of indices to write this frame */
+	virtual int32 GetVolatileNumIndices() const = 0;
+
+	/* Gets a number that changes whenever the vertices or indices change, so unchanged sections aren't written again */
+	virtual uint32 GetVolatileDataVersion() const = 0;
+
+	/* 
+	 *	Writes the vertices and indices. Indices must be offset by BaseVertexIndex
+	 *	as every volatile section shares the same vertex buffer.
+	 */
+	virtual void WriteVolatileData(uint8* VertexData, uint32* IndexData, uint32 BaseVertexIndex) = 0;
+
+	/* Tells the section where its data is in the ring buffer for this frame, whether or not it was written this frame */
+	virtual void SetVolatileRange(uint32 BaseVertexIndex, uint32 FirstIndex, uint32 FrameNumber) = 0;
+};
+
+/* 
+ *	Shared buffers for volatile sections, in a small ring so we never write to a buffer the GPU could still be
+ *	reading. Sections keep their place in the buffers for as long as their sizes don't change. Frames where no
+ *	section changed write nothing and keep drawing from the current buffer. Otherwise every section is written
+ *	to the next buffer in the ring. Indices are always 32 bit here as they're offset into the shared vertex buffer.
+ */
+class RUNTIMEMESHCOMPONENT_API FRuntimeMeshVolatileRingBuffer : public FRenderResource
+{
+public:
+	/* Number of frames the ring covers */
+	static const int32 NumRingFrames = 3;
+
+	FRuntimeMeshVolatileRingBuffer();
+
+	/* Gets the ring buffer shared by all volatile sections. RT only */
+	static FRuntimeMeshVolatileRingBuffer& Get();
+
+	/* Adds a section to be written every frame */
+	void Register(FRuntimeMeshVolatileSectionInterface* Section);
+
+	/* Removes a section so it is no longer written */
+	void Unregister(FRuntimeMeshVolatileSectionInterface* Section);
+
+	/* Writes all registered sections for the current frame. Only does any work the first time it's called in a frame */
+	void CommitFrame();
+
+	/* Gets the vertex buffer all volatile sections read from. Always points at the current frame's buffer */
+	const FVertexBuffer& GetVertexBuffer() const { return VertexBuffer; }
+
+	/* Gets the index buffer all volatile sections read from. Always points at the current frame's buffer */
+	const FIndexBuffer& GetIndexBuffer() const { return IndexBuffer; }
+
+	virtual void ReleaseRHI() override;
+
+private:
+	/* The buffers the vertex factories and mesh batches are bound to. These are retargeted whenever a new ring entry is written */
+	FVertexBuffer VertexBuffer;
+	FIndexBuffer IndexBuffer;
+
+	/* The ring of real buffers, one per frame in flight */
+	FVertexBufferRHIRef VertexRing[NumRingFrames];
+	FIndexBufferRHIRef IndexRing[NumRingFrames];
+
+	/* Allocated size of each ring entry, in bytes for vertices and in indices for indices */
+	int32 VertexRingCapacity[NumRingFrames];
+	int32 IndexRingCapacity[NumRingFrames];
+
+	/* The ring entry used by the current frame */
+	int32 CurrentRingIndex;
+
+	/* The last frame that was committed */
+	uint32 LastCommittedFrame;
+
+	/* A registered section and where it's placed in the buffers */
+	struct FSectionSlot
+	{
+		FRuntimeMeshVolatileSectionInterface* Section;
+
+		/* Layout the slot was placed with. Any change to these moves every section */
+		int32 Stride;
+		int32 NumVertices;
+		int32 NumIndices;
+
+		/* Placement in every ring entry */
+		int32 VertexByteOffset;
+		int32 FirstIndex;
+
+		/* Data version of the section last written to each ring entry */
+		uint32 WrittenVersion[NumRingFrames];
+	};
+
+	/* Works out the placement of every section, when they've been added, removed or resized */
+	void UpdateLayout();
+
+	/* All registered sections */
+	TArray<FSectionSlot> Sections;
+
+	/* Has a section been added or removed since the layout was worked out */
+	bool bIsLayoutDirty;
+
+	/* Changed every time the layout is worked out, so we know whether a ring entry was written with the current layout */
+	uint32 LayoutGeneration;
+	uint32 RingLayoutGeneration[NumRingFrames];
+
+	/* Size of the current layout, in bytes for vertices and in indices for indices */
+	int32 TotalVertexBytes;
+	int32 TotalIndices;
+};
+
 /** Vertex Factory */
 class FRuntimeMeshVertexFactory : public FLocalVertexFactory
 {
@@ -178,10 +783,45 @@ public:
 	/* Gets the section visibility for static sections */
 	virtual uint64 GetStaticBatchElementVisibility(const class FSceneView& View, const struct FMeshBatch* Batch) const override
 	{
-		return SectionParent->ShouldRender();
+		return SectionParent->GetStaticBatchElementVisibility(View, Batch);
+	}
+
+	virtual uint64 GetStaticBatchElementShadowVisibility(const class FSceneView& View, const class FLightSceneProxy* LightSceneProxy, const struct FMeshBatch* Batch) const override
+	{
+		return SectionParent->GetStaticBatchElementShadowVisibility(View, Batch);
 	}
 
 private:
 	/* Interface to the parent section for checking visibility.*/
 	FRuntimeMeshVisibilityInterface* SectionParent;
 };
+
+/* 
+ *	Vertex factory for instanced sections. Reads the section's vertices the same way as FRuntimeMeshVertexFactory, 
+ *	and places each instance from the per instance streams of a FRuntimeMeshInstanceBuffer. The engine's instanced 
+ *	static mesh vertex factory isn't exported, so this compiles the local vertex factory shader with instancing 
+ *	itself. The section's material has to be set up to be used with instanced static meshes. Platforms without 
+ *	hardware instancing aren't supported.
+ */
+class FRuntimeMeshInstancedVertexFactory : public FLocalVertexFactory
+{
+	DECLARE_VERTEX_FACTORY_TYPE(FRuntimeMeshInstancedVertexFactory);
+public:
+
+	/* Sets up the factory from the section's vertex structure and its instance buffer. RT only */
+	void Init(const RuntimeMeshVertexStructure& VertexStructure, const FRuntimeMeshInstanceBuffer& InstanceBuffer);
+
+	static bool ShouldCache(EShaderPlatform Platform, const class FMaterial* Material, const class FShaderType* ShaderType);
+
+	static void ModifyCompilationEnvironment(EShaderPlatform Platform, const FMaterial* Material, FShaderCompilerEnvironment& OutEnvironment);
+
+	static FVertexFactoryShaderParameters* ConstructShaderParameters(EShaderFrequency ShaderFrequency);
+
+	virtual void InitRHI() override;
+
+private:
+	/* Per instance streams, read once per instance instead of once per vertex */
+	FVertexStreamComponent InstanceOriginComponent;
+	FVertexStreamComponent InstanceTransformComponent[3];
+	FVertexStreamComponent InstanceLightmapAndShadowMapUVBiasComponent;
+};
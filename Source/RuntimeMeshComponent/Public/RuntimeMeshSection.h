@@ -9,6 +9,7 @@
 #include "RuntimeMeshSectionProxy.h"
 #include "RuntimeMeshBuilder.h"
 #include "RuntimeMeshLibrary.h"
+#include "RuntimeMeshBounds.h"
 
 /** Interface class for a single mesh section */
 class FRuntimeMeshSectionInterface
@@ -44,13 +45,48 @@ public:
 	/** Update frequency of this section */
 	EUpdateFrequency UpdateFrequency;
 
+	/** Should this section live in the shared buffer pool instead of owning its own buffers */
+	bool bUseSharedBufferPool;
+
+	/** Vertex attributes kept in separate RT buffers, so they can be updated without sending the whole vertex */
+	ERuntimeMeshVertexStream SeparateStreams;
+
+	/** Distance past which this section isn't drawn. 0 for no limit */
+	float MaxDrawDistance;
+
+	/** LOD of the component this section is drawn at. INDEX_NONE for every LOD */
+	int32 LODIndex;
+
+	/** Is this section drawn once per instance instead of once at the component */
+	bool bIsInstanced;
+
+	/** Transforms of the instances of this section, relative to the component */
+	TArray<FTransform> InstanceTransforms;
+
+	/** Ranges of the vertex buffer changed by range updates since the last RT update */
+	FRuntimeMeshDirtySpans DirtyVertexSpans;
+
+	/** Ranges of the index buffer changed by range updates since the last RT update */
+	FRuntimeMeshDirtySpans DirtyIndexSpans;
+
 	FRuntimeMeshSectionInterface(bool bInNeedsPositionOnlyBuffer) : 
 		bNeedsPositionOnlyBuffer(bInNeedsPositionOnlyBuffer),
 		LocalBoundingBox(0),
 		CollisionEnabled(false),
 		bIsVisible(true),
 		bCastsShadow(true),
-		bIsInternalSectionType(false)
+		bUseSharedBufferPool(false),
+		SeparateStreams(ERuntimeMeshVertexStream::None),
+		MaxDrawDistance(0.0f),
+		LODIndex(INDEX_NONE),
+		bIsInstanced(false),
+		bIsInternalSectionType(false),
+		bRenderIndicesAre32Bit(false),
+		RenderVertexCapacity(0),
+		RenderIndexCapacity(0),
+		StaticDrawNumVertices(0),
+		StaticDrawNumIndices(0),
+		bStaticDrawUsesAdjacency(false)
 	{}
 
 	virtual ~FRuntimeMeshSectionInterface() { }
@@ -60,8 +96,31 @@ protected:
 	/** Is this an internal section type. */
 	bool bIsInternalSectionType;
 
+	/** Whether the index buffer last sent to the RT used 32 bit indices */
+	bool bRenderIndicesAre32Bit;
+
+	/** Number of vertices the RT vertex buffer is known to have room for. Ranges past its end can be written up to this */
+	int32 RenderVertexCapacity;
+
+	/** Number of indices the RT index buffer is known to have room for. Ranges past its end can be written up to this */
+	int32 RenderIndexCapacity;
+
+	/** 
+	 *	Vertex and index counts the RT section was created with. The static draw lists keep the counts of static 
+	 *	sections, so those can only be updated without recreating the scene proxy while the counts stay the same.
+	 */
+	int32 StaticDrawNumVertices;
+	int32 StaticDrawNumIndices;
+	bool bStaticDrawUsesAdjacency;
+
 	bool IsDualBufferSection() const { return bNeedsPositionOnlyBuffer; }
 
+	/* Will the RT proxy of this section actually be placed in the shared buffer pool */
+	bool IsUsingSharedBufferPool() const 
+	{ 
+		return bUseSharedBufferPool && !bNeedsPositionOnlyBuffer && UpdateFrequency != EUpdateFrequency::Volatile && SeparateStreams == ERuntimeMeshVertexStream::None; 
+	}
+
 	/* Updates the vertex position buffer,   returns whether we have a new bounding box */
 	bool UpdateVertexPositionBuffer(TArray<FVector>& Positions, const FBox* BoundingBox, bool bShouldMoveArray)
 	{
@@ -76,10 +135,7 @@ protected:
 			// Calculate the bounding box if one doesn't exist.
 			if (BoundingBox == nullptr)
 			{
-				for (int32 VertexIdx = 0; VertexIdx < PositionVertexBuffer.Num(); VertexIdx++)
-				{
-					NewBoundingBox += PositionVertexBuffer[VertexIdx];
-				}
+				NewBoundingBox = FRuntimeMeshBounds::Calculate(PositionVertexBuffer.GetData(), PositionVertexBuffer.Num());
 			}
 			else
 			{
@@ -94,11 +150,7 @@ protected:
 				// Copy the buffer and calculate the bounding box at the same time
 				int32 NumVertices = Positions.Num();
 				PositionVertexBuffer.SetNumUninitialized(NumVertices);
-				for (int32 VertexIdx = 0; VertexIdx < NumVertices; VertexIdx++)
-				{
-					NewBoundingBox += Positions[VertexIdx];
-					PositionVertexBuffer[VertexIdx] = Positions[VertexIdx];
-				}
+				NewBoundingBox = FRuntimeMeshBounds::CopyAndCalculate(PositionVertexBuffer.GetData(), Positions.GetData(), NumVertices);
 			}
 			else
 			{
@@ -132,6 +184,20 @@ protected:
 		}
 	}
 
+	/* Overwrites part of the index buffer, tracking the changed range so only it is sent to the RT */
+	void UpdateIndexBufferRange(const TArray<int32>& Triangles, int32 FirstIndex)
+	{
+		FMemory::Memcpy(IndexBuffer.GetData() + FirstIndex, Triangles.GetData(), Triangles.Num() * sizeof(int32));
+		DirtyIndexSpans.Add(FirstIndex, Triangles.Num());
+	}
+
+	/* Adds to the end of the index buffer, tracking the new range so only it is sent to the RT */
+	void AppendIndexBuffer(const TArray<int32>& Triangles)
+	{
+		DirtyIndexSpans.Add(IndexBuffer.Num(), Triangles.Num());
+		IndexBuffer.Append(Triangles);
+	}
+
 	void UpdateTessellationIndexBuffer(TArray<int32>& Triangles, bool bShouldMoveArray)
 	{
 		if (bShouldMoveArray)
@@ -150,8 +216,20 @@ protected:
 
 	virtual FRuntimeMeshRenderThreadCommandInterface* GetSectionPositionUpdateData() const = 0;
 
+	/* Gets an update rewriting only the supplied separate vertex streams */
+	virtual FRuntimeMeshRenderThreadCommandInterface* GetSectionStreamUpdateData(ERuntimeMeshVertexStream Streams) const = 0;
+
+	/* Estimates the bytes an update of this section would send to the RT */
+	virtual int32 GetUploadSize(bool bIncludePositionVertices, bool bIncludeVertices, bool bIncludeIndices) const = 0;
+
+	/* Can the RT buffers of this section be rewritten without the static draw lists needing to be rebuilt */
+	virtual bool CanUpdateStaticDrawInPlace() const = 0;
+
 	virtual void RecalculateBoundingBox() = 0;
 
+	/* Takes back sole ownership of vertices shared with the RT, so the GT can modify them */
+	virtual void ReclaimSharedVertexBuffer() = 0;
+
 
 	virtual int32 GetAllVertexPositions(TArray<FVector>& Positions) = 0;
 
@@ -183,6 +261,49 @@ protected:
 		int32 UpdateFreq = (int32)UpdateFrequency;
 		Ar << UpdateFreq;
 		UpdateFrequency = (EUpdateFrequency)UpdateFreq;
+
+		if (Ar.CustomVer(FRuntimeMeshVersion::GUID) >= FRuntimeMeshVersion::SeparateVertexStreams)
+		{
+			int32 Streams = (int32)SeparateStreams;
+			Ar << Streams;
+			SeparateStreams = (ERuntimeMeshVertexStream)Streams;
+		}
+
+		if (Ar.CustomVer(FRuntimeMeshVersion::GUID) >= FRuntimeMeshVersion::SectionInstances)
+		{
+			Ar << bIsInstanced;
+			Ar << InstanceTransforms;
+		}
+
+		if (Ar.CustomVer(FRuntimeMeshVersion::GUID) >= FRuntimeMeshVersion::SectionDrawSettings)
+		{
+			Ar << LODIndex;
+			Ar << MaxDrawDistance;
+		}
+	}
+
+	/* Gets the instance transforms as matrices for the RT */
+	void GetInstanceMatrices(TArray<FMatrix>& OutMatrices) const
+	{
+		OutMatrices.SetNumUninitialized(InstanceTransforms.Num());
+		for (int32 InstanceIndex = 0; InstanceIndex < InstanceTransforms.Num(); InstanceIndex++)
+		{
+			OutMatrices[InstanceIndex] = InstanceTransforms[InstanceIndex].ToMatrixWithScale();
+		}
+	}
+
+	/* Gets the bounds of every instance of this section, relative to the component */
+	FBox GetInstancedBoundingBox() const
+	{
+		FBox InstancedBoundingBox(0);
+		if (LocalBoundingBox.IsValid)
+		{
+			for (const FTransform& Instance : InstanceTransforms)
+			{
+				InstancedBoundingBox += LocalBoundingBox.TransformBy(Instance);
+			}
+		}
+		return InstancedBoundingBox;
 	}
 	
 	friend FArchive& operator <<(FArchive& Ar, FRuntimeMeshSectionInterface& Section)
@@ -193,6 +314,7 @@ protected:
 
 	friend class FRuntimeMeshSceneProxy;
 	friend class URuntimeMeshComponent;
+	friend class FRuntimeMeshUploadScheduler;
 };
 
 namespace RuntimeMeshSectionInternal
@@ -234,10 +356,7 @@ namespace RuntimeMeshSectionInternal
 			// Calculate the bounding box if one doesn't exist.
 			if (BoundingBox == nullptr)
 			{
-				for (int32 VertexIdx = 0; VertexIdx < VertexBuffer.Num(); VertexIdx++)
-				{
-					NewBoundingBox += VertexBuffer[VertexIdx].Position;
-				}
+				NewBoundingBox = FRuntimeMeshBounds::Calculate(VertexBuffer.GetData(), VertexBuffer.Num());
 			}
 			else
 			{
@@ -252,11 +371,7 @@ namespace RuntimeMeshSectionInternal
 				// Copy the buffer and calculate the bounding box at the same time
 				int32 NumVertices = Vertices.Num();
 				VertexBuffer.SetNumUninitialized(NumVertices);
-				for (int32 VertexIdx = 0; VertexIdx < NumVertices; VertexIdx++)
-				{
-					NewBoundingBox += Vertices[VertexIdx].Position;
-					VertexBuffer[VertexIdx] = Vertices[VertexIdx];
-				}
+				NewBoundingBox = FRuntimeMeshBounds::CopyAndCalculate(VertexBuffer.GetData(), Vertices.GetData(), NumVertices);
 			}
 			else
 			{
@@ -295,16 +410,46 @@ namespace RuntimeMeshSectionInternal
 
 
 	template<typename Type>
-	static typename TEnableIf<FRuntimeMeshVertexTraits<Type>::HasPosition>::Type	RecalculateBoundingBox(TArray<Type>& VertexBuffer, FBox& BoundingBox)
+	static typename TEnableIf<FRuntimeMeshVertexTraits<Type>::HasPosition, bool>::Type
+		UpdateVertexBufferRangeInternal(TArray<Type>& VertexBuffer, FBox& LocalBoundingBox, const TArray<Type>& Vertices, int32 FirstVertex)
+	{
+		// The bounding box can only grow here, as we don't know what the overwritten vertices contributed.
+		FBox NewBoundingBox = LocalBoundingBox;
+
+		// Copy the range and grow the bounding box at the same time
+		NewBoundingBox += FRuntimeMeshBounds::CopyAndCalculate(VertexBuffer.GetData() + FirstVertex, Vertices.GetData(), Vertices.Num());
+
+		// Update the bounding box if necessary and alert our caller if we did
+		if (!(LocalBoundingBox == NewBoundingBox))
+		{
+			LocalBoundingBox = NewBoundingBox;
+			return true;
+		}
+
+		return false;
+	}
+
+	template<typename Type>
+	static typename TEnableIf<!FRuntimeMeshVertexTraits<Type>::HasPosition, bool>::Type
+		UpdateVertexBufferRangeInternal(TArray<Type>& VertexBuffer, FBox& LocalBoundingBox, const TArray<Type>& Vertices, int32 FirstVertex)
 	{
-		for (int32 Index = 0; Index < VertexBuffer.Num(); Index++)
+		int32 NumVertices = Vertices.Num();
+		for (int32 VertexIdx = 0; VertexIdx < NumVertices; VertexIdx++)
 		{
-			BoundingBox += VertexBuffer[Index].Position;
+			VertexBuffer[FirstVertex + VertexIdx] = Vertices[VertexIdx];
 		}
+		return false;
+	}
+
+
+	template<typename Type>
+	static typename TEnableIf<FRuntimeMeshVertexTraits<Type>::HasPosition>::Type	RecalculateBoundingBox(const TArray<Type>& VertexBuffer, FBox& BoundingBox)
+	{
+		BoundingBox += FRuntimeMeshBounds::Calculate(VertexBuffer.GetData(), VertexBuffer.Num());
 	}
 
 	template<typename Type>
-	static typename TEnableIf<!FRuntimeMeshVertexTraits<Type>::HasPosition>::Type RecalculateBoundingBox(TArray<Type>& VertexBuffer, FBox& BoundingBox)
+	static typename TEnableIf<!FRuntimeMeshVertexTraits<Type>::HasPosition>::Type RecalculateBoundingBox(const TArray<Type>& VertexBuffer, FBox& BoundingBox)
 	{
 	}
 
@@ -316,21 +461,81 @@ class FRuntimeMeshSection : public FRuntimeMeshSectionInterface
 {
 
 public:
-	/** Vertex buffer for this section */
+	/** Vertex buffer for this section. Empty while the vertices are shared with the RT, see GetVertexBuffer() */
 	TArray<VertexType> VertexBuffer;
 
 	FRuntimeMeshSection(bool bInNeedsPositionOnlyBuffer) : FRuntimeMeshSectionInterface(bInNeedsPositionOnlyBuffer) { }
 	virtual ~FRuntimeMeshSection() override { }
 
+	/* Gets the vertices of this section, wherever they're currently stored */
+	const TArray<VertexType>& GetVertexBuffer() const { return SharedVertexBuffer.IsValid() ? *SharedVertexBuffer : VertexBuffer; }
 
 protected:
+	/*
+	 *	Vertices handed to the RT by reference instead of copied. While set this holds the sections 
+	 *	vertices and must not be modified, as the RT may still be reading it.
+	 */
+	TSharedPtr<TArray<VertexType>, ESPMode::ThreadSafe> SharedVertexBuffer;
+
+	/* Moves the vertices into the shared buffer so commands can reference them instead of copying */
+	TSharedPtr<const TArray<VertexType>, ESPMode::ThreadSafe> ShareVertexBuffer()
+	{
+		if (!SharedVertexBuffer.IsValid())
+		{
+			SharedVertexBuffer = MakeShareable(new TArray<VertexType>(MoveTemp(VertexBuffer)));
+		}
+		return SharedVertexBuffer;
+	}
+
+	virtual void ReclaimSharedVertexBuffer() override
+	{
+		if (SharedVertexBuffer.IsValid())
+		{
+			if (SharedVertexBuffer.IsUnique())
+			{
+				// The RT is done with it so we can take it back without copying
+				VertexBuffer = MoveTemp(*SharedVertexBuffer);
+			}
+			else
+			{
+				VertexBuffer = *SharedVertexBuffer;
+			}
+			SharedVertexBuffer.Reset();
+		}
+	}
+
 	bool UpdateVertexBuffer(TArray<VertexType>& Vertices, const FBox* BoundingBox, bool bShouldMoveArray)
 	{
+		// The whole buffer is replaced, so any RT reference can keep the old one
+		SharedVertexBuffer.Reset();
 		return RuntimeMeshSectionInternal::UpdateVertexBufferInternal<VertexType>(VertexBuffer, LocalBoundingBox, Vertices, BoundingBox, bShouldMoveArray);
 	}
 
+	/* Overwrites part of the vertex buffer, tracking the changed range so only it is sent to the RT. Returns whether the bounding box changed */
+	bool UpdateVertexBufferRange(const TArray<VertexType>& Vertices, int32 FirstVertex)
+	{
+		ReclaimSharedVertexBuffer();
+		DirtyVertexSpans.Add(FirstVertex, Vertices.Num());
+		return RuntimeMeshSectionInternal::UpdateVertexBufferRangeInternal<VertexType>(VertexBuffer, LocalBoundingBox, Vertices, FirstVertex);
+	}
+
+	/* Adds to the end of the vertex buffer, tracking the new range so only it is sent to the RT. Returns whether the bounding box changed */
+	bool AppendVertexBuffer(const TArray<VertexType>& Vertices)
+	{
+		ReclaimSharedVertexBuffer();
+		const int32 FirstVertex = VertexBuffer.Num();
+
+		// TArray grows geometrically, so repeated appends don't reallocate every time
+		VertexBuffer.AddUninitialized(Vertices.Num());
+		DirtyVertexSpans.Add(FirstVertex, Vertices.Num());
+
+		// Only the new vertices need to be added to the bounding box
+		return RuntimeMeshSectionInternal::UpdateVertexBufferRangeInternal<VertexType>(VertexBuffer, LocalBoundingBox, Vertices, FirstVertex);
+	}
+
 	virtual FRuntimeMeshSectionCreateDataInterface* GetSectionCreationData(FSceneInterface* InScene, UMaterialInterface* InMaterial) const override
 	{
+		auto* MutableThis = const_cast<FRuntimeMeshSection*>(this);
 		auto UpdateData = new FRuntimeMeshSectionCreateData<VertexType>();
 
 		FMaterialRelevance MaterialRelevance = (InMaterial != nullptr) 
@@ -340,62 +545,160 @@ protected:
 		// Create new section proxy based on whether we need separate position buffer
 		if (IsDualBufferSection())
 		{
-			UpdateData->NewProxy = new FRuntimeMeshSectionProxy<VertexType, true>(InScene, UpdateFrequency, bIsVisible, bCastsShadow, InMaterial, MaterialRelevance);
+			UpdateData->NewProxy = new FRuntimeMeshSectionProxy<VertexType, true>(InScene, UpdateFrequency, bIsVisible, bCastsShadow, InMaterial, MaterialRelevance, SeparateStreams);
 			UpdateData->PositionVertexBuffer = PositionVertexBuffer;
 		}
 		else
 		{
-			UpdateData->NewProxy = new FRuntimeMeshSectionProxy<VertexType, false>(InScene, UpdateFrequency, bIsVisible, bCastsShadow, InMaterial, MaterialRelevance);
+			UpdateData->NewProxy = new FRuntimeMeshSectionProxy<VertexType, false>(InScene, UpdateFrequency, bIsVisible, bCastsShadow, InMaterial, MaterialRelevance, SeparateStreams);
 		}
-		const_cast<FRuntimeMeshSection*>(this)->bShouldUseAdjacencyIndexBuffer = UpdateData->NewProxy->ShouldUseAdjacencyIndexBuffer();
-
-		UpdateData->VertexBuffer = VertexBuffer;
+		MutableThis->bShouldUseAdjacencyIndexBuffer = UpdateData->NewProxy->ShouldUseAdjacencyIndexBuffer();
+		UpdateData->bUseSharedBufferPool = bUseSharedBufferPool;
+		UpdateData->LocalBoundingBox = LocalBoundingBox;
+		UpdateData->MaxDrawDistance = MaxDrawDistance;
+		UpdateData->LODIndex = LODIndex;
+		UpdateData->bIsInstanced = bIsInstanced;
+		GetInstanceMatrices(UpdateData->InstanceTransforms);
+
+		// Hand the vertices over by reference instead of copying them
+		UpdateData->SharedVertexBuffer = MutableThis->ShareVertexBuffer();
+		const int32 NumVertices = UpdateData->SharedVertexBuffer->Num();
 
 		// Switch between normal/tessellation indices
 
 		if (bShouldUseAdjacencyIndexBuffer && TessellationIndexBuffer.Num() > 0)
 		{
-			UpdateData->IndexBuffer = TessellationIndexBuffer;
+			UpdateData->IndexBuffer.Set(TessellationIndexBuffer, NumVertices);
 			UpdateData->bIsAdjacencyIndexBuffer = true;
 		}
 		else
 		{
-			UpdateData->IndexBuffer = IndexBuffer;
+			UpdateData->IndexBuffer.Set(IndexBuffer, NumVertices);
 			UpdateData->bIsAdjacencyIndexBuffer = false;
 		}
 
+		// Everything is being sent so any tracked ranges are now redundant
+		MutableThis->bRenderIndicesAre32Bit = UpdateData->IndexBuffer.b32BitIndices;
+		MutableThis->RenderVertexCapacity = NumVertices;
+		MutableThis->RenderIndexCapacity = UpdateData->IndexBuffer.Num();
+		MutableThis->StaticDrawNumVertices = NumVertices;
+		MutableThis->StaticDrawNumIndices = UpdateData->IndexBuffer.Num();
+		MutableThis->bStaticDrawUsesAdjacency = UpdateData->bIsAdjacencyIndexBuffer;
+		MutableThis->DirtyVertexSpans.Reset();
+		MutableThis->DirtyIndexSpans.Reset();
+
 		return UpdateData;
 	}
 
 	virtual FRuntimeMeshRenderThreadCommandInterface* GetSectionUpdateData(bool bIncludePositionVertices, bool bIncludeVertices, bool bIncludeIndices) const override
 	{
-		auto UpdateData = new FRuntimeMeshSectionUpdateData<VertexType>();
+		auto* MutableThis = const_cast<FRuntimeMeshSection*>(this);
+		const int32 NumVertices = GetVertexBuffer().Num();
+
+		// Ranges are patched into a copy of the buffers the RT keeps for average sections, which saves copying
+		// and sending the unchanged data, though the GPU upload is still the whole buffer. Volatile sections keep
+		// no buffers of their own to patch, and separate streams are always rewritten whole.
+		bool bCanSendRanges = UpdateFrequency == EUpdateFrequency::Average && SeparateStreams == ERuntimeMeshVertexStream::None;
+
+		// Ranges past the end of the RT buffers, like those from appends, need the buffers to already have room for them
+		bool bCanSendVertexRanges = bCanSendRanges && NumVertices <= RenderVertexCapacity;
+		bool bCanSendIndexRanges = bCanSendRanges && IndexBuffer.Num() <= RenderIndexCapacity;
+
+		// Buffers outgrown by appends are given room for more, so the following appends can be sent as ranges.
+		// Pooled sections are resized by the pool instead.
+		bool bCanReserve = bCanSendRanges && !IsUsingSharedBufferPool();
+
+		// Pooled sections can move when resized, which loses the contents of both buffers, so if
+		// either buffer is sent whole the other one has to be too.
+		if (IsUsingSharedBufferPool())
+		{
+			bool bSendsWholeVertices = bIncludeVertices && !(DirtyVertexSpans.IsPartial() && bCanSendVertexRanges);
+			bool bSendsWholeIndices = bIncludeIndices && !(DirtyIndexSpans.IsPartial() && bCanSendIndexRanges);
+			if (bSendsWholeVertices || bSendsWholeIndices)
+			{
+				bIncludeVertices = true;
+				bIncludeIndices = true;
+				MutableThis->DirtyVertexSpans.MarkAllDirty();
+				MutableThis->DirtyIndexSpans.MarkAllDirty();
+			}
+		}
+
+		auto UpdateData = TRuntimeMeshCommandPool<FRuntimeMeshSectionUpdateData<VertexType>>::Allocate();
 		UpdateData->bIncludeVertexBuffer = bIncludeVertices;
 		UpdateData->bIncludePositionBuffer = bIncludePositionVertices;
 		UpdateData->bIncludeIndices = bIncludeIndices;
+		UpdateData->LocalBoundingBox = LocalBoundingBox;
 
 		if (bIncludePositionVertices)
 		{
-			UpdateData->PositionVertexBuffer = PositionVertexBuffer;
+			// Append so a recycled command reuses its storage
+			UpdateData->PositionVertexBuffer.Append(PositionVertexBuffer);
 		}
 
 		if (bIncludeVertices)
 		{
-			UpdateData->VertexBuffer = VertexBuffer;
+			if (DirtyVertexSpans.IsPartial() && bCanSendVertexRanges)
+			{
+				// Only send the ranges that changed
+				for (const FRuntimeMeshBufferSpan& Span : DirtyVertexSpans.GetSpans())
+				{
+					UpdateData->VertexBuffer.Append(GetVertexBuffer().GetData() + Span.Start, Span.Count);
+				}
+				UpdateData->VertexSpans = DirtyVertexSpans.GetSpans();
+			}
+			else
+			{
+				// Hand the vertices over by reference instead of copying them
+				UpdateData->SharedVertexBuffer = MutableThis->ShareVertexBuffer();
+
+				if (DirtyVertexSpans.IsPartial() && bCanReserve)
+				{
+					UpdateData->VertexCapacity = NumVertices * FRuntimeMeshBufferSizing::AppendGrowthFactor;
+				}
+				MutableThis->RenderVertexCapacity = FMath::Max(NumVertices, UpdateData->VertexCapacity);
+			}
+			MutableThis->DirtyVertexSpans.Reset();
 		}
 
 		if (bIncludeIndices)
 		{
-			if (bShouldUseAdjacencyIndexBuffer && TessellationIndexBuffer.Num() > 0)
+			bool bUseAdjacencyIndices = bShouldUseAdjacencyIndexBuffer && TessellationIndexBuffer.Num() > 0;
+
+			// Ranges can only be written if the RT buffer is still in a format that can address every vertex
+			bool bSendIndexRanges = DirtyIndexSpans.IsPartial() && !bUseAdjacencyIndices && bCanSendIndexRanges &&
+				(bRenderIndicesAre32Bit || FRuntimeMeshIndexData::CanUse16BitIndices(NumVertices));
+
+			if (bSendIndexRanges)
+			{
+				// Only send the ranges that changed, in the format the RT buffer already has
+				UpdateData->IndexBuffer.Reset(bRenderIndicesAre32Bit);
+				for (const FRuntimeMeshBufferSpan& Span : DirtyIndexSpans.GetSpans())
+				{
+					UpdateData->IndexBuffer.Append(IndexBuffer.GetData() + Span.Start, Span.Count);
+				}
+				UpdateData->IndexSpans = DirtyIndexSpans.GetSpans();
+				UpdateData->bIsAdjacencyIndexBuffer = false;
+			}
+			else if (bUseAdjacencyIndices)
 			{
-				UpdateData->IndexBuffer = TessellationIndexBuffer;
+				UpdateData->IndexBuffer.Set(TessellationIndexBuffer, NumVertices);
 				UpdateData->bIsAdjacencyIndexBuffer = true;
+				MutableThis->RenderIndexCapacity = UpdateData->IndexBuffer.Num();
 			}
 			else
 			{
-				UpdateData->IndexBuffer = IndexBuffer;
+				UpdateData->IndexBuffer.Set(IndexBuffer, NumVertices);
 				UpdateData->bIsAdjacencyIndexBuffer = false;
+
+				if (DirtyIndexSpans.IsPartial() && bCanReserve)
+				{
+					UpdateData->IndexCapacity = IndexBuffer.Num() * FRuntimeMeshBufferSizing::AppendGrowthFactor;
+				}
+				MutableThis->RenderIndexCapacity = FMath::Max(IndexBuffer.Num(), UpdateData->IndexCapacity);
 			}
+
+			MutableThis->bRenderIndicesAre32Bit = UpdateData->IndexBuffer.b32BitIndices;
+			MutableThis->DirtyIndexSpans.Reset();
 		}
 
 		return UpdateData;
@@ -403,20 +706,73 @@ protected:
 
 	virtual FRuntimeMeshRenderThreadCommandInterface* GetSectionPositionUpdateData() const override
 	{
-		auto UpdateData = new FRuntimeMeshSectionPositionOnlyUpdateData<VertexType>();
+		auto UpdateData = TRuntimeMeshCommandPool<FRuntimeMeshSectionPositionOnlyUpdateData<VertexType>>::Allocate();
+
+		// Append so a recycled command reuses its storage
+		UpdateData->PositionVertexBuffer.Append(PositionVertexBuffer);
+		UpdateData->LocalBoundingBox = LocalBoundingBox;
+
+		return UpdateData;
+	}
+
+	virtual FRuntimeMeshRenderThreadCommandInterface* GetSectionStreamUpdateData(ERuntimeMeshVertexStream Streams) const override
+	{
+		auto* MutableThis = const_cast<FRuntimeMeshSection*>(this);
+		auto UpdateData = TRuntimeMeshCommandPool<FRuntimeMeshSectionUpdateData<VertexType>>::Allocate();
+		UpdateData->bIncludePositionBuffer = false;
+		UpdateData->bIncludeVertexBuffer = false;
+		UpdateData->bIncludeIndices = false;
+		UpdateData->UpdatedStreams = Streams & SeparateStreams;
+		UpdateData->LocalBoundingBox = LocalBoundingBox;
 
-		UpdateData->PositionVertexBuffer = PositionVertexBuffer;
+		// The RT gathers the streams from the vertices, so hand them over by reference instead of copying them
+		UpdateData->SharedVertexBuffer = MutableThis->ShareVertexBuffer();
 
 		return UpdateData;
 	}
 
+	virtual bool CanUpdateStaticDrawInPlace() const override
+	{
+		const bool bUseAdjacencyIndices = bShouldUseAdjacencyIndexBuffer && TessellationIndexBuffer.Num() > 0;
+		const int32 NumIndices = bUseAdjacencyIndices ? TessellationIndexBuffer.Num() : IndexBuffer.Num();
+
+		// Sections created empty were never submitted to the static draw lists
+		return StaticDrawNumVertices > 0 && StaticDrawNumIndices > 0 && GetVertexBuffer().Num() == StaticDrawNumVertices && 
+			NumIndices == StaticDrawNumIndices && bUseAdjacencyIndices == bStaticDrawUsesAdjacency;
+	}
+
+	virtual int32 GetUploadSize(bool bIncludePositionVertices, bool bIncludeVertices, bool bIncludeIndices) const override
+	{
+		const int32 NumVertices = GetVertexBuffer().Num();
+		int32 UploadSize = 0;
+
+		if (bIncludePositionVertices)
+		{
+			UploadSize += PositionVertexBuffer.Num() * sizeof(FVector);
+		}
+
+		if (bIncludeVertices)
+		{
+			UploadSize += (DirtyVertexSpans.IsPartial() ? DirtyVertexSpans.GetNumDirty() : NumVertices) * sizeof(VertexType);
+		}
+
+		if (bIncludeIndices)
+		{
+			const int32 IndexSize = FRuntimeMeshIndexData::CanUse16BitIndices(NumVertices) ? sizeof(uint16) : sizeof(uint32);
+			UploadSize += (DirtyIndexSpans.IsPartial() ? DirtyIndexSpans.GetNumDirty() : IndexBuffer.Num()) * IndexSize;
+		}
+
+		return UploadSize;
+	}
+
 	virtual int32 GetAllVertexPositions(TArray<FVector>& Positions) override
 	{
-		return RuntimeMeshSectionInternal::GetAllVertexPositions<VertexType>(VertexBuffer, PositionVertexBuffer, Positions);
+		return RuntimeMeshSectionInternal::GetAllVertexPositions<VertexType>(GetVertexBuffer(), PositionVertexBuffer, Positions);
 	}
 
 	virtual void GetSectionMesh(const IRuntimeMeshVerticesBuilder*& Vertices, const FRuntimeMeshIndicesBuilder*& Indices) override
 	{
+		ReclaimSharedVertexBuffer();
 		Vertices = new FRuntimeMeshPackedVerticesBuilder<VertexType>(&VertexBuffer);
 		Indices = new FRuntimeMeshIndicesBuilder(&IndexBuffer);
 	}
@@ -425,6 +781,7 @@ protected:
 
 	virtual void GenerateNormalTangent()
 	{
+		ReclaimSharedVertexBuffer();
 		if (IsDualBufferSection())
 		{
 			URuntimeMeshLibrary::CalculateTangentsForMesh<VertexType>(PositionVertexBuffer, VertexBuffer, IndexBuffer);
@@ -437,6 +794,7 @@ protected:
 
 	virtual void GenerateTessellationIndices()
 	{
+		ReclaimSharedVertexBuffer();
 		TArray<int32> TessellationIndices;
 		if (IsDualBufferSection())
 		{
@@ -455,14 +813,11 @@ protected:
 
 		if (IsDualBufferSection())
 		{
-			for (int32 Index = 0; Index < PositionVertexBuffer.Num(); Index++)
-			{
-				LocalBoundingBox += PositionVertexBuffer[Index];
-			}
+			LocalBoundingBox = FRuntimeMeshBounds::Calculate(PositionVertexBuffer.GetData(), PositionVertexBuffer.Num());
 		}
 		else
 		{
-			RuntimeMeshSectionInternal::RecalculateBoundingBox<VertexType>(VertexBuffer, LocalBoundingBox);
+			RuntimeMeshSectionInternal::RecalculateBoundingBox<VertexType>(GetVertexBuffer(), LocalBoundingBox);
 		}
 	}
 
@@ -8,37 +8,178 @@
 #include "RuntimeMeshVersion.h"
 #include "RuntimeMeshCore.h"
 #include "RuntimeMeshRendering.h"
+#include "RuntimeMeshBufferPool.h"
 #include "RuntimeMeshUpdateCommands.h"
 
 
+/* Everything static sections must have in common to be drawn together in one multi element mesh batch */
+struct FRuntimeMeshSectionMergeKey
+{
+	/* Pooled vertex buffer the sections are drawn from */
+	const FVertexBuffer* VertexBuffer;
+	/* Vertex type, as the vertex factory layout has to match */
+	const FRuntimeMeshVertexTypeInfo* VertexType;
+	const UMaterialInterface* Material;
+	bool bIsUsingAdjacency;
+	bool bCastsShadow;
+
+	bool operator==(const FRuntimeMeshSectionMergeKey& Other) const
+	{
+		return VertexBuffer == Other.VertexBuffer && VertexType == Other.VertexType && Material == Other.Material &&
+			bIsUsingAdjacency == Other.bIsUsingAdjacency && bCastsShadow == Other.bCastsShadow;
+	}
+};
+
+/* 
+ *	Implemented by the scene proxy to work out which elements of a static batch are visible. 
+ *	Merged batches hold elements from several sections, which only the scene proxy knows about.
+ */
+class FRuntimeMeshStaticBatchVisibilityInterface
+{
+public:
+	/* Shadow passes still pass the camera's view, so the elements can't be culled by its frustum */
+	virtual uint64 GetMergedBatchElementVisibility(const FSceneView& View, const FMeshBatch* Batch, bool bIsShadowPass) const = 0;
+};
+
 /** Interface class for the RT proxy of a single mesh section */
 class FRuntimeMeshSectionProxyInterface : public FRuntimeMeshVisibilityInterface
 {
 public:
 
-	FRuntimeMeshSectionProxyInterface() {}
+	FRuntimeMeshSectionProxyInterface() : LocalBoundingBox(0), MaxDrawDistance(0.0f), LODIndex(INDEX_NONE), bIsInstanced(false), InstancedBoundingBox(0), StaticBatchVisibility(nullptr) {}
 	virtual ~FRuntimeMeshSectionProxyInterface() {}
 
 	virtual bool ShouldRender() = 0;
 	virtual bool WantsToRenderInStaticPath() const = 0;
 
+	/* Does this section have anything to draw, whether or not it's currently visible */
+	virtual bool HasRenderData() const = 0;
+
 	virtual bool ShouldUseAdjacencyIndexBuffer() const = 0;
 
 	virtual FMaterialRelevance GetMaterialRelevance() const = 0;
 
 	virtual void CreateMeshBatch(FMeshBatch& MeshBatch, FMaterialRenderProxy* WireframeMaterial, bool bIsSelected) = 0;
 
+	/* Gets the mesh batch for this section without wireframe, only building it again if the section has changed since */
+	virtual const FMeshBatch& GetCachedMeshBatch(bool bIsSelected) = 0;
+
+	/* Gets what this section has to share with others to be drawn in the same mesh batch. Returns false if it can't be merged */
+	virtual bool GetMergeKey(FRuntimeMeshSectionMergeKey& OutKey) const = 0;
+
 
 	virtual void FinishCreate_RenderThread(FRuntimeMeshSectionCreateDataInterface* UpdateData) = 0;
 	virtual void FinishUpdate_RenderThread(FRuntimeMeshRenderThreadCommandInterface* UpdateData) = 0;
 	virtual void FinishPositionUpdate_RenderThread(FRuntimeMeshRenderThreadCommandInterface* UpdateData) = 0;
 	virtual void FinishPropertyUpdate_RenderThread(FRuntimeMeshRenderThreadCommandInterface* UpdateData) = 0;
+	virtual void FinishInstanceUpdate_RenderThread(FRuntimeMeshRenderThreadCommandInterface* UpdateData) = 0;
+
+	/* Sets who works out the visibility of the static batches drawn with this sections vertex factory */
+	void SetStaticBatchVisibility(const FRuntimeMeshStaticBatchVisibilityInterface* InStaticBatchVisibility) { StaticBatchVisibility = InStaticBatchVisibility; }
+
+	/* The renderer asks the vertex factory of a batch for its element visibility, which passes it on to us */
+	virtual uint64 GetStaticBatchElementVisibility(const FSceneView& View, const FMeshBatch* Batch) override
+	{
+		return StaticBatchVisibility ? StaticBatchVisibility->GetMergedBatchElementVisibility(View, Batch, false) : ShouldRender();
+	}
+
+	virtual uint64 GetStaticBatchElementShadowVisibility(const FSceneView& View, const FMeshBatch* Batch) override
+	{
+		return StaticBatchVisibility ? StaticBatchVisibility->GetMergedBatchElementVisibility(View, Batch, true) : ShouldRender();
+	}
+
+	/* Gets the local bounds of this section. Invalid if the section has no positions to bound */
+	const FBox& GetLocalBoundingBox() const { return LocalBoundingBox; }
+
+	/* Gets the bounds to cull this section by, relative to the component. For instanced sections this covers every instance */
+	const FBox& GetCullingBoundingBox() const { return bIsInstanced ? InstancedBoundingBox : LocalBoundingBox; }
+
+	/* Gets the distance past which this section isn't drawn. 0 for no limit */
+	float GetMaxDrawDistance() const { return MaxDrawDistance; }
+
+	/* Gets the LOD this section is drawn at. INDEX_NONE for every LOD */
+	int32 GetLODIndex() const { return LODIndex; }
+
+	/* Is this section drawn at the supplied LOD */
+	bool IsInLOD(int32 InLODIndex) const { return LODIndex == INDEX_NONE || LODIndex == InLODIndex; }
+
+	/* Is this section drawn once per instance instead of once at the component */
+	bool IsInstanced() const { return bIsInstanced; }
+
+	/* Gets the world bounds of each instance, as of the last UpdateInstanceWorldBounds() */
+	const TArray<FBox>& GetInstanceWorldBounds() const { return InstanceWorldBounds; }
+
+	/* Brings the world bounds of each instance up to date, after the instances, the section bounds or the component transform changed */
+	void UpdateInstanceWorldBounds(const FMatrix& LocalToWorld)
+	{
+		InstanceWorldBounds.Reset();
+		if (bIsInstanced && LocalBoundingBox.IsValid)
+		{
+			InstanceWorldBounds.SetNumUninitialized(InstanceTransforms.Num());
+			for (int32 InstanceIndex = 0; InstanceIndex < InstanceTransforms.Num(); InstanceIndex++)
+			{
+				InstanceWorldBounds[InstanceIndex] = LocalBoundingBox.TransformBy(InstanceTransforms[InstanceIndex] * LocalToWorld);
+			}
+		}
+	}
+
+protected:
+	/* Sets the local bounds, keeping the bounds of the instances in step */
+	void SetLocalBoundingBox(const FBox& InLocalBoundingBox)
+	{
+		LocalBoundingBox = InLocalBoundingBox;
+		UpdateInstancedBoundingBox();
+	}
+
+	/* Replaces the instances of this section */
+	void SetInstances(bool bInIsInstanced, TArray<FMatrix>& InInstanceTransforms)
+	{
+		bIsInstanced = bInIsInstanced;
+		InstanceTransforms = MoveTemp(InInstanceTransforms);
+		UpdateInstancedBoundingBox();
+	}
+
+	/* Works out the bounds of every instance together */
+	void UpdateInstancedBoundingBox()
+	{
+		InstancedBoundingBox = FBox(0);
+		if (bIsInstanced && LocalBoundingBox.IsValid)
+		{
+			for (const FMatrix& InstanceTransform : InstanceTransforms)
+			{
+				InstancedBoundingBox += LocalBoundingBox.TransformBy(InstanceTransform);
+			}
+		}
+	}
+
+	/** Local bounds of this section, for culling it separately from the rest of the component */
+	FBox LocalBoundingBox;
+
+	/** Distance past which this section isn't drawn. 0 for no limit */
+	float MaxDrawDistance;
+
+	/** LOD this section is drawn at. INDEX_NONE for every LOD */
+	int32 LODIndex;
+
+	/** Is this section drawn once per instance instead of once at the component */
+	bool bIsInstanced;
+
+	/** Transforms of the instances, relative to the component */
+	TArray<FMatrix> InstanceTransforms;
+
+	/** Bounds of every instance together, relative to the component */
+	FBox InstancedBoundingBox;
 
+	/** World bounds of each instance, for culling them individually */
+	TArray<FBox> InstanceWorldBounds;
+
+	/** Works out the visibility of static batches drawn with this sections vertex factory */
+	const FRuntimeMeshStaticBatchVisibilityInterface* StaticBatchVisibility;
 };
 
 /** Templated class for the RT proxy of a single mesh section */
 template <typename VertexType, bool NeedsPositionOnlyBuffer>
-class FRuntimeMeshSectionProxy : public FRuntimeMeshSectionProxyInterface
+class FRuntimeMeshSectionProxy : public FRuntimeMeshSectionProxyInterface, public FRuntimeMeshVolatileSectionInterface
 {
 protected:
 	/** Whether this section is currently visible */
@@ -72,31 +213,127 @@ protected:
 	/** Vertex factory for this section */
 	FRuntimeMeshVertexFactory VertexFactory;
 
+	/** Structure the vertex factory was last set up with, kept to set up the instanced vertex factory the same way */
+	RuntimeMeshVertexStructure CurrentVertexStructure;
+
+	/** Per instance transforms, when this section is instanced */
+	FRuntimeMeshInstanceBuffer InstanceBuffer;
+
+	/** Vertex factory drawing every instance in one draw call, when this section is instanced */
+	FRuntimeMeshInstancedVertexFactory InstancedVertexFactory;
+
+	/** Vertices of a volatile section, written to the volatile ring buffer each frame. Shared with the GT section when it still holds them */
+	TSharedPtr<const TArray<VertexType>, ESPMode::ThreadSafe> VolatileVertices;
+
+	/** Indices of a volatile section, written to the volatile ring buffer each frame */
+	FRuntimeMeshIndexData VolatileIndices;
+
+	/** Where this frame's data starts in the volatile ring buffer */
+	uint32 VolatileBaseVertexIndex;
+	uint32 VolatileFirstIndex;
+
+	/** The frame the volatile ring buffer data was last placed for */
+	uint32 VolatileFrameNumber;
+
+	/** Changed whenever the volatile data changes, so the ring buffer only writes it again when it has to */
+	uint32 VolatileDataVersion;
+
+	/** Space in the shared buffer pool, if this section uses it instead of its own buffers */
+	FRuntimeMeshPoolAllocation* PoolAllocation;
+
+	/** Vertex attributes kept in their own buffers instead of the interleaved vertex buffer */
+	const ERuntimeMeshVertexStream SeparateStreams;
+
+	/** Buffers for the separate vertex attributes, one per ERuntimeMeshVertexStream flag. Null when not separated */
+	FRuntimeMeshVertexStreamBuffer* StreamBuffers[RuntimeMeshNumVertexStreams];
+
+	/** Mesh batch built for this section, reused across frames and views until the section changes */
+	FMeshBatch CachedMeshBatch;
+
+	/** Is the cached mesh batch up to date */
+	bool bIsMeshBatchCached;
+
+	/** Was the cached mesh batch built for the selected material */
+	bool bCachedMeshBatchSelected;
+
+	/** Generation of the pool allocation the cached mesh batch was built from */
+	uint32 CachedMeshBatchPoolGeneration;
+
 public:
-	FRuntimeMeshSectionProxy(FSceneInterface* InScene, EUpdateFrequency InUpdateFrequency, bool bInIsVisible, bool bInCastsShadow, UMaterialInterface* InMaterial, FMaterialRelevance InMaterialRelevance) :
+	FRuntimeMeshSectionProxy(FSceneInterface* InScene, EUpdateFrequency InUpdateFrequency, bool bInIsVisible, bool bInCastsShadow, UMaterialInterface* InMaterial, FMaterialRelevance InMaterialRelevance, 
+		ERuntimeMeshVertexStream InSeparateStreams = ERuntimeMeshVertexStream::None) :
 		bIsVisible(bInIsVisible), bCastsShadow(bInCastsShadow), UpdateFrequency(InUpdateFrequency), Material(InMaterial), MaterialRelevance(InMaterialRelevance),
-		PositionVertexBuffer(nullptr), VertexBuffer(InUpdateFrequency), IndexBuffer(InUpdateFrequency), VertexFactory(this) 
+		PositionVertexBuffer(nullptr), VertexBuffer(InUpdateFrequency), IndexBuffer(InUpdateFrequency), VertexFactory(this),
+		VolatileBaseVertexIndex(0), VolatileFirstIndex(0), VolatileFrameNumber(MAX_uint32), VolatileDataVersion(0), PoolAllocation(nullptr), SeparateStreams(InSeparateStreams),
+		bIsMeshBatchCached(false), bCachedMeshBatchSelected(false), CachedMeshBatchPoolGeneration(0)
 	{ 
+		FMemory::Memzero(StreamBuffers);
 		bShouldUseAdjacency = RequiresAdjacencyInformation(InMaterial, VertexFactory.GetType(), InScene->GetFeatureLevel());
 	}
 
 	virtual ~FRuntimeMeshSectionProxy() override
 	{
+		if (IsVolatile())
+		{
+			FRuntimeMeshVolatileRingBuffer::Get().Unregister(this);
+		}
+
 		VertexBuffer.ReleaseResource();
 		IndexBuffer.ReleaseResource();
 		VertexFactory.ReleaseResource();
+		InstancedVertexFactory.ReleaseResource();
+		InstanceBuffer.ReleaseResource();
+
+		if (PoolAllocation)
+		{
+			FRuntimeMeshBufferPool::Get().Free(PoolAllocation);
+		}
 
 		if (PositionVertexBuffer)
 		{
 			PositionVertexBuffer->ReleaseResource();
 			delete PositionVertexBuffer;
 		}
+
+		for (FRuntimeMeshVertexStreamBuffer* StreamBuffer : StreamBuffers)
+		{
+			if (StreamBuffer)
+			{
+				StreamBuffer->ReleaseResource();
+				delete StreamBuffer;
+			}
+		}
+	}
+
+
+	virtual bool ShouldRender() override 
+	{ 
+		return bIsVisible && HasRenderData() && (!bIsInstanced || InstanceTransforms.Num() > 0);
 	}
 
+	virtual bool HasRenderData() const override
+	{
+		if (IsVolatile())
+		{
+			// Only render if the ring buffer holds our data for this frame
+			return GetVolatileNumVertices() > 0 && VolatileIndices.Num() > 0 && VolatileFrameNumber == GFrameNumberRenderThread;
+		}
+		if (PoolAllocation)
+		{
+			return PoolAllocation->Vertices.Count > 0 && PoolAllocation->Indices.Count > 0;
+		}
+		return VertexBuffer.Num() > 0 && IndexBuffer.Num() > 0; 
+	}
 
-	virtual bool ShouldRender() override { return bIsVisible && VertexBuffer.Num() > 0 && IndexBuffer.Num() > 0; }
+	/* 
+	 *	Does this section live in the volatile ring buffer. Dual buffer sections keep their own 
+	 *	buffers as their position buffer couldn't be offset along with the shared vertex buffer. 
+	 *	The same goes for sections with separate vertex streams.
+	 */
+	bool IsVolatile() const { return UpdateFrequency == EUpdateFrequency::Volatile && !NeedsPositionOnlyBuffer && SeparateStreams == ERuntimeMeshVertexStream::None; }
 
-	virtual bool WantsToRenderInStaticPath() const override { return UpdateFrequency == EUpdateFrequency::Infrequent; }
+	/* Instanced sections are always drawn dynamically, so changing the instances doesn't need the static draw lists rebuilt */
+	virtual bool WantsToRenderInStaticPath() const override { return UpdateFrequency == EUpdateFrequency::Infrequent && !bIsInstanced; }
 	
 	virtual bool ShouldUseAdjacencyIndexBuffer() const override { return bShouldUseAdjacency; }
 
@@ -104,7 +341,7 @@ public:
 	
 	virtual void CreateMeshBatch(FMeshBatch& MeshBatch, FMaterialRenderProxy* WireframeMaterial, bool bIsSelected) override
 	{
-		MeshBatch.VertexFactory = &VertexFactory;
+		MeshBatch.VertexFactory = bIsInstanced ? static_cast<const FVertexFactory*>(&InstancedVertexFactory) : &VertexFactory;
 		MeshBatch.bWireframe = WireframeMaterial != nullptr;
 		MeshBatch.MaterialRenderProxy = MeshBatch.bWireframe ? WireframeMaterial : Material->GetRenderProxy(bIsSelected);
 		
@@ -120,7 +357,32 @@ public:
 		MeshBatch.DepthPriorityGroup = SDPG_World;
 		MeshBatch.CastShadow = bCastsShadow;
 
+		// Instanced sections draw the same range of the buffers once per instance, in a single draw call
 		FMeshBatchElement& BatchElement = MeshBatch.Elements[0];
+		BatchElement.NumInstances = bIsInstanced ? InstanceTransforms.Num() : 1;
+
+		if (IsVolatile())
+		{
+			// Indices in the ring buffer are already offset to this sections vertices
+			BatchElement.IndexBuffer = &FRuntimeMeshVolatileRingBuffer::Get().GetIndexBuffer();
+			BatchElement.FirstIndex = VolatileFirstIndex;
+			BatchElement.NumPrimitives = bIsUsingAdjacency ? VolatileIndices.Num() / 12 : VolatileIndices.Num() / 3;
+			BatchElement.MinVertexIndex = VolatileBaseVertexIndex;
+			BatchElement.MaxVertexIndex = VolatileBaseVertexIndex + GetVolatileNumVertices() - 1;
+			return;
+		}
+
+		if (PoolAllocation)
+		{
+			// Indices in the pool are already offset to this sections vertices
+			BatchElement.IndexBuffer = &PoolAllocation->Page->GetIndexBuffer();
+			BatchElement.FirstIndex = PoolAllocation->Indices.Start;
+			BatchElement.NumPrimitives = bIsUsingAdjacency ? PoolAllocation->Indices.Count / 12 : PoolAllocation->Indices.Count / 3;
+			BatchElement.MinVertexIndex = PoolAllocation->Vertices.Start;
+			BatchElement.MaxVertexIndex = PoolAllocation->Vertices.End() - 1;
+			return;
+		}
+
 		BatchElement.IndexBuffer = &IndexBuffer;
 		BatchElement.FirstIndex = 0;
 		BatchElement.NumPrimitives = bIsUsingAdjacency? IndexBuffer.Num() / 12 : IndexBuffer.Num() / 3;
@@ -129,36 +391,93 @@ public:
 	}
 
 
+	virtual const FMeshBatch& GetCachedMeshBatch(bool bIsSelected) override
+	{
+		// Pooled sections can be moved by defragmentation without being told
+		const uint32 PoolGeneration = PoolAllocation ? PoolAllocation->Generation : 0;
+
+		if (!bIsMeshBatchCached || bCachedMeshBatchSelected != bIsSelected || CachedMeshBatchPoolGeneration != PoolGeneration)
+		{
+			INC_DWORD_STAT(STAT_RuntimeMesh_MeshBatchesBuilt);
+
+			CachedMeshBatch = FMeshBatch();
+			CreateMeshBatch(CachedMeshBatch, nullptr, bIsSelected);
+
+			bIsMeshBatchCached = true;
+			bCachedMeshBatchSelected = bIsSelected;
+			CachedMeshBatchPoolGeneration = PoolGeneration;
+		}
+		return CachedMeshBatch;
+	}
+
+	/* Drops the cached mesh batch, so it's built again the next time it's needed */
+	void InvalidateCachedMeshBatch() { bIsMeshBatchCached = false; }
+
+	virtual bool GetMergeKey(FRuntimeMeshSectionMergeKey& OutKey) const override
+	{
+		// Only sections in the same pool page share a vertex buffer, and so can share a vertex factory
+		if (PoolAllocation == nullptr)
+		{
+			return false;
+		}
+
+		OutKey.VertexBuffer = &PoolAllocation->Page->GetVertexBuffer();
+		OutKey.VertexType = &VertexType::TypeInfo;
+		OutKey.Material = Material;
+		OutKey.bIsUsingAdjacency = bIsUsingAdjacency;
+		OutKey.bCastsShadow = bCastsShadow;
+		return true;
+	}
+
 	virtual void FinishCreate_RenderThread(FRuntimeMeshSectionCreateDataInterface* UpdateData) override
 	{
  		check(IsInRenderingThread());
 
 		auto* SectionUpdateData = UpdateData->As<FRuntimeMeshSectionCreateData<VertexType>>();
 		check(SectionUpdateData);
+
+		InvalidateCachedMeshBatch();
+
+		MaxDrawDistance = SectionUpdateData->MaxDrawDistance;
+		LODIndex = SectionUpdateData->LODIndex;
+		SetInstances(SectionUpdateData->bIsInstanced, SectionUpdateData->InstanceTransforms);
+		SetLocalBoundingBox(SectionUpdateData->LocalBoundingBox);
 		
+		// Pooled sections get their space up front, as the vertex factory has to be bound to the page
+		if (SectionUpdateData->bUseSharedBufferPool && !IsVolatile() && !NeedsPositionOnlyBuffer && SeparateStreams == ERuntimeMeshVertexStream::None)
+		{
+			PoolAllocation = FRuntimeMeshBufferPool::Get().Allocate(sizeof(VertexType), SectionUpdateData->GetVertexBuffer().Num(), SectionUpdateData->IndexBuffer.Num(), WantsToRenderInStaticPath());
+		}
+
+		// Volatile and pooled sections read from shared buffers instead of their own
+		const FVertexBuffer& StreamVertexBuffer = 
+			IsVolatile() ? FRuntimeMeshVolatileRingBuffer::Get().GetVertexBuffer() :
+			PoolAllocation ? PoolAllocation->Page->GetVertexBuffer() :
+			static_cast<const FVertexBuffer&>(VertexBuffer);
+
 		if (NeedsPositionOnlyBuffer)
 		{
 			// Initialize the position buffer
 			PositionVertexBuffer = new FRuntimeMeshVertexBuffer<FVector>(UpdateFrequency);
 
 			// Get and adjust the vertex structure
-			auto VertexStructure = VertexType::GetVertexStructure(VertexBuffer);
-			VertexStructure.PositionComponent = FVertexStreamComponent(PositionVertexBuffer, 0, sizeof(FVector), VET_Float3);
-			VertexFactory.Init(VertexStructure);
+			CurrentVertexStructure = VertexType::GetVertexStructure(StreamVertexBuffer);
+			CurrentVertexStructure.PositionComponent = FVertexStreamComponent(PositionVertexBuffer, 0, sizeof(FVector), VET_Float3);
+			InitVertexStreams(CurrentVertexStructure);
+			VertexFactory.Init(CurrentVertexStructure);
 		}
 		else
 		{
 			// Get and submit the vertex structure
-			auto VertexStructure = VertexType::GetVertexStructure(VertexBuffer);
-			VertexFactory.Init(VertexStructure);
+			CurrentVertexStructure = VertexType::GetVertexStructure(StreamVertexBuffer);
+			InitVertexStreams(CurrentVertexStructure);
+			VertexFactory.Init(CurrentVertexStructure);
 		}
 		
 		// Initialize the vertex factory
 		VertexFactory.InitResource();
 
-		auto& Vertices = SectionUpdateData->VertexBuffer;
-		VertexBuffer.SetNum(Vertices.Num());
-		VertexBuffer.SetData(Vertices);
+		UpdateInstanceBuffer();
 
 		if (NeedsPositionOnlyBuffer)
 		{
@@ -166,9 +485,37 @@ public:
 			PositionVertexBuffer->SetNum(PositionVertices.Num());
 			PositionVertexBuffer->SetData(PositionVertices);
 		}
+
+		if (IsVolatile())
+		{
+			// Keep the data to write to the ring buffer every frame
+			VolatileVertices = SectionUpdateData->TakeVertexBuffer();
+			VolatileIndices = MoveTemp(SectionUpdateData->IndexBuffer);
+			bIsUsingAdjacency = SectionUpdateData->bIsAdjacencyIndexBuffer;
+			VolatileDataVersion++;
+
+			FRuntimeMeshVolatileRingBuffer::Get().Register(this);
+			return;
+		}
+
+		if (PoolAllocation)
+		{
+			auto& Vertices = SectionUpdateData->GetVertexBuffer();
+			auto& Indices = SectionUpdateData->IndexBuffer;
+			FRuntimeMeshBufferPool::Get().WriteVertices(PoolAllocation, Vertices.GetData(), 0, Vertices.Num());
+			FRuntimeMeshBufferPool::Get().WriteIndices(PoolAllocation, Indices, 0, 0, Indices.Num());
+			FRuntimeMeshBufferPool::Get().Flush();
+			bIsUsingAdjacency = SectionUpdateData->bIsAdjacencyIndexBuffer;
+			return;
+		}
+
+		auto& Vertices = SectionUpdateData->GetVertexBuffer();
+		VertexBuffer.SetNum(Vertices.Num());
+		VertexBuffer.SetData(Vertices);
+		SetVertexStreamData(Vertices, SeparateStreams);
 		
 		auto& Indices = SectionUpdateData->IndexBuffer;
-		IndexBuffer.SetNum(Indices.Num());
+		IndexBuffer.SetNum(Indices.Num(), Indices.b32BitIndices);
 		IndexBuffer.SetData(Indices);
 		bIsUsingAdjacency = SectionUpdateData->bIsAdjacencyIndexBuffer;
 	}
@@ -180,11 +527,57 @@ public:
 		auto* SectionUpdateData = UpdateData->As<FRuntimeMeshSectionUpdateData<VertexType>>();
 		check(SectionUpdateData);
 
+		InvalidateCachedMeshBatch();
+
+		SetLocalBoundingBox(SectionUpdateData->LocalBoundingBox);
+
+		if (IsVolatile())
+		{
+			// Volatile sections are always sent whole, and picked up by the ring buffer next frame
+			check(SectionUpdateData->VertexSpans.Num() == 0 && SectionUpdateData->IndexSpans.Num() == 0);
+
+			if (SectionUpdateData->bIncludeVertexBuffer)
+			{
+				VolatileVertices = SectionUpdateData->TakeVertexBuffer();
+			}
+
+			if (SectionUpdateData->bIncludeIndices)
+			{
+				VolatileIndices = MoveTemp(SectionUpdateData->IndexBuffer);
+				bIsUsingAdjacency = SectionUpdateData->bIsAdjacencyIndexBuffer;
+			}
+
+			VolatileDataVersion++;
+			return;
+		}
+
+		if (PoolAllocation)
+		{
+			FinishPooledUpdate(SectionUpdateData);
+			return;
+		}
+
 		if (SectionUpdateData->bIncludeVertexBuffer)
 		{
-			auto& VertexBufferData = SectionUpdateData->VertexBuffer;
-			VertexBuffer.SetNum(VertexBufferData.Num());
-			VertexBuffer.SetData(VertexBufferData);
+			auto& VertexBufferData = SectionUpdateData->GetVertexBuffer();
+			if (SectionUpdateData->VertexSpans.Num() > 0)
+			{
+				// Only the changed ranges were sent. Appended ranges extend the buffer into the room reserved for them
+				VertexBuffer.Grow(SectionUpdateData->VertexSpans.Last().End());
+				VertexBuffer.SetDataRanges(VertexBufferData, SectionUpdateData->VertexSpans);
+			}
+			else
+			{
+				VertexBuffer.SetNum(VertexBufferData.Num());
+				VertexBuffer.Reserve(SectionUpdateData->VertexCapacity);
+				VertexBuffer.SetData(VertexBufferData);
+				SetVertexStreamData(VertexBufferData, SeparateStreams);
+			}
+		}
+		else if (SectionUpdateData->UpdatedStreams != ERuntimeMeshVertexStream::None)
+		{
+			// Only some attributes changed, so leave the interleaved buffer alone as the factory doesn't read them from it
+			SetVertexStreamData(SectionUpdateData->GetVertexBuffer(), SectionUpdateData->UpdatedStreams);
 		}
 
 		if (NeedsPositionOnlyBuffer && SectionUpdateData->bIncludePositionBuffer)
@@ -197,12 +590,153 @@ public:
 		if (SectionUpdateData->bIncludeIndices)
 		{
 			auto& IndexBufferData = SectionUpdateData->IndexBuffer;
-			IndexBuffer.SetNum(IndexBufferData.Num());
-			IndexBuffer.SetData(IndexBufferData);
-			bIsUsingAdjacency = SectionUpdateData->bIsAdjacencyIndexBuffer;
+			if (SectionUpdateData->IndexSpans.Num() > 0)
+			{
+				// Only the changed ranges were sent. Appended ranges extend the buffer into the room reserved for them
+				IndexBuffer.Grow(SectionUpdateData->IndexSpans.Last().End());
+				IndexBuffer.SetDataRanges(IndexBufferData, SectionUpdateData->IndexSpans);
+			}
+			else
+			{
+				IndexBuffer.SetNum(IndexBufferData.Num(), IndexBufferData.b32BitIndices);
+				IndexBuffer.Reserve(SectionUpdateData->IndexCapacity);
+				IndexBuffer.SetData(IndexBufferData);
+				bIsUsingAdjacency = SectionUpdateData->bIsAdjacencyIndexBuffer;
+			}
+		}
+	}
+
+	/* Moves the separated attributes of the vertex structure into their own buffers */
+	void InitVertexStreams(RuntimeMeshVertexStructure& VertexStructure)
+	{
+		for (int32 StreamIndex = 0; StreamIndex < RuntimeMeshNumVertexStreams; StreamIndex++)
+		{
+			const ERuntimeMeshVertexStream Stream = (ERuntimeMeshVertexStream)(1 << StreamIndex);
+			if (!(SeparateStreams & Stream))
+			{
+				continue;
+			}
+
+			TArray<FVertexStreamComponent*> Components;
+			switch (Stream)
+			{
+			case ERuntimeMeshVertexStream::Position:
+				// Dual buffer sections already have positions in their own buffer
+				if (!NeedsPositionOnlyBuffer)
+				{
+					Components.Add(&VertexStructure.PositionComponent);
+				}
+				break;
+			case ERuntimeMeshVertexStream::Tangents:
+				Components.Add(&VertexStructure.TangentBasisComponents[0]);
+				Components.Add(&VertexStructure.TangentBasisComponents[1]);
+				break;
+			case ERuntimeMeshVertexStream::Color:
+				Components.Add(&VertexStructure.ColorComponent);
+				break;
+			case ERuntimeMeshVertexStream::UVs:
+				for (FVertexStreamComponent& TextureCoordinate : VertexStructure.TextureCoordinates)
+				{
+					Components.Add(&TextureCoordinate);
+				}
+				break;
+			}
+
+			FRuntimeMeshVertexStreamBuffer* StreamBuffer = new FRuntimeMeshVertexStreamBuffer(UpdateFrequency);
+			StreamBuffer->SetComponents(Components);
+
+			// Nothing to separate, as the vertex type doesn't have this attribute
+			if (!StreamBuffer->HasComponents())
+			{
+				delete StreamBuffer;
+				continue;
+			}
+
+			StreamBuffers[StreamIndex] = StreamBuffer;
+		}
+	}
+
+	/* Writes the supplied streams from the interleaved vertices */
+	void SetVertexStreamData(const TArray<VertexType>& Vertices, ERuntimeMeshVertexStream Streams)
+	{
+		for (int32 StreamIndex = 0; StreamIndex < RuntimeMeshNumVertexStreams; StreamIndex++)
+		{
+			FRuntimeMeshVertexStreamBuffer* StreamBuffer = StreamBuffers[StreamIndex];
+			if (StreamBuffer && !!(Streams & (ERuntimeMeshVertexStream)(1 << StreamIndex)))
+			{
+				StreamBuffer->SetNum(Vertices.Num());
+				StreamBuffer->SetData((const uint8*)Vertices.GetData(), Vertices.Num(), sizeof(VertexType));
+			}
 		}
 	}
 
+	/* Applies an update to a section living in the shared buffer pool */
+	void FinishPooledUpdate(FRuntimeMeshSectionUpdateData<VertexType>* SectionUpdateData)
+	{
+		FRuntimeMeshBufferPool& Pool = FRuntimeMeshBufferPool::Get();
+
+		auto& VertexBufferData = SectionUpdateData->GetVertexBuffer();
+		auto& IndexBufferData = SectionUpdateData->IndexBuffer;
+		bool bFullVertices = SectionUpdateData->bIncludeVertexBuffer && SectionUpdateData->VertexSpans.Num() == 0;
+		bool bFullIndices = SectionUpdateData->bIncludeIndices && SectionUpdateData->IndexSpans.Num() == 0;
+
+		// Resize to fit the new data. The GT always sends whole vertex and index buffers 
+		// together, so anything that has to move here gets fully rewritten below
+		if (bFullVertices || bFullIndices)
+		{
+			check(bFullVertices && bFullIndices);
+			if (Pool.Resize(PoolAllocation, VertexBufferData.Num(), IndexBufferData.Num()))
+			{
+				// Moved to a new page, so the vertex factories need to point at its buffer
+				CurrentVertexStructure = VertexType::GetVertexStructure(PoolAllocation->Page->GetVertexBuffer());
+				VertexFactory.Init(CurrentVertexStructure);
+				if (InstancedVertexFactory.IsInitialized())
+				{
+					InstancedVertexFactory.Init(CurrentVertexStructure, InstanceBuffer);
+				}
+			}
+		}
+
+		if (SectionUpdateData->bIncludeVertexBuffer)
+		{
+			if (bFullVertices)
+			{
+				Pool.WriteVertices(PoolAllocation, VertexBufferData.GetData(), 0, VertexBufferData.Num());
+			}
+			else
+			{
+				// Only the changed ranges were sent
+				int32 DataOffset = 0;
+				for (const FRuntimeMeshBufferSpan& Span : SectionUpdateData->VertexSpans)
+				{
+					Pool.WriteVertices(PoolAllocation, VertexBufferData.GetData() + DataOffset, Span.Start, Span.Count);
+					DataOffset += Span.Count;
+				}
+			}
+		}
+
+		if (SectionUpdateData->bIncludeIndices)
+		{
+			if (bFullIndices)
+			{
+				Pool.WriteIndices(PoolAllocation, IndexBufferData, 0, 0, IndexBufferData.Num());
+				bIsUsingAdjacency = SectionUpdateData->bIsAdjacencyIndexBuffer;
+			}
+			else
+			{
+				// Only the changed ranges were sent
+				int32 DataOffset = 0;
+				for (const FRuntimeMeshBufferSpan& Span : SectionUpdateData->IndexSpans)
+				{
+					Pool.WriteIndices(PoolAllocation, IndexBufferData, DataOffset, Span.Start, Span.Count);
+					DataOffset += Span.Count;
+				}
+			}
+		}
+
+		Pool.Flush();
+	}
+
 	virtual void FinishPositionUpdate_RenderThread(FRuntimeMeshRenderThreadCommandInterface* UpdateData) override 
 	{
 		check(IsInRenderingThread());
@@ -210,19 +744,106 @@ public:
 		// Get the Position Only update data
 		auto* SectionUpdateData = UpdateData->As<FRuntimeMeshSectionPositionOnlyUpdateData<VertexType>>();
 		check(SectionUpdateData);
+
+		InvalidateCachedMeshBatch();
 		
+		SetLocalBoundingBox(SectionUpdateData->LocalBoundingBox);
+
 		// Copy the new data to the gpu
 		PositionVertexBuffer->SetData(SectionUpdateData->PositionVertexBuffer);
 	}
 
+	virtual void FinishInstanceUpdate_RenderThread(FRuntimeMeshRenderThreadCommandInterface* UpdateData) override
+	{
+		check(IsInRenderingThread());
+
+		auto* SectionUpdateData = UpdateData->As<FRuntimeMeshSectionInstanceUpdateData>();
+		check(SectionUpdateData);
+
+		InvalidateCachedMeshBatch();
+
+		SetInstances(SectionUpdateData->bIsInstanced, SectionUpdateData->InstanceTransforms);
+		UpdateInstanceBuffer();
+	}
+
+	/* Uploads the instance transforms, setting up the instanced vertex factory the first time there are any */
+	void UpdateInstanceBuffer()
+	{
+		if (!bIsInstanced || InstanceTransforms.Num() == 0)
+		{
+			return;
+		}
+
+		InstanceBuffer.SetNum(InstanceTransforms.Num());
+		InstanceBuffer.SetData(InstanceTransforms);
+
+		// The streams point at the buffer rather than its RHI resource, so reallocating it doesn't need the factory set up again
+		if (!InstancedVertexFactory.IsInitialized())
+		{
+			InstancedVertexFactory.Init(CurrentVertexStructure, InstanceBuffer);
+			InstancedVertexFactory.InitResource();
+		}
+	}
+
 	virtual void FinishPropertyUpdate_RenderThread(FRuntimeMeshRenderThreadCommandInterface* UpdateData) override
 	{
 		auto* SectionUpdateData = UpdateData->As<FRuntimeMeshSectionPropertyUpdateData>();
 		check(SectionUpdateData);
 
+		InvalidateCachedMeshBatch();
+
 		// Copy visibility/shadow
 		bIsVisible = SectionUpdateData->bIsVisible;
 		bCastsShadow = SectionUpdateData->bCastsShadow;
+		MaxDrawDistance = SectionUpdateData->MaxDrawDistance;
+		LODIndex = SectionUpdateData->LODIndex;
+	}
+
+
+	virtual int32 GetVolatileVertexStride() const override { return sizeof(VertexType); }
+
+	virtual int32 GetVolatileNumVertices() const override { return VolatileVertices.IsValid() ? VolatileVertices->Num() : 0; }
+
+	virtual int32 GetVolatileNumIndices() const override { return VolatileIndices.Num(); }
+
+	virtual uint32 GetVolatileDataVersion() const override { return VolatileDataVersion; }
+
+	virtual void WriteVolatileData(uint8* VertexData, uint32* IndexData, uint32 BaseVertexIndex) override
+	{
+		FMemory::Memcpy(VertexData, VolatileVertices->GetData(), VolatileVertices->Num() * sizeof(VertexType));
+
+		// Offset the indices to where our vertices landed in the shared buffer
+		int32 NumIndices = VolatileIndices.Num();
+		if (VolatileIndices.b32BitIndices)
+		{
+			const int32* Indices = VolatileIndices.Indices32.GetData();
+			for (int32 Index = 0; Index < NumIndices; Index++)
+			{
+				IndexData[Index] = BaseVertexIndex + Indices[Index];
+			}
+		}
+		else
+		{
+			const uint16* Indices = VolatileIndices.Indices16.GetData();
+			for (int32 Index = 0; Index < NumIndices; Index++)
+			{
+				IndexData[Index] = BaseVertexIndex + Indices[Index];
+			}
+		}
+
+	}
+
+	virtual void SetVolatileRange(uint32 BaseVertexIndex, uint32 FirstIndex, uint32 FrameNumber) override
+	{
+		// The mesh batch is bound to the shared buffers, so it only changes when our place in them does
+		if (VolatileBaseVertexIndex != BaseVertexIndex || VolatileFirstIndex != FirstIndex)
+		{
+			InvalidateCachedMeshBatch();
+		}
+
+		VolatileBaseVertexIndex = BaseVertexIndex;
+		VolatileFirstIndex = FirstIndex;
+		VolatileFrameNumber = FrameNumber;
 	}
 
 };
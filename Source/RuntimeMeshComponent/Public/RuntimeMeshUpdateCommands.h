@@ -6,6 +6,7 @@
 #include "Components/MeshComponent.h"
 #include "RuntimeMeshProfiling.h"
 #include "RuntimeMeshVersion.h"
+#include "RuntimeMeshCore.h"
 
 
 
@@ -20,6 +21,9 @@ public:
 	
 	virtual void SetTargetSection(int32 InTargetSection) { TargetSection = InTargetSection; }
 	virtual int32 GetTargetSection() { return TargetSection; }
+
+	/* Frees this command once the RT has applied it. Pooled commands return themselves to their pool */
+	virtual void Release() { delete this; }
 	
 	/* Cast the update data to the specific type of update data */
 	template <typename Type>
@@ -33,6 +37,89 @@ private:
 	int32 TargetSection;
 };
 
+
+/*
+ *	Recycles RT commands of a single type, along with the storage of the arrays inside them, so 
+ *	frequent updates don't go through the allocator on both threads. Commands are taken from the 
+ *	pool on the GT and given back by the RT through Release() once applied.
+ */
+template<typename CommandType>
+class TRuntimeMeshCommandPool
+{
+public:
+	/* Most free commands kept per type */
+	static const int32 MaxFreeCommands = 4096;
+
+	/* Most array storage kept across all free commands of a type, in bytes */
+	static const SIZE_T MaxRetainedPayloadBytes = 32 * 1024 * 1024;
+
+	/* Gets a command from the pool, or a new one if the pool is empty */
+	static CommandType* Allocate()
+	{
+		TRuntimeMeshCommandPool& Pool = Get();
+		CommandType* Command = nullptr;
+		{
+			FScopeLock Lock(&Pool.CriticalSection);
+			if (Pool.FreeCommands.Num() > 0)
+			{
+				Command = Pool.FreeCommands.Pop(false);
+				Pool.RetainedPayloadBytes -= Command->GetAllocatedSize();
+			}
+		}
+
+		if (Command)
+		{
+			INC_DWORD_STAT(STAT_RuntimeMesh_CommandPoolHits);
+			return Command;
+		}
+
+		INC_DWORD_STAT(STAT_RuntimeMesh_CommandPoolMisses);
+		return new CommandType();
+	}
+
+	/* Gives a command back to the pool. Its arrays are emptied but keep their storage */
+	static void Release(CommandType* Command)
+	{
+		TRuntimeMeshCommandPool& Pool = Get();
+
+		Command->ResetForReuse();
+		SIZE_T PayloadBytes = Command->GetAllocatedSize();
+		{
+			FScopeLock Lock(&Pool.CriticalSection);
+			if (Pool.FreeCommands.Num() < MaxFreeCommands && Pool.RetainedPayloadBytes + PayloadBytes <= MaxRetainedPayloadBytes)
+			{
+				Pool.FreeCommands.Push(Command);
+				Pool.RetainedPayloadBytes += PayloadBytes;
+				return;
+			}
+		}
+
+		// The pool is full so just free it
+		delete Command;
+	}
+
+private:
+	TRuntimeMeshCommandPool() : RetainedPayloadBytes(0) { }
+
+	~TRuntimeMeshCommandPool()
+	{
+		for (CommandType* Command : FreeCommands)
+		{
+			delete Command;
+		}
+	}
+
+	static TRuntimeMeshCommandPool& Get()
+	{
+		static TRuntimeMeshCommandPool Pool;
+		return Pool;
+	}
+
+	FCriticalSection CriticalSection;
+	TArray<CommandType*> FreeCommands;
+	SIZE_T RetainedPayloadBytes;
+};
+
 /* Base class for section creation data. Allows the non templated SceneProxy to get the section proxy;*/
 class FRuntimeMeshSectionCreateDataInterface : public FRuntimeMeshRenderThreadCommandInterface
 {
@@ -40,8 +127,26 @@ public:
 	/* The new proxy to be used for section creation */
 	class FRuntimeMeshSectionProxyInterface* NewProxy;
 
+	/* Should the section be placed in the shared buffer pool instead of getting its own buffers */
+	bool bUseSharedBufferPool;
+
+	/* Local bounds of the section, for culling it on its own */
+	FBox LocalBoundingBox;
+
+	/* Distance past which the section isn't drawn. 0 for no limit */
+	float MaxDrawDistance;
+
+	/* LOD the section is drawn at. INDEX_NONE for every LOD */
+	int32 LODIndex;
+
+	/* Is the section drawn once per instance instead of once at the component */
+	bool bIsInstanced;
+
+	/* Transforms of the instances, relative to the component */
+	TArray<FMatrix> InstanceTransforms;
 
-	FRuntimeMeshSectionCreateDataInterface() { }
+
+	FRuntimeMeshSectionCreateDataInterface() : bUseSharedBufferPool(false), LocalBoundingBox(0), MaxDrawDistance(0.0f), LODIndex(INDEX_NONE), bIsInstanced(false) { }
 	virtual ~FRuntimeMeshSectionCreateDataInterface() override { }
 
 };
@@ -57,16 +162,32 @@ public:
 	/* Updated vertex buffer for the section */
 	TArray<VertexType> VertexBuffer;
 
+	/* Vertex buffer shared with the GT section instead of copied. Takes the place of VertexBuffer when set */
+	TSharedPtr<const TArray<VertexType>, ESPMode::ThreadSafe> SharedVertexBuffer;
+
 	/* Whether the supplied index buffer contains adjacency info */
 	bool bIsAdjacencyIndexBuffer;
 
-	/* Updated index buffer for the section */
-	TArray<int32> IndexBuffer;
+	/* Updated index buffer for the section, packed to 16 bit when possible */
+	FRuntimeMeshIndexData IndexBuffer;
 
 
 	FRuntimeMeshSectionCreateData() {}
 	virtual ~FRuntimeMeshSectionCreateData() override { }
 
+	/* Gets the vertices to apply, wherever they're stored */
+	const TArray<VertexType>& GetVertexBuffer() const { return SharedVertexBuffer.IsValid() ? *SharedVertexBuffer : VertexBuffer; }
+
+	/* Takes a reference to the vertices for keeping past this command, without copying them */
+	TSharedPtr<const TArray<VertexType>, ESPMode::ThreadSafe> TakeVertexBuffer()
+	{
+		if (!SharedVertexBuffer.IsValid())
+		{
+			SharedVertexBuffer = MakeShareable(new TArray<VertexType>(MoveTemp(VertexBuffer)));
+		}
+		return SharedVertexBuffer;
+	}
+
 };
 
 /** Templated class for update data sent to the RT for updating a single mesh section */
@@ -80,8 +201,17 @@ public:
 	/* Updated vertex buffer for the section */
 	TArray<VertexType> VertexBuffer;
 
-	/* Updated index buffer for the section */
-	TArray<int32> IndexBuffer;
+	/* Whole vertex buffer shared with the GT section instead of copied. Takes the place of VertexBuffer when set */
+	TSharedPtr<const TArray<VertexType>, ESPMode::ThreadSafe> SharedVertexBuffer;
+
+	/* Updated index buffer for the section, packed to 16 bit when possible */
+	FRuntimeMeshIndexData IndexBuffer;
+
+	/* Ranges of the vertex buffer to write. If empty VertexBuffer replaces the whole buffer, otherwise it holds the vertices of each range back to back */
+	TArray<FRuntimeMeshBufferSpan> VertexSpans;
+
+	/* Ranges of the index buffer to write. If empty IndexBuffer replaces the whole buffer, otherwise it holds the indices of each range back to back */
+	TArray<FRuntimeMeshBufferSpan> IndexSpans;
 
 	/* Should we apply the position buffer */
 	bool bIncludePositionBuffer;
@@ -95,8 +225,56 @@ public:
 	/* Whether the supplied index buffer contains adjacency info */
 	bool bIsAdjacencyIndexBuffer;
 
-	FRuntimeMeshSectionUpdateData() {}
+	/* Capacity to reserve in the vertex buffer before a whole buffer write, so later appends can be sent as ranges. 0 for none */
+	int32 VertexCapacity;
+
+	/* Capacity to reserve in the index buffer before a whole buffer write, so later appends can be sent as ranges. 0 for none */
+	int32 IndexCapacity;
+
+	/* Separate vertex streams to rewrite from the vertices without touching the vertex buffer. Ignored when bIncludeVertexBuffer is set, as that rewrites every stream */
+	ERuntimeMeshVertexStream UpdatedStreams;
+
+	/* Local bounds of the section after this update */
+	FBox LocalBoundingBox;
+
+	FRuntimeMeshSectionUpdateData() : VertexCapacity(0), IndexCapacity(0), UpdatedStreams(ERuntimeMeshVertexStream::None) {}
 	virtual ~FRuntimeMeshSectionUpdateData() override { }
+
+	virtual void Release() override { TRuntimeMeshCommandPool<FRuntimeMeshSectionUpdateData>::Release(this); }
+
+	/* Clears the command for reuse, keeping the storage of its arrays */
+	void ResetForReuse()
+	{
+		PositionVertexBuffer.Reset();
+		VertexBuffer.Reset();
+		SharedVertexBuffer.Reset();
+		IndexBuffer.Reset(false);
+		VertexSpans.Reset();
+		IndexSpans.Reset();
+		VertexCapacity = 0;
+		IndexCapacity = 0;
+		UpdatedStreams = ERuntimeMeshVertexStream::None;
+	}
+
+	/* Gets the memory held by the arrays of this command */
+	SIZE_T GetAllocatedSize() const
+	{
+		return PositionVertexBuffer.GetAllocatedSize() + VertexBuffer.GetAllocatedSize() + IndexBuffer.GetAllocatedSize() +
+			VertexSpans.GetAllocatedSize() + IndexSpans.GetAllocatedSize();
+	}
+
+	/* Gets the vertices to apply, wherever they're stored */
+	const TArray<VertexType>& GetVertexBuffer() const { return SharedVertexBuffer.IsValid() ? *SharedVertexBuffer : VertexBuffer; }
+
+	/* Takes a reference to the vertices for keeping past this command, without copying them */
+	TSharedPtr<const TArray<VertexType>, ESPMode::ThreadSafe> TakeVertexBuffer()
+	{
+		if (!SharedVertexBuffer.IsValid())
+		{
+			SharedVertexBuffer = MakeShareable(new TArray<VertexType>(MoveTemp(VertexBuffer)));
+		}
+		return SharedVertexBuffer;
+	}
 };
 
 /** Templated class for update data sent to the RT for updating a single mesh section */
@@ -107,8 +285,19 @@ public:
 	/* Updated position vertex buffer for the section */
 	TArray<FVector> PositionVertexBuffer;
 
+	/* Local bounds of the section after this update */
+	FBox LocalBoundingBox;
+
 	FRuntimeMeshSectionPositionOnlyUpdateData() {}
 	virtual ~FRuntimeMeshSectionPositionOnlyUpdateData() override { }
+
+	virtual void Release() override { TRuntimeMeshCommandPool<FRuntimeMeshSectionPositionOnlyUpdateData>::Release(this); }
+
+	/* Clears the command for reuse, keeping the storage of its arrays */
+	void ResetForReuse() { PositionVertexBuffer.Reset(); }
+
+	/* Gets the memory held by the arrays of this command */
+	SIZE_T GetAllocatedSize() const { return PositionVertexBuffer.GetAllocatedSize(); }
 };
 
 /** Property update for a single section */
@@ -121,8 +310,42 @@ public:
 	/* Is this section casting shadows */
 	bool bCastsShadow;
 
+	/* Distance past which the section isn't drawn. 0 for no limit */
+	float MaxDrawDistance;
+
+	/* LOD the section is drawn at. INDEX_NONE for every LOD */
+	int32 LODIndex;
+
 	FRuntimeMeshSectionPropertyUpdateData() {}
 	virtual ~FRuntimeMeshSectionPropertyUpdateData() override { }
+
+	virtual void Release() override { TRuntimeMeshCommandPool<FRuntimeMeshSectionPropertyUpdateData>::Release(this); }
+
+	void ResetForReuse() { }
+
+	SIZE_T GetAllocatedSize() const { return 0; }
+};
+
+/** Instance update for a single section */
+class FRuntimeMeshSectionInstanceUpdateData : public FRuntimeMeshRenderThreadCommandInterface
+{
+public:
+	/* Is the section drawn once per instance instead of once at the component */
+	bool bIsInstanced;
+
+	/* Transforms of all the instances, relative to the component */
+	TArray<FMatrix> InstanceTransforms;
+
+	FRuntimeMeshSectionInstanceUpdateData() : bIsInstanced(false) {}
+	virtual ~FRuntimeMeshSectionInstanceUpdateData() override { }
+
+	virtual void Release() override { TRuntimeMeshCommandPool<FRuntimeMeshSectionInstanceUpdateData>::Release(this); }
+
+	/* Clears the command for reuse, keeping the storage of its arrays */
+	void ResetForReuse() { InstanceTransforms.Reset(); }
+
+	/* Gets the memory held by the arrays of this command */
+	SIZE_T GetAllocatedSize() const { return InstanceTransforms.GetAllocatedSize(); }
 };
 
 enum class ERuntimeMeshSectionBatchUpdateType
@@ -134,6 +357,8 @@ enum class ERuntimeMeshSectionBatchUpdateType
 	VerticesUpdate = 0x8,
 	IndicesUpdate = 0x10,
 	PropertyUpdate = 0x20,
+	StreamsUpdate = 0x40,
+	InstancesUpdate = 0x80,
 };
 
 ENUM_CLASS_FLAGS(ERuntimeMeshSectionBatchUpdateType)
@@ -146,17 +371,23 @@ struct FRuntimeMeshBatchUpdateData
 	TArray<int32> DestroySections;
 	TArray<FRuntimeMeshRenderThreadCommandInterface*> UpdateSections;
 	TArray<FRuntimeMeshSectionPropertyUpdateData*> PropertyUpdateSections;
+	TArray<FRuntimeMeshSectionInstanceUpdateData*> InstanceUpdateSections;
 };
 
 
 
 struct FRuntimeMeshBatchUpdateState
 {
-	void StartBatch() { bIsPending = true; }
+	void StartBatch(bool bIsAutomatic = false) 
+	{ 
+		bIsPending = true; 
+		bIsAutomaticBatch = bIsAutomatic;
+	}
 
 	void ResetBatch() 
 	{
 		bIsPending = false;
+		bIsAutomaticBatch = false;
 		bRequiresSceneProxyReCreate = false;
 		bRequiresBoundsUpdate = false;
 		bRequiresCollisionUpdate = false;
@@ -169,6 +400,9 @@ struct FRuntimeMeshBatchUpdateState
 
 	bool IsBatchPending() { return bIsPending; }
 
+	/* Was the pending batch started automatically, rather than by BeginBatchUpdates() */
+	bool IsAutomaticBatchPending() { return bIsPending && bIsAutomaticBatch; }
+
 	void MarkSectionCreated(int32 SectionIndex, bool bPromoteToProxyRecreate)
 	{
 		// Flag recreate instead of individual section
@@ -246,6 +480,7 @@ private:
 
 
 	bool bIsPending;
+	bool bIsAutomaticBatch;
 	bool bRequiresSceneProxyReCreate;
 	bool bRequiresBoundsUpdate;
 	bool bRequiresCollisionUpdate;
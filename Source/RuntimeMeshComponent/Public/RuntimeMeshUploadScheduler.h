@@ -0,0 +1,127 @@
+// Copyright 2016 Chris Conway (Koderz). All Rights Reserved.
+
+#pragma once
+
+#include "Engine.h"
+#include "Tickable.h"
+#include "RuntimeMeshUpdateCommands.h"
+
+class URuntimeMeshComponent;
+
+
+/* A section upload waiting to be sent to the RT */
+struct FRuntimeMeshPendingUpload
+{
+	/* Component owning the section */
+	TWeakObjectPtr<URuntimeMeshComponent> Component;
+
+	/* Section to upload */
+	int32 SectionIndex;
+
+	/* What needs to be sent. Only Create, PositionsUpdate, VerticesUpdate, IndicesUpdate and StreamsUpdate are used */
+	ERuntimeMeshSectionBatchUpdateType Updates;
+
+	/* Scene proxy the upload was queued for. A recreated proxy is built with the latest data, so the upload is dropped */
+	const FPrimitiveSceneProxy* SceneProxy;
+
+	/* Sort keys, filled in when the queue is drained */
+	int32 Priority;
+	bool bIsVisible;
+	float DistanceSquared;
+	int32 UploadSize;
+
+	FRuntimeMeshPendingUpload()
+		: SectionIndex(INDEX_NONE)
+		, Updates(ERuntimeMeshSectionBatchUpdateType::None)
+		, SceneProxy(nullptr)
+		, Priority(0)
+		, bIsVisible(false)
+		, DistanceSquared(0.0f)
+		, UploadSize(0)
+	{ }
+};
+
+
+/*
+ *	Global queue of section uploads for all components using the upload scheduler. Rather than each component
+ *	sending its sections to the RT as they change, uploads are queued and drained once a frame in priority order
+ *	(explicit component priority, then recently rendered visible sections, then distance to the nearest viewer)
+ *	until the frame's byte or time budget runs out. At least one upload is always sent per frame so large
+ *	sections still make progress. The upload data is gathered from the section when it's sent, so a section
+ *	changed several times while waiting is only sent once, with its latest data. GT only.
+ */
+class RUNTIMEMESHCOMPONENT_API FRuntimeMeshUploadScheduler : public FTickableGameObject
+{
+public:
+	/* Default number of bytes sent to the RT per frame */
+	static const int32 DefaultBytesPerFrame = 4 * 1024 * 1024;
+
+	/* Default game thread time spent sending uploads per frame */
+	static constexpr float DefaultMillisecondsPerFrame = 2.0f;
+
+	/* How long after last being rendered a component still counts as visible */
+	static constexpr float RecentlyRenderedTime = 0.2f;
+
+	/* Gets the scheduler shared by all components */
+	static FRuntimeMeshUploadScheduler& Get();
+
+	FRuntimeMeshUploadScheduler();
+
+	/* Sets the per frame budget. A budget of 0 is unlimited */
+	void SetFrameBudget(int32 InBytesPerFrame, float InMillisecondsPerFrame);
+
+	int32 GetBytesPerFrame() const { return BytesPerFrame; }
+	float GetMillisecondsPerFrame() const { return MillisecondsPerFrame; }
+
+	/* Queues an upload of a section, merging it with any upload already waiting for that section */
+	void Schedule(URuntimeMeshComponent* Component, int32 SectionIndex, ERuntimeMeshSectionBatchUpdateType Updates);
+
+	/* Removes a waiting upload of a section, if there is one */
+	void Unschedule(URuntimeMeshComponent* Component, int32 SectionIndex);
+
+	/* Is an upload waiting for a section */
+	bool IsScheduled(URuntimeMeshComponent* Component, int32 SectionIndex) const;
+
+	/* Gets the number of uploads waiting */
+	int32 GetNumPending() const { return PendingUploads.Num(); }
+
+	/* Sends as many waiting uploads as the frame budget allows */
+	void Drain();
+
+	//~ Begin FTickableGameObject Interface.
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return PendingUploads.Num() > 0; }
+	virtual bool IsTickableWhenPaused() const override { return true; }
+	virtual bool IsTickableInEditor() const override { return true; }
+	virtual TStatId GetStatId() const override;
+	//~ End FTickableGameObject Interface.
+
+private:
+	/* Key of a waiting upload */
+	struct FUploadKey
+	{
+		TWeakObjectPtr<URuntimeMeshComponent> Component;
+		int32 SectionIndex;
+
+		FUploadKey(URuntimeMeshComponent* InComponent, int32 InSectionIndex) : Component(InComponent), SectionIndex(InSectionIndex) { }
+
+		bool operator==(const FUploadKey& Other) const { return Component == Other.Component && SectionIndex == Other.SectionIndex; }
+
+		friend uint32 GetTypeHash(const FUploadKey& Key) { return HashCombine(GetTypeHash(Key.Component), GetTypeHash(Key.SectionIndex)); }
+	};
+
+	/* Fills in the sort keys of an upload. Returns false if the upload is no longer needed */
+	static bool PrepareUpload(FRuntimeMeshPendingUpload& Upload);
+
+	/* Uploads waiting to be sent, one per section */
+	TMap<FUploadKey, FRuntimeMeshPendingUpload> PendingUploads;
+
+	/* Bytes sent to the RT per frame. 0 is unlimited */
+	int32 BytesPerFrame;
+
+	/* Game thread time spent sending uploads per frame. 0 is unlimited */
+	float MillisecondsPerFrame;
+
+	/* Frame the queue was last drained. The scheduler ticks with every world, but only drains once a frame */
+	uint64 LastDrainFrame;
+};
@@ -14,6 +14,9 @@ namespace FRuntimeMeshVersion
 		TemplatedVertexFix = 1,
 		SerializationOptional = 2,
 		DualVertexBuffer = 3,
+		SeparateVertexStreams = 4,
+		SectionInstances = 5,
+		SectionDrawSettings = 6,
 
 
 		// -----<new versions can be added above this line>-------------------------------------------------